@@ -48,6 +48,8 @@
 #include "okapi/api/chassis/model/xDriveModel.hpp"
 #include "okapi/impl/chassis/controller/chassisControllerBuilder.hpp"
 
+#include "okapi/api/control/async/asyncAnglePidController.hpp"
+#include "okapi/api/control/async/asyncEventWrapper.hpp"
 #include "okapi/api/control/async/asyncLinearMotionProfileController.hpp"
 #include "okapi/api/control/async/asyncMotionProfileController.hpp"
 #include "okapi/api/control/async/asyncPosIntegratedController.hpp"
@@ -55,15 +57,23 @@
 #include "okapi/api/control/async/asyncVelIntegratedController.hpp"
 #include "okapi/api/control/async/asyncVelPidController.hpp"
 #include "okapi/api/control/async/asyncWrapper.hpp"
+#include "okapi/api/control/async/executorStepped.hpp"
 #include "okapi/api/control/controllerInput.hpp"
 #include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/control/iterative/gainScheduledPidController.hpp"
+#include "okapi/api/control/iterative/iterativeAnglePidController.hpp"
 #include "okapi/api/control/iterative/iterativeMotorVelocityController.hpp"
 #include "okapi/api/control/iterative/iterativePosPidController.hpp"
 #include "okapi/api/control/iterative/iterativeVelPidController.hpp"
+#include "okapi/api/control/util/batchDrivetrainSimulator.hpp"
+#include "okapi/api/control/util/controlExecutor.hpp"
 #include "okapi/api/control/util/controllerRunner.hpp"
 #include "okapi/api/control/util/flywheelSimulator.hpp"
 #include "okapi/api/control/util/pidTuner.hpp"
+#include "okapi/api/control/util/poseSettledUtil.hpp"
+#include "okapi/api/control/util/relayAutotuner.hpp"
 #include "okapi/api/control/util/settledUtil.hpp"
+#include "okapi/api/control/util/simulatedPidTuner.hpp"
 #include "okapi/impl/control/async/asyncMotionProfileControllerBuilder.hpp"
 #include "okapi/impl/control/async/asyncPosControllerBuilder.hpp"
 #include "okapi/impl/control/async/asyncVelControllerBuilder.hpp"
@@ -71,9 +81,13 @@
 #include "okapi/impl/control/util/controllerRunnerFactory.hpp"
 #include "okapi/impl/control/util/pidTunerFactory.hpp"
 
+#include "okapi/api/odometry/headingFusion.hpp"
 #include "okapi/api/odometry/odomMath.hpp"
 #include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/odometry/publishedOdometry.hpp"
 #include "okapi/api/odometry/threeEncoderOdometry.hpp"
+#include "okapi/api/routine/action.hpp"
+#include "okapi/api/routine/routineScheduler.hpp"
 
 #include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
 #include "okapi/api/device/rotarysensor/rotarySensor.hpp"
@@ -82,6 +96,7 @@
 #include "okapi/impl/device/button/controllerButton.hpp"
 #include "okapi/impl/device/controller.hpp"
 #include "okapi/impl/device/distanceSensor.hpp"
+#include "okapi/impl/device/gpsImuHeading.hpp"
 #include "okapi/impl/device/motor/adiMotor.hpp"
 #include "okapi/impl/device/motor/motor.hpp"
 #include "okapi/impl/device/motor/motorGroup.hpp"
@@ -99,9 +114,12 @@
 #include "okapi/api/filter/ekfFilter.hpp"
 #include "okapi/api/filter/emaFilter.hpp"
 #include "okapi/api/filter/filter.hpp"
+#include "okapi/api/filter/filterBank.hpp"
 #include "okapi/api/filter/filteredControllerInput.hpp"
+#include "okapi/api/filter/leastSquaresVelMath.hpp"
 #include "okapi/api/filter/medianFilter.hpp"
 #include "okapi/api/filter/passthroughFilter.hpp"
+#include "okapi/api/filter/staticFilterChain.hpp"
 #include "okapi/api/filter/velMath.hpp"
 #include "okapi/impl/filter/velMathFactory.hpp"
 
@@ -124,9 +142,23 @@
 
 #include "okapi/api/util/abstractRate.hpp"
 #include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/asyncLogSink.hpp"
+#include "okapi/api/util/asyncLogger.hpp"
+#include "okapi/api/util/cobs.hpp"
+#include "okapi/api/util/instrumentedRate.hpp"
+#include "okapi/api/util/logFormat.hpp"
+#include "okapi/api/util/loopTiming.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/seqLock.hpp"
 #include "okapi/api/util/supplier.hpp"
+#include "okapi/api/util/telemetry.hpp"
+#include "okapi/api/util/telemetryOutput.hpp"
 #include "okapi/api/util/timeUtil.hpp"
+#include "okapi/api/util/tracer.hpp"
+#include "okapi/api/util/virtualClock.hpp"
+#include "okapi/impl/util/dashboard.hpp"
+#include "okapi/impl/util/microTimer.hpp"
 #include "okapi/impl/util/rate.hpp"
+#include "okapi/impl/util/serialTelemetryOutput.hpp"
 #include "okapi/impl/util/timeUtilFactory.hpp"
 #include "okapi/impl/util/timer.hpp"
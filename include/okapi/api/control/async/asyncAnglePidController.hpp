@@ -0,0 +1,87 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/async/asyncEventWrapper.hpp"
+#include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/control/iterative/iterativeAnglePidController.hpp"
+#include "okapi/api/control/offsettableControllerInput.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <memory>
+
+namespace okapi {
+class AsyncAnglePIDController : public AsyncEventWrapper<double, double>,
+                                public AsyncPositionController<double, double> {
+  public:
+  /**
+   * An async heading PID controller. See IterativeAnglePIDController.
+   *
+   * @param iinput The controller input, in degrees. Will be turned into an
+   * OffsettableControllerInput.
+   * @param ioutput The controller output.
+   * @param itimeUtil The TimeUtil.
+   * @param igains The controller gains.
+   * @param iderivativeFilter The derivative filter.
+   * @param ilogger The logger this instance will log to.
+   */
+  AsyncAnglePIDController(
+    const std::shared_ptr<ControllerInput<double>> &iinput,
+    const std::shared_ptr<ControllerOutput<double>> &ioutput,
+    const TimeUtil &itimeUtil,
+    const IterativePosPIDController::Gains &igains,
+    std::unique_ptr<Filter> iderivativeFilter = std::make_unique<PassthroughFilter>(),
+    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * An async heading PID controller. See IterativeAnglePIDController.
+   *
+   * @param iinput The controller input, in degrees.
+   * @param ioutput The controller output.
+   * @param itimeUtil The TimeUtil.
+   * @param igains The controller gains.
+   * @param iderivativeFilter The derivative filter.
+   * @param ilogger The logger this instance will log to.
+   */
+  AsyncAnglePIDController(
+    const std::shared_ptr<OffsetableControllerInput> &iinput,
+    const std::shared_ptr<ControllerOutput<double>> &ioutput,
+    const TimeUtil &itimeUtil,
+    const IterativePosPIDController::Gains &igains,
+    std::unique_ptr<Filter> iderivativeFilter = std::make_unique<PassthroughFilter>(),
+    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Sets the "absolute" zero heading of the controller to its current heading.
+   */
+  void tarePosition() override;
+
+  /**
+   * This implementation does not respect the maximum velocity.
+   *
+   * @param imaxVelocity Ignored.
+   */
+  void setMaxVelocity(std::int32_t imaxVelocity) override;
+
+  /**
+   * Set controller gains.
+   *
+   * @param igains The new gains.
+   */
+  void setGains(const IterativePosPIDController::Gains &igains);
+
+  /**
+   * Gets the current gains.
+   *
+   * @return The current gains.
+   */
+  IterativePosPIDController::Gains getGains() const;
+
+  protected:
+  std::shared_ptr<OffsetableControllerInput> offsettableInput;
+  std::shared_ptr<IterativeAnglePIDController> internalController;
+};
+} // namespace okapi
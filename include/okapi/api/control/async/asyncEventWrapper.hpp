@@ -0,0 +1,192 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/async/asyncWrapper.hpp"
+#include "okapi/api/control/util/controlExecutor.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/asyncLogger.hpp"
+#include "okapi/api/util/tracer.hpp"
+#include <atomic>
+#include <memory>
+
+namespace okapi {
+template <typename Input, typename Output>
+class AsyncEventWrapper : public AsyncWrapper<Input, Output> {
+  public:
+  /**
+   * An AsyncWrapper which runs the controller loop itself, so it can wake tasks blocked in
+   * waitUntilSettled() on the step where the controller settles instead of having them poll.
+   * Start it with this class' startThread() or startOn(). A controller started through
+   * AsyncWrapper's startThread() still works, but waitUntilSettled() polls like AsyncWrapper's.
+   *
+   * @param iinput controller input, passed to the IterativeController
+   * @param ioutput controller output, written to from the IterativeController
+   * @param icontroller the controller to use
+   * @param irateSupplier used for rates used in the main loop and in `waitUntilSettled`
+   * @param iratio Any external gear ratio.
+   * @param ilogger The logger this instance will log to.
+   */
+  AsyncEventWrapper(const std::shared_ptr<ControllerInput<Input>> &iinput,
+                    const std::shared_ptr<ControllerOutput<Output>> &ioutput,
+                    const std::shared_ptr<IterativeController<Input, Output>> &icontroller,
+                    const Supplier<std::unique_ptr<AbstractRate>> &irateSupplier,
+                    const double iratio = 1,
+                    std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger())
+    : AsyncWrapper<Input, Output>(
+        iinput, ioutput, icontroller, irateSupplier, iratio, std::move(ilogger)) {
+  }
+
+  ~AsyncEventWrapper() override {
+    // The step uses this class' members, so it has to stop before they are destroyed
+    this->dtorCalled.store(true, std::memory_order_release);
+    delete this->task;
+    this->task = nullptr;
+    if (executor) {
+      executor->remove(executorStepId);
+    }
+  }
+
+  /**
+   * Changes whether the controller is off or on. Turning the controller on after it was off will
+   * cause the controller to move to its last set target, unless it was reset in that time.
+   */
+  void flipDisable() override {
+    AsyncWrapper<Input, Output>::flipDisable();
+    settledEvent.notifyAll();
+  }
+
+  /**
+   * Sets whether the controller is off or on. Turning the controller on after it was off will
+   * cause the controller to move to its last set target, unless it was reset in that time.
+   *
+   * @param iisDisabled whether the controller is disabled
+   */
+  void flipDisable(const bool iisDisabled) override {
+    AsyncWrapper<Input, Output>::flipDisable(iisDisabled);
+    settledEvent.notifyAll();
+  }
+
+  /**
+   * Sets the target for the controller.
+   *
+   * @param itarget new target
+   */
+  void setTarget(const Input itarget) override {
+    // AsyncWrapper::setTarget() does the same, but is compiled into the OkapiLib archive with a log
+    // statement which builds a string
+    LOG_INFO_F("AsyncWrapper: Set target to %f", itarget);
+    this->hasFirstTarget = true;
+    this->controller->setTarget(itarget * this->ratio);
+    this->lastTarget = itarget;
+
+    // Whether it settled at the old target says nothing about the new one
+    settled.store(false, std::memory_order_release);
+  }
+
+  /**
+   * Returns whether the controller has settled at the target. Determining what settling means is
+   * implementation-dependent.
+   *
+   * If this class runs the controller, this is what the controller reported on its last step, so
+   * asking does not advance the controller's SettledUtil.
+   *
+   * @return whether the controller is settled
+   */
+  bool isSettled() override {
+    if (!running.load(std::memory_order_acquire)) {
+      return AsyncWrapper<Input, Output>::isSettled();
+    }
+    return this->isDisabled() || settled.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Blocks the current task until the controller has settled. Determining what settling means is
+   * implementation-dependent.
+   *
+   * If this class runs the controller, the waiting task sleeps until the controller signals that
+   * it settled or was disabled, instead of polling.
+   */
+  void waitUntilSettled() override {
+    if (!running.load(std::memory_order_acquire)) {
+      AsyncWrapper<Input, Output>::waitUntilSettled();
+      return;
+    }
+
+    LOG_INFO_S("AsyncEventWrapper: Waiting to settle");
+    settledEvent.wait([this] { return this->isSettled(); });
+    LOG_INFO_S("AsyncEventWrapper: Done waiting to settle");
+  }
+
+  /**
+   * Starts the internal thread, which runs the controller and signals waitUntilSettled().
+   */
+  void startThread() {
+    if (!this->task && !executor) {
+      this->task = new CrossplatformThread(trampoline, this, "AsyncWrapper");
+      running.store(true, std::memory_order_release);
+    }
+  }
+
+  /**
+   * Runs this controller as a step in the controllers stage of a ControlExecutor instead of in its
+   * own thread. Call this in place of startThread(). The step runs at the controller's sample time,
+   * rounded to a whole number of executor ticks. The executor must outlive this controller.
+   *
+   * @param iexecutor The executor to run on.
+   */
+  void startOn(ControlExecutor &iexecutor) {
+    if (!this->task && !executor) {
+      executor = &iexecutor;
+      executorStepId = iexecutor.add(
+        ControlExecutor::Stage::controllers, [this] { step(); }, this->controller->getSampleTime());
+      running.store(true, std::memory_order_release);
+    }
+  }
+
+  protected:
+  using AsyncWrapper<Input, Output>::logger;
+
+  CrossplatformEvent settledEvent;
+  std::atomic_bool running{false};
+  std::atomic_bool settled{false};
+  ControlExecutor *executor{nullptr};
+  std::size_t executorStepId{0};
+
+  static void trampoline(void *context) {
+    if (context) {
+      static_cast<AsyncEventWrapper *>(context)->loop();
+    }
+  }
+
+  void loop() {
+    auto rate = this->rateSupplier.get();
+    while (!this->dtorCalled.load(std::memory_order_acquire) && !this->task->notifyTake(0)) {
+      step();
+      rate->delayUntil(this->controller->getSampleTime());
+    }
+  }
+
+  /**
+   * Runs one iteration of the controller, writes its output, and wakes waitUntilSettled() on the
+   * step where the controller settles. The controller is asked whether it settled once per step,
+   * the same as the SettledUtil would be by a loop stepping the controller itself, and everyone
+   * else reads the answer from settled.
+   */
+  void step() {
+    TRACE_SPAN("PID step");
+    if (!this->isDisabled()) {
+      this->output->controllerSet(this->controller->step(this->input->controllerGet()));
+
+      const bool isNowSettled = this->controller->isSettled();
+      const bool wasSettled = settled.exchange(isNowSettled, std::memory_order_acq_rel);
+      if (isNowSettled && !wasSettled) {
+        settledEvent.notifyAll();
+      }
+    }
+  }
+};
+} // namespace okapi
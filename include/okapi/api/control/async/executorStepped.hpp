@@ -0,0 +1,78 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/async/asyncPosPidController.hpp"
+#include "okapi/api/control/async/asyncVelPidController.hpp"
+#include "okapi/api/control/util/controlExecutor.hpp"
+#include "okapi/api/util/tracer.hpp"
+
+namespace okapi {
+/**
+ * An AsyncWrapper-based controller, such as AsyncPosPIDController or AsyncVelPIDController, which
+ * can run as a step of a ControlExecutor instead of in its own thread. The stock controllers are
+ * compiled into the OkapiLib archive, so this adds startOn() by deriving from them rather than by
+ * changing them. It takes the same constructor arguments as Controller:
+ *
+ * ```cpp
+ * auto lift = std::make_shared<ExecutorPosPIDController>(
+ *   input, output, TimeUtilFactory::createDefault(), 0.001, 0, 0.0001);
+ * lift->startOn(*executor);
+ * ```
+ */
+template <typename Controller> class ExecutorStepped : public Controller {
+  public:
+  using Controller::Controller;
+
+  ~ExecutorStepped() override {
+    // The step uses the controller, so it has to stop before the controller is destroyed
+    if (executor) {
+      executor->remove(executorStepId);
+    }
+  }
+
+  /**
+   * Starts the internal thread, unless this controller already runs on an executor.
+   */
+  void startThread() {
+    if (!executor) {
+      Controller::startThread();
+    }
+  }
+
+  /**
+   * Runs this controller as a step in the controllers stage of a ControlExecutor instead of in its
+   * own thread. Call this in place of startThread(). The step runs at the controller's sample time,
+   * rounded to a whole number of executor ticks. The executor must outlive this controller.
+   *
+   * @param iexecutor The executor to run on.
+   */
+  void startOn(ControlExecutor &iexecutor) {
+    if (!this->task && !executor) {
+      executor = &iexecutor;
+      executorStepId = iexecutor.add(
+        ControlExecutor::Stage::controllers, [this] { step(); }, this->controller->getSampleTime());
+    }
+  }
+
+  protected:
+  ControlExecutor *executor{nullptr};
+  std::size_t executorStepId{0};
+
+  /**
+   * Runs one iteration of the controller and writes its output, as the internal thread would.
+   */
+  void step() {
+    TRACE_SPAN("PID step");
+    if (!this->isDisabled()) {
+      this->output->controllerSet(this->controller->step(this->input->controllerGet()));
+    }
+  }
+};
+
+using ExecutorPosPIDController = ExecutorStepped<AsyncPosPIDController>;
+using ExecutorVelPIDController = ExecutorStepped<AsyncVelPIDController>;
+} // namespace okapi
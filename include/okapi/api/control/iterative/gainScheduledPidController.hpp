@@ -0,0 +1,195 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace okapi {
+/**
+ * A table of gains over evenly spaced values of a schedule key, such as error magnitude, speed, or
+ * battery voltage. Because the points are evenly spaced, looking up gains is a clamp, one index
+ * computation and a linear interpolation, with no search. Keys outside the table use the nearest
+ * end.
+ *
+ * @tparam N The number of points in the table.
+ */
+template <std::size_t N> class GainSchedule {
+  static_assert(N >= 2, "A GainSchedule needs at least two points.");
+
+  public:
+  /**
+   * A table built at compile time.
+   *
+   * ```cpp
+   * constexpr GainSchedule<3> driveSchedule(0, 1.5, {{{-4.0, 0, -0.02}, {-2.0, 0, -0.01},
+   *                                                   {-1.5, 0, -0.01}}});
+   * ```
+   *
+   * Throws a `std::invalid_argument` if ikeyMax is not greater than ikeyMin, which is a compile
+   * error for a constexpr table.
+   *
+   * @param ikeyMin The key of the first point.
+   * @param ikeyMax The key of the last point.
+   * @param igains The gains at each point, from ikeyMin to ikeyMax.
+   */
+  constexpr GainSchedule(const double ikeyMin,
+                         const double ikeyMax,
+                         const std::array<IterativePosPIDController::Gains, N> &igains)
+    : keyMin(ikeyMin),
+      invStep(ikeyMax > ikeyMin
+                ? (N - 1) / (ikeyMax - ikeyMin)
+                : throw std::invalid_argument(
+                    "GainSchedule: The keys must be strictly increasing (keyMax > keyMin).")),
+      gains(igains) {
+  }
+
+  /**
+   * Loads a table from a CSV file (for example on the SD card under `/usd/`) with one
+   * `key,kP,kI,kD` row per line in increasing key order. The rows do not need to be evenly spaced;
+   * they are resampled onto N evenly spaced points between the first and last key. Throws a
+   * `std::runtime_error` if the file cannot be read, has fewer than two rows, or has keys which are
+   * not strictly increasing.
+   *
+   * @param ipath The path of the file.
+   * @return The loaded table.
+   */
+  static GainSchedule fromFile(const std::string &ipath) {
+    FILE *file = std::fopen(ipath.c_str(), "r");
+    if (!file) {
+      throw std::runtime_error("GainSchedule: Could not open " + ipath);
+    }
+
+    std::vector<double> keys;
+    std::vector<IterativePosPIDController::Gains> rows;
+    double key, kP, kI, kD;
+    while (std::fscanf(file, " %lf , %lf , %lf , %lf", &key, &kP, &kI, &kD) == 4) {
+      keys.push_back(key);
+      rows.push_back({kP, kI, kD, 0});
+    }
+    std::fclose(file);
+
+    if (keys.size() < 2) {
+      throw std::runtime_error("GainSchedule: " + ipath + " needs at least two rows");
+    }
+
+    // A repeated or decreasing key would make the resampling below divide by zero or interpolate
+    // between the wrong rows
+    for (std::size_t i = 1; i < keys.size(); i++) {
+      if (!(keys[i] > keys[i - 1])) {
+        throw std::runtime_error("GainSchedule: The keys in " + ipath +
+                                 " must be strictly increasing (row " + std::to_string(i + 1) +
+                                 ")");
+      }
+    }
+
+    std::array<IterativePosPIDController::Gains, N> resampled{};
+    for (std::size_t i = 0; i < N; i++) {
+      const double target = keys.front() + (keys.back() - keys.front()) * i / (N - 1);
+      const std::size_t upper =
+        std::clamp<std::size_t>(std::upper_bound(keys.begin(), keys.end(), target) - keys.begin(),
+                                1,
+                                keys.size() - 1);
+      const double t = (target - keys[upper - 1]) / (keys[upper] - keys[upper - 1]);
+      resampled[i] = lerp(rows[upper - 1], rows[upper], t);
+    }
+
+    return GainSchedule(keys.front(), keys.back(), resampled);
+  }
+
+  /**
+   * Interpolates the gains at a key.
+   *
+   * @param ikey The schedule key.
+   * @return The interpolated gains.
+   */
+  IterativePosPIDController::Gains get(const double ikey) const {
+    const double pos = std::fmin(std::fmax((ikey - keyMin) * invStep, 0.0), N - 1.0);
+    const std::size_t index = std::min(static_cast<std::size_t>(pos), N - 2);
+    return lerp(gains[index], gains[index + 1], pos - index);
+  }
+
+  protected:
+  double keyMin;
+  double invStep;
+  std::array<IterativePosPIDController::Gains, N> gains;
+
+  static IterativePosPIDController::Gains lerp(const IterativePosPIDController::Gains &ia,
+                                               const IterativePosPIDController::Gains &ib,
+                                               const double it) {
+    return {ia.kP + (ib.kP - ia.kP) * it,
+            ia.kI + (ib.kI - ia.kI) * it,
+            ia.kD + (ib.kD - ia.kD) * it,
+            ia.kBias + (ib.kBias - ia.kBias) * it};
+  }
+};
+
+/**
+ * A position PID controller whose gains are looked up in a GainSchedule before every step.
+ *
+ * @tparam N The number of points in the schedule.
+ */
+template <std::size_t N> class GainScheduledPIDController : public IterativePosPIDController {
+  public:
+  /**
+   * Position PID controller with scheduled gains. By default the schedule key is the magnitude of
+   * the error, so long and short moves can use different gains. Pass `ikeySupplier` to schedule on
+   * something else, for example `[] { return pros::battery::get_voltage() / 1000.0; }`.
+   *
+   * @param ischedule The gain schedule.
+   * @param itimeUtil see TimeUtil docs
+   * @param ikeySupplier Returns the schedule key. Leave empty to use the error magnitude.
+   * @param iderivativeFilter a filter for filtering the derivative term
+   * @param ilogger The logger this instance will log to.
+   */
+  GainScheduledPIDController(
+    const GainSchedule<N> &ischedule,
+    const TimeUtil &itimeUtil,
+    std::function<double()> ikeySupplier = nullptr,
+    std::unique_ptr<Filter> iderivativeFilter = std::make_unique<PassthroughFilter>(),
+    std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger())
+    : IterativePosPIDController(ischedule.get(0),
+                                itimeUtil,
+                                std::move(iderivativeFilter),
+                                std::move(ilogger)),
+      schedule(ischedule),
+      keySupplier(std::move(ikeySupplier)) {
+  }
+
+  /**
+   * Looks up the gains for the current key, then does one iteration of the controller.
+   *
+   * @param inewReading new measurement
+   * @return controller output
+   */
+  double step(const double inewReading) override {
+    const double key = keySupplier ? keySupplier() : std::abs(target - inewReading);
+    setGains(schedule.get(key));
+    return IterativePosPIDController::step(inewReading);
+  }
+
+  /**
+   * Replaces the gain schedule.
+   *
+   * @param ischedule The new schedule.
+   */
+  void setSchedule(const GainSchedule<N> &ischedule) {
+    schedule = ischedule;
+  }
+
+  protected:
+  GainSchedule<N> schedule;
+  std::function<double()> keySupplier;
+};
+} // namespace okapi
@@ -0,0 +1,98 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+
+namespace okapi {
+class IterativeAnglePIDController : public IterativePosPIDController {
+  public:
+  /**
+   * Position PID controller for headings in degrees, such as a GPS yaw or an IMU heading. The
+   * error is the shortest signed rotation from the reading to the target, so the controller never
+   * goes the long way around and settles on angular distance. Readings are unwrapped internally,
+   * so a reading jumping from 180 to -180 degrees does not disturb the derivative term. Readings
+   * and targets may use any wrapping convention.
+   *
+   * @param ikP the proportional gain
+   * @param ikI the integration gain
+   * @param ikD the derivative gain
+   * @param ikBias the controller bias
+   * @param itimeUtil see TimeUtil docs
+   * @param iderivativeFilter a filter for filtering the derivative term
+   * @param ilogger The logger this instance will log to.
+   */
+  IterativeAnglePIDController(
+    double ikP,
+    double ikI,
+    double ikD,
+    double ikBias,
+    const TimeUtil &itimeUtil,
+    std::unique_ptr<Filter> iderivativeFilter = std::make_unique<PassthroughFilter>(),
+    std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Position PID controller for headings in degrees. See the other constructor.
+   *
+   * @param igains the controller gains
+   * @param itimeUtil see TimeUtil docs
+   * @param iderivativeFilter a filter for filtering the derivative term
+   * @param ilogger The logger this instance will log to.
+   */
+  IterativeAnglePIDController(
+    const Gains &igains,
+    const TimeUtil &itimeUtil,
+    std::unique_ptr<Filter> iderivativeFilter = std::make_unique<PassthroughFilter>(),
+    std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Do one iteration of the controller. Returns the reading in the range [-1, 1] unless the
+   * bounds have been changed with setOutputLimits().
+   *
+   * @param inewReading new heading in degrees
+   * @return controller output
+   */
+  double step(double inewReading) override;
+
+  /**
+   * Sets the target for the controller.
+   *
+   * @param itarget new target heading in degrees
+   */
+  void setTarget(double itarget) override;
+
+  /**
+   * Gets the last set target, or the default target if none was set.
+   *
+   * @return the last target
+   */
+  double getTarget() override;
+
+  /**
+   * Gets the last set target, or the default target if none was set.
+   *
+   * @return the last target
+   */
+  double getTarget() const;
+
+  /**
+   * @return The most recent heading, as it was passed to step().
+   */
+  double getProcessValue() const override;
+
+  /**
+   * Resets the controller's internal state so it is similar to when it was first initialized, while
+   * keeping any user-configured information.
+   */
+  void reset() override;
+
+  protected:
+  double angleTarget{0};
+  double lastRawReading{0};
+  double unwrappedReading{0};
+  bool hasReading{false};
+};
+} // namespace okapi
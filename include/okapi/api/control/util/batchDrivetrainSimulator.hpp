@@ -0,0 +1,221 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace okapi {
+/**
+ * The physical parameters of one robot. Lengths are in meters, masses in kg.
+ */
+struct BatchDrivetrainParameters {
+  AbstractMotor::gearset gearset{AbstractMotor::gearset::green};
+  double externalRatio{1};  // Wheel speed / motor speed
+  double wheelRadius{0.0508};
+  double trackWidth{0.36};  // Between the left and right wheels
+  double mass{6};
+  double inertia{0};        // kg*m^2; 0 means a uniform square trackWidth on a side
+  double motorsPerSide{2};  // Motors ganged on each side of a skid-steer or H-drive
+
+  // Body friction: viscous (N per m/s, N*m per rad/s) plus Coulomb (N, N*m)
+  double linearDamping{2};
+  double angularDamping{0.2};
+  double linearFriction{4};
+  double angularFriction{0.4};
+
+  // Coefficient of friction between a wheel and the tiles. A wheel pushing harder than its share
+  // of the robot's weight times this slips instead.
+  double traction{0.8};
+
+  // Sideways resistance of each wheel. Traction wheels grip sideways up to lateralGrip times
+  // their traction limit; omni wheels roll sideways on their rollers against rollerDrag.
+  double lateralGrip{0};
+  double rollerDrag{0.5}; // N per m/s
+};
+
+class BatchDrivetrainSimulator {
+  public:
+  /**
+   * The drivetrain layouts, matching SkidSteerModel, HDriveModel, and XDriveModel. Each has one
+   * voltage channel per motor group, in the order that model's constructor takes its motors:
+   *
+   * - skidSteer: left, right
+   * - hDrive: left, right, middle
+   * - xDrive: top left, top right, bottom right, bottom left
+   *
+   * Positive voltage drives the robot forward on every channel (and right on the H-drive's middle
+   * wheel), as if reversed motors had already been accounted for.
+   */
+  enum class Drive { skidSteer, hDrive, xDrive };
+
+  using Parameters = BatchDrivetrainParameters;
+
+  /**
+   * Steps many independent robots of the same layout at once. Every quantity is stored as one
+   * contiguous array per field (structure of arrays) and each step is a handful of branch-free
+   * loops over the robots, so the compiler can vectorize the whole batch. Use this instead of
+   * stepping one model at a time when tuning or running Monte Carlo trials.
+   *
+   * Each wheel is driven by a DC motor whose torque falls linearly from the gearset's stall torque
+   * to zero at its free speed, and cannot push harder than its traction limit. Poses follow the
+   * odometry frame transformation convention: x is forward, y is to the right, and theta is
+   * clockwise, in meters and radians.
+   *
+   * @param idrive The drivetrain layout.
+   * @param icount The number of robots.
+   * @param iparameters The parameters every robot starts with.
+   * @param itimestep The step length (sec).
+   */
+  BatchDrivetrainSimulator(Drive idrive,
+                           std::size_t icount,
+                           const Parameters &iparameters = Parameters(),
+                           double itimestep = 0.01);
+
+  virtual ~BatchDrivetrainSimulator();
+
+  /**
+   * Step every robot by the timestep.
+   */
+  void step();
+
+  /**
+   * Sets the parameters of one robot.
+   *
+   * @param iindex The robot.
+   * @param iparameters The new parameters.
+   */
+  void setParameters(std::size_t iindex, const Parameters &iparameters);
+
+  /**
+   * Sets the pose of one robot and stops it.
+   *
+   * @param iindex The robot.
+   * @param ix The x position (m).
+   * @param iy The y position (m).
+   * @param itheta The heading (rad).
+   */
+  void setPose(std::size_t iindex, double ix, double iy, double itheta);
+
+  /**
+   * Sets the voltage of one channel of one robot.
+   *
+   * @param ichannel The channel.
+   * @param iindex The robot.
+   * @param ivoltage The voltage (V), from -12 to 12.
+   */
+  void setVoltage(std::size_t ichannel, std::size_t iindex, double ivoltage);
+
+  /**
+   * Returns the voltages of one channel for every robot, for writing a whole batch at once.
+   *
+   * @param ichannel The channel.
+   * @return getSize() voltages (V).
+   */
+  double *getVoltages(std::size_t ichannel);
+
+  /**
+   * Sets the timestep (sec).
+   *
+   * @param itimestep new timestep
+   */
+  void setTimestep(double itimestep);
+
+  /**
+   * @return The number of robots.
+   */
+  std::size_t getSize() const;
+
+  /**
+   * @return The number of voltage channels (and wheels) per robot.
+   */
+  std::size_t getNumChannels() const;
+
+  double getX(std::size_t iindex) const;
+  double getY(std::size_t iindex) const;
+  double getTheta(std::size_t iindex) const;
+
+  /**
+   * @return The robot-relative forward velocity (m/s).
+   */
+  double getForwardVelocity(std::size_t iindex) const;
+
+  /**
+   * @return The robot-relative rightward velocity (m/s).
+   */
+  double getRightVelocity(std::size_t iindex) const;
+
+  /**
+   * @return The clockwise angular velocity (rad/s).
+   */
+  double getAngularVelocity(std::size_t iindex) const;
+
+  /**
+   * @return The angle a wheel has turned through since its robot's pose was last set (rad).
+   */
+  double getWheelAngle(std::size_t ichannel, std::size_t iindex) const;
+
+  /**
+   * @return The angular velocity of a wheel (rad/s).
+   */
+  double getWheelVelocity(std::size_t ichannel, std::size_t iindex) const;
+
+  /**
+   * @return Whether a wheel hit its traction limit on the last step.
+   */
+  bool isWheelSlipping(std::size_t ichannel, std::size_t iindex) const;
+
+  protected:
+  const Drive drive;
+  const std::size_t count;
+  const std::size_t numChannels;
+  double timestep;
+
+  // Per channel: rolling direction (unit vector), whether it is a side of ganged motors, and
+  // where it sits as a multiple of half the track width
+  std::vector<double> directionX;
+  std::vector<double> directionY;
+  std::vector<double> ganged;
+  std::vector<double> offsetX;
+  std::vector<double> offsetY;
+
+  // Per robot parameters, derived from Parameters
+  std::vector<double> wheelRadius;
+  std::vector<double> halfTrack;
+  std::vector<double> mass;
+  std::vector<double> inertia;
+  std::vector<double> stallTorque; // At the wheel, per motor
+  std::vector<double> freeSpeed;   // At the wheel
+  std::vector<double> motorsPerSide;
+  std::vector<double> linearDamping;
+  std::vector<double> angularDamping;
+  std::vector<double> linearFriction;
+  std::vector<double> angularFriction;
+  std::vector<double> maxWheelForce;
+  std::vector<double> maxLateralForce;
+  std::vector<double> rollerDrag;
+
+  // Per robot state
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> theta;
+  std::vector<double> vx;
+  std::vector<double> vy;
+  std::vector<double> omega;
+
+  // Per channel per robot, channel-major (channel c of robot i is at c * count + i)
+  std::vector<double> voltages;
+  std::vector<double> wheelAngles;
+  std::vector<double> wheelVelocities;
+  std::vector<double> slipping;
+
+  // Force and torque accumulators for one step
+  std::vector<double> forceX;
+  std::vector<double> forceY;
+  std::vector<double> torque;
+};
+} // namespace okapi
@@ -0,0 +1,181 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+class ControlExecutor {
+  public:
+  /**
+   * The stages of one tick, in the order they run.
+   */
+  enum class Stage { sensorRead = 0, odometry, controllers, motorWrite };
+
+  static constexpr std::size_t numStages = 4;
+
+  struct StageTiming {
+    QTime last{0_ms};
+    QTime max{0_ms};
+    QTime total{0_ms};
+    std::uint32_t runs{0};
+
+    /**
+     * @return The mean time spent in this stage per tick it ran in.
+     */
+    QTime mean() const {
+      return runs > 0 ? total / runs : 0_ms;
+    }
+  };
+
+  /**
+   * Runs periodic steps from many controllers in one task, instead of one task per controller.
+   * Every tick runs the due steps of each Stage in order (sensor reads, then odometry, then
+   * controllers, then motor writes) and steps within a stage in the order they were added. All
+   * steps share one clock, so a controller always sees sensor data read in the same tick.
+   *
+   * A tick copies the list of steps under the lock and runs them after releasing it, so add(),
+   * getStageTiming(), and the other functions never wait for a step to finish. Only remove()
+   * waits, for a tick which is running the step.
+   *
+   * The time spent in each stage is measured with the TimeUtil's timer. Use a MicroTimer for
+   * sub-millisecond resolution:
+   *
+   * ```cpp
+   * TimeUtil timeUtil(
+   *   Supplier<std::unique_ptr<AbstractTimer>>([] { return std::make_unique<MicroTimer>(); }),
+   *   Supplier<std::unique_ptr<AbstractRate>>([] { return std::make_unique<Rate>(); }),
+   *   TimeUtilFactory::createDefault().getSettledUtilSupplier());
+   * auto executor = std::make_shared<ControlExecutor>(timeUtil);
+   * executor->add(ControlExecutor::Stage::sensorRead, [&] { readSensors(); });
+   * executor->startThread();
+   * ```
+   *
+   * @param itimeUtil The TimeUtil used for the tick rate and for stage timing.
+   * @param iperiod The time between ticks.
+   * @param ilogger The logger this instance will log to.
+   */
+  ControlExecutor(const TimeUtil &itimeUtil,
+                  QTime iperiod = 10_ms,
+                  std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  ControlExecutor(const ControlExecutor &) = delete;
+  ControlExecutor(ControlExecutor &&other) = delete;
+  ControlExecutor &operator=(const ControlExecutor &other) = delete;
+  ControlExecutor &operator=(ControlExecutor &&other) = delete;
+
+  virtual ~ControlExecutor();
+
+  /**
+   * Registers a step. Its period is rounded to a whole number of ticks (at least one), and every
+   * step is run on tick 0, so steps with the same period always run in the same tick.
+   *
+   * @param istage The stage to run the step in.
+   * @param istep The step.
+   * @param iperiod The time between runs of the step. Zero runs it every tick.
+   * @return An id which can be passed to remove().
+   */
+  virtual std::size_t add(Stage istage, std::function<void()> istep, QTime iperiod = 0_ms);
+
+  /**
+   * Unregisters a step. Once this returns, the step will not run again, so this waits for a tick
+   * which is running steps to finish. This must not be called from inside a step.
+   *
+   * @param iid The id returned by add().
+   */
+  virtual void remove(std::size_t iid);
+
+  /**
+   * Runs one tick: every step which is due, in stage order. This is called by the internal thread,
+   * but can also be called directly to drive the executor from another loop.
+   */
+  virtual void tick();
+
+  /**
+   * @param istage The stage.
+   * @return The time spent in that stage.
+   */
+  virtual StageTiming getStageTiming(Stage istage) const;
+
+  /**
+   * @return The number of ticks which took longer than the period.
+   */
+  virtual std::uint32_t getOverruns() const;
+
+  /**
+   * Clears the stage timing and overrun count.
+   */
+  virtual void resetTiming();
+
+  /**
+   * @return The time between ticks.
+   */
+  QTime getPeriod() const;
+
+  /**
+   * Starts the internal thread. The thread runs at a higher priority than the default so that
+   * controllers are not delayed by user tasks.
+   */
+  void startThread();
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  struct Entry {
+    Entry(std::size_t iid, Stage istage, std::uint32_t idivisor, std::function<void()> istep);
+
+    const std::size_t id;
+    const Stage stage;
+    const std::uint32_t divisor;
+    const std::function<void()> step;
+
+    // Set by remove() for a tick which copied the list before the step was removed
+    std::atomic_bool removed{false};
+  };
+
+  using EntryList = std::vector<std::shared_ptr<Entry>>;
+
+  std::shared_ptr<Logger> logger;
+  TimeUtil timeUtil;
+  const QTime period;
+  std::unique_ptr<AbstractTimer> stageTimer;
+
+  // Sorted by stage, then by the order the steps were added. Replaced rather than changed, so a
+  // tick can keep running the copy it took.
+  std::shared_ptr<const EntryList> entries{std::make_shared<const EntryList>()};
+  std::size_t nextId{0};
+  std::uint32_t tickCount{0};
+
+  std::array<StageTiming, numStages> stageTimings{};
+  std::uint32_t overruns{0};
+
+  // Guards entries, nextId, stageTimings, and overruns. Never held while a step runs.
+  mutable CrossplatformMutex mutex;
+
+  // Held by a tick while it runs steps, so remove() can wait for it and ticks do not overlap
+  CrossplatformMutex tickMutex;
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
@@ -0,0 +1,128 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/odometry/odomState.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace okapi {
+class PoseSettledUtil {
+  public:
+  /**
+   * Why the last call to isSettled() did or did not report settled. Each flag is true when that
+   * condition is met.
+   */
+  struct Status {
+    QLength distanceError{0_m};
+    QAngle angleError{0_deg};
+    QSpeed speed{0_mps};
+    QAngularSpeed angularSpeed{0_rpm};
+    QTime timeAtTarget{0_ms};
+
+    bool isDistanceSettled{false};
+    bool isAngleSettled{false};
+    bool isSpeedSettled{false};
+    bool isAngularSpeedSettled{false};
+    bool isSettled{false};
+
+    /**
+     * @return A short description of the conditions which are not met yet, or "settled".
+     */
+    std::string str() const;
+  };
+
+  /**
+   * A utility class to determine if a pose controller has settled. Unlike combining one
+   * SettledUtil per axis, this looks at the pose as a whole: the straight-line distance to the
+   * target, the shortest angle to the target heading, and the linear and angular speed measured
+   * over the recent pose history. The pose is settled once all four have been within their
+   * thresholds for `iatTargetTime`.
+   *
+   * @param iatTargetTimer A timer used to track `iatTargetTime` and timestamp poses.
+   * @param iatTargetDistance The maximum distance to the target to be considered settled.
+   * @param iatTargetAngle The maximum angle to the target heading to be considered settled.
+   * @param iatTargetSpeed The maximum linear speed to be considered settled.
+   * @param iatTargetAngularSpeed The maximum angular speed to be considered settled.
+   * @param iatTargetTime The minimum time within all thresholds to be considered settled.
+   * @param ivelocityWindow The span of pose history the speeds are measured over. At most
+   * `historySize` poses are kept, so very long windows are shortened at high loop rates. If the
+   * poses come further apart than this, the speeds are measured between the last two. Noisy poses,
+   * like the GPS's, need a longer window so the noise does not read as motion.
+   */
+  explicit PoseSettledUtil(std::unique_ptr<AbstractTimer> iatTargetTimer,
+                           QLength iatTargetDistance = 1_in,
+                           QAngle iatTargetAngle = 2_deg,
+                           QSpeed iatTargetSpeed = 2_in / second,
+                           QAngularSpeed iatTargetAngularSpeed = 10_deg / second,
+                           QTime iatTargetTime = 250_ms,
+                           QTime ivelocityWindow = 100_ms);
+
+  virtual ~PoseSettledUtil();
+
+  /**
+   * Returns whether the pose is settled at the target.
+   *
+   * @param icurrent The current pose.
+   * @param itarget The target pose.
+   * @return Whether the pose is settled.
+   */
+  virtual bool isSettled(const OdomState &icurrent, const OdomState &itarget);
+
+  /**
+   * @return Why the last call to isSettled() did or did not report settled.
+   */
+  virtual const Status &getStatus() const;
+
+  /**
+   * Resets the "at target" timer and clears the pose history.
+   */
+  virtual void reset();
+
+  /**
+   * Sets the time all thresholds must be met for.
+   *
+   * @param iatTargetTime The new time.
+   */
+  virtual void setAtTargetTime(QTime iatTargetTime);
+
+  /**
+   * Sets the span of pose history the speeds are measured over.
+   *
+   * @param ivelocityWindow The new span.
+   */
+  virtual void setVelocityWindow(QTime ivelocityWindow);
+
+  static constexpr std::size_t historySize = 32;
+
+  protected:
+  struct StampedPose {
+    QTime time{0_ms};
+    OdomState pose;
+  };
+
+  std::unique_ptr<AbstractTimer> atTargetTimer;
+  QLength atTargetDistance;
+  QAngle atTargetAngle;
+  QSpeed atTargetSpeed;
+  QAngularSpeed atTargetAngularSpeed;
+  QTime atTargetTime;
+  QTime velocityWindow;
+
+  // Ring buffer of recent poses; historyIndex is the next slot to write
+  std::array<StampedPose, historySize> history{};
+  std::size_t historyIndex{0};
+  std::size_t historyCount{0};
+
+  Status status;
+};
+} // namespace okapi
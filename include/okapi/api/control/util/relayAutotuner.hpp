@@ -0,0 +1,168 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+
+namespace okapi {
+class RelayAutotuner {
+  public:
+  enum class TuningRule {
+    zieglerNichols, ///< Classic Ziegler-Nichols. Fast, with noticeable overshoot.
+    tyreusLuyben,   ///< Slower and more robust than Ziegler-Nichols.
+    pessenIntegral, ///< Strong integral action for fast disturbance rejection.
+    someOvershoot,  ///< Ziegler-Nichols variant with less overshoot.
+    noOvershoot     ///< Ziegler-Nichols variant with little to no overshoot.
+  };
+
+  enum class State {
+    idle,    ///< start() has not been called.
+    running, ///< The relay experiment is in progress.
+    done,    ///< The experiment finished and a result is available.
+    aborted  ///< The experiment was stopped before finishing. The output was set to zero.
+  };
+
+  struct Result {
+    double ultimateGain{0};
+    QTime ultimatePeriod{0_ms};
+    double amplitude{0};
+  };
+
+  /**
+   * Finds PID gains online with an Astrom-Hagglund relay experiment. The output is switched between
+   * `+irelayAmplitude` and `-irelayAmplitude` whenever the reading crosses the setpoint (with
+   * hysteresis), which makes the system oscillate at its ultimate period. The ultimate gain follows
+   * from the size of that oscillation, and the gains follow from a tuning rule. The experiment only
+   * needs a few oscillations, so it takes seconds.
+   *
+   * The experiment runs one step at a time inside an existing control loop and does not allocate.
+   * It aborts and sets the output to zero if the reading leaves `[iminReading, imaxReading]` or if
+   * it has not finished within `itimeout`.
+   *
+   * A positive output must make the reading increase, since the relay drives the output high while
+   * the reading is below the setpoint. If the plant runs the other way (for example a mechanism
+   * whose sensor counts down as it is powered), reverse the output or the input first, or the
+   * relay pushes the reading away from the setpoint until it leaves the safe range.
+   *
+   * @param iinput The controller input.
+   * @param ioutput The controller output.
+   * @param itimeUtil The TimeUtil. Its timer timestamps the oscillation and its rate paces
+   * autotune().
+   * @param isetpoint The reading to oscillate around.
+   * @param irelayAmplitude The output magnitude in the range (0, 1].
+   * @param ihysteresis How far the reading must cross the setpoint before the relay switches. Set
+   * this above the sensor noise.
+   * @param iminReading The lowest safe reading.
+   * @param imaxReading The highest safe reading.
+   * @param itimeout The longest the experiment may run.
+   * @param inumCycles The number of oscillations to measure, at most `maxCycles`. One more
+   * oscillation is run first to let the system settle into the cycle.
+   * @param ilogger The logger this instance will log to.
+   */
+  RelayAutotuner(const std::shared_ptr<ControllerInput<double>> &iinput,
+                 const std::shared_ptr<ControllerOutput<double>> &ioutput,
+                 const TimeUtil &itimeUtil,
+                 double isetpoint,
+                 double irelayAmplitude,
+                 double ihysteresis,
+                 double iminReading,
+                 double imaxReading,
+                 QTime itimeout = 15_s,
+                 std::size_t inumCycles = 4,
+                 const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  virtual ~RelayAutotuner();
+
+  /**
+   * Starts (or restarts) the experiment. Call step() every loop afterwards.
+   */
+  virtual void start();
+
+  /**
+   * Does one iteration of the experiment: reads the input and writes the output.
+   *
+   * @return The state after this iteration.
+   */
+  virtual State step();
+
+  /**
+   * Starts the experiment and blocks until it is done or aborted, stepping at `iloopDelta`.
+   *
+   * @param iloopDelta The loop period.
+   * @return The final state.
+   */
+  virtual State autotune(QTime iloopDelta = 10_ms);
+
+  /**
+   * Stops the experiment and sets the output to zero.
+   */
+  virtual void abort();
+
+  /**
+   * @return The current state.
+   */
+  virtual State getState() const;
+
+  /**
+   * @return The measured ultimate gain and period. Only valid once the state is done.
+   */
+  virtual Result getResult() const;
+
+  /**
+   * Computes gains from the result using a tuning rule. Only valid once the state is done.
+   *
+   * @param irule The tuning rule.
+   * @return The gains, in the units IterativePosPIDController expects.
+   */
+  virtual IterativePosPIDController::Gains
+  getGains(TuningRule irule = TuningRule::noOvershoot) const;
+
+  static constexpr std::size_t maxCycles = 8;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<ControllerInput<double>> input;
+  std::shared_ptr<ControllerOutput<double>> output;
+  std::unique_ptr<AbstractTimer> timer;
+  std::unique_ptr<AbstractRate> rate;
+
+  const double setpoint;
+  const double relayAmplitude;
+  const double hysteresis;
+  const double minReading;
+  const double maxReading;
+  const QTime timeout;
+  const std::size_t numCycles;
+
+  State state{State::idle};
+  Result result;
+  bool relayHigh{true};
+  QTime startTime{0_ms};
+  QTime lastCycleStart{0_ms};
+  std::size_t cyclesSeen{0};
+  double cycleMax{0};
+  double cycleMin{0};
+  std::array<double, maxCycles> periods{}; // Seconds
+  std::array<double, maxCycles> amplitudes{};
+
+  /**
+   * Closes the current oscillation at time inow and finishes the experiment if enough have been
+   * measured.
+   *
+   * @param inow The time of ireading.
+   * @param ireading The validated reading which closed the oscillation. It starts the next one.
+   */
+  void completeCycle(QTime inow, double ireading);
+};
+} // namespace okapi
@@ -0,0 +1,161 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/flywheelSimulator.hpp"
+#include "okapi/api/control/util/pidTuner.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/supplier.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * A plant model the SimulatedPIDTuner can run trials against.
+ */
+class SimulatedPlant {
+  public:
+  virtual ~SimulatedPlant();
+
+  /**
+   * Applies a controller output for one period and advances the model.
+   *
+   * @param ioutput The controller output in the range [-1, 1].
+   * @param idt The length of the period.
+   * @return The process value at the end of the period.
+   */
+  virtual double step(double ioutput, QTime idt) = 0;
+
+  /**
+   * @return The current process value.
+   */
+  virtual double getProcessValue() const = 0;
+};
+
+/**
+ * Runs a FlywheelSimulator as a SimulatedPlant. The controller output is scaled to the maximum
+ * torque and the process value is the angle of the link in radians.
+ */
+class FlywheelPlant : public SimulatedPlant {
+  public:
+  /**
+   * @param isimulator The simulator to run. Each plant must own its own simulator.
+   */
+  explicit FlywheelPlant(std::unique_ptr<FlywheelSimulator> isimulator);
+
+  double step(double ioutput, QTime idt) override;
+
+  double getProcessValue() const override;
+
+  protected:
+  std::unique_ptr<FlywheelSimulator> simulator;
+};
+
+class SimulatedPIDTuner {
+  public:
+  struct Result {
+    PIDTuner::Output gains{0, 0, 0};
+    double bestCost{0};
+    std::vector<double> bestCostPerIteration;
+    std::size_t numTrials{0};
+    std::size_t numThreads{1};
+  };
+
+  /**
+   * Tunes an IterativePosPIDController with the same particle swarm search as PIDTuner, but runs
+   * every trial against a simulated plant instead of the robot. With `THREADS_STD` the particles
+   * of each iteration are evaluated in parallel across all hardware threads, so a full search takes
+   * seconds. Use PIDTuner on the robot afterwards to refine the result.
+   *
+   * Each trial moves the plant from its initial state to `igoal` and is scored as
+   * `ikSettle * settle time + ikITAE * ITAE`, both in seconds. Trials that never settle are scored
+   * with the full timeout as their settle time.
+   *
+   * @param iplantSupplier Makes a fresh plant for each trial. Called from several threads at once.
+   * @param itimeout The maximum simulated length of each trial.
+   * @param igoal The target of each trial.
+   * @param ikPMin The lower bound of the kP search range.
+   * @param ikPMax The upper bound of the kP search range.
+   * @param ikIMin The lower bound of the kI search range.
+   * @param ikIMax The upper bound of the kI search range.
+   * @param ikDMin The lower bound of the kD search range.
+   * @param ikDMax The upper bound of the kD search range.
+   * @param inumIterations The number of swarm iterations.
+   * @param inumParticles The number of particles, which is the number of trials per iteration.
+   * @param ikSettle The weight of the settle time in the cost.
+   * @param ikITAE The weight of the ITAE in the cost.
+   * @param iatTargetError The error the plant must stay within to count as settled.
+   * @param iseed The seed for the swarm's random numbers. Equal seeds give equal results.
+   * @param ilogger The logger this instance will log to.
+   */
+  SimulatedPIDTuner(const Supplier<std::unique_ptr<SimulatedPlant>> &iplantSupplier,
+                    QTime itimeout,
+                    double igoal,
+                    double ikPMin,
+                    double ikPMax,
+                    double ikIMin,
+                    double ikIMax,
+                    double ikDMin,
+                    double ikDMax,
+                    std::size_t inumIterations = 20,
+                    std::size_t inumParticles = 64,
+                    double ikSettle = 1,
+                    double ikITAE = 2,
+                    double iatTargetError = 0.05,
+                    std::uint32_t iseed = 0,
+                    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  virtual ~SimulatedPIDTuner();
+
+  /**
+   * Runs the search.
+   *
+   * @return The best gains found and statistics about the search.
+   */
+  virtual Result autotune();
+
+  /**
+   * Runs one trial.
+   *
+   * @param igains The gains to try.
+   * @return The cost of the trial. Lower is better.
+   */
+  virtual double evaluate(const PIDTuner::Output &igains) const;
+
+  protected:
+  static constexpr double inertia = 0.5;   // Particle inertia
+  static constexpr double confSelf = 1.1;  // Self confidence
+  static constexpr double confSwarm = 1.2; // Particle swarm confidence
+  static constexpr QTime loopDelta = 10_ms; // NOLINT
+  static constexpr QTime atTargetTime = 250_ms; // NOLINT
+
+  std::shared_ptr<Logger> logger;
+  Supplier<std::unique_ptr<SimulatedPlant>> plantSupplier;
+
+  const QTime timeout;
+  const double goal;
+  const double kPMin;
+  const double kPMax;
+  const double kIMin;
+  const double kIMax;
+  const double kDMin;
+  const double kDMax;
+  const std::size_t numIterations;
+  const std::size_t numParticles;
+  const double kSettle;
+  const double kITAE;
+  const double atTargetError;
+  const std::uint32_t seed;
+
+  /**
+   * Evaluates every set of gains, in parallel when possible.
+   */
+  std::vector<double> evaluateAll(const std::vector<PIDTuner::Output> &igains,
+                                  std::size_t inumThreads) const;
+};
+} // namespace okapi
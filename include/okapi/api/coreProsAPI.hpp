@@ -20,6 +20,8 @@
 
 #include <mutex>
 #define CROSSPLATFORM_MUTEX_T std::mutex
+
+#include <condition_variable>
 #else
 #include "api.h"
 #include "pros/apix.h"
@@ -129,3 +131,105 @@ class CrossplatformMutex {
   protected:
   CROSSPLATFORM_MUTEX_T mutex;
 };
+
+/**
+ * Lets any number of tasks block until some condition becomes true, without polling. The task that
+ * changes the condition calls notifyAll() afterwards, which wakes every waiter to recheck it.
+ */
+class CrossplatformEvent {
+  public:
+  CrossplatformEvent() = default;
+
+  CrossplatformEvent(const CrossplatformEvent &) = delete;
+  CrossplatformEvent &operator=(const CrossplatformEvent &) = delete;
+
+  /**
+   * Blocks the current task until ipredicate returns true. ipredicate is checked once up front and
+   * again after every notifyAll().
+   *
+   * @param ipredicate The condition to wait for.
+   */
+  template <typename Predicate> void wait(Predicate ipredicate) {
+#ifdef THREADS_STD
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!ipredicate()) {
+      const std::uint32_t lastGeneration = generation;
+      condition.wait(lock, [&] { return generation != lastGeneration; });
+    }
+#else
+    std::uint32_t strayNotifications = 0;
+    while (true) {
+      // The check and the registration happen under the mutex so a notifyAll() in between the two
+      // cannot be missed
+      mutex.take(TIMEOUT_MAX);
+      if (ipredicate()) {
+        mutex.give();
+        break;
+      }
+      Waiter self{pros::c::task_get_current(), waiters};
+      waiters = &self;
+      const std::uint32_t lastGeneration = generation;
+      mutex.give();
+
+      // Each waiter is woken through its own task, so one waking twice cannot take another's
+      // wakeup. Notifications sent to the task for anything else are given back afterwards.
+      while (true) {
+        pros::c::task_notify_take(false, TIMEOUT_MAX);
+        mutex.take(TIMEOUT_MAX);
+        const bool notified = generation != lastGeneration;
+        mutex.give();
+        if (notified) {
+          break;
+        }
+        strayNotifications++;
+      }
+    }
+
+    for (; strayNotifications > 0; strayNotifications--) {
+      pros::c::task_notify(pros::c::task_get_current());
+    }
+#endif
+  }
+
+  /**
+   * Wakes every task blocked in wait() so it rechecks its condition.
+   */
+  void notifyAll() {
+#ifdef THREADS_STD
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      generation++;
+    }
+    condition.notify_all();
+#else
+    mutex.take(TIMEOUT_MAX);
+    generation++;
+    // A woken waiter may leave wait() at once, so its entry is not touched after it is notified
+    while (waiters) {
+      Waiter *const waiter = waiters;
+      waiters = waiter->next;
+      pros::c::task_notify(waiter->task);
+    }
+    mutex.give();
+#endif
+  }
+
+  protected:
+#ifdef THREADS_STD
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::uint32_t generation{0};
+#else
+  /**
+   * A task blocked in wait(), kept on its stack until notifyAll() takes it off the list.
+   */
+  struct Waiter {
+    pros::task_t task;
+    Waiter *next;
+  };
+
+  pros::Mutex mutex;
+  Waiter *waiters{nullptr};
+  std::uint32_t generation{0};
+#endif
+};
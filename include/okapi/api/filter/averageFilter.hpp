@@ -7,11 +7,14 @@
 
 #include "okapi/api/filter/filter.hpp"
 #include <array>
+#include <cmath>
 #include <cstddef>
 
 namespace okapi {
 /**
- * A filter which returns the average of a list of values.
+ * A filter which returns the average of a list of values. Each call to filter() runs in constant
+ * time regardless of the number of taps, except that once per pass over the window the sum is
+ * recomputed from the window.
  *
  * @tparam n number of taps in the filter
  */
@@ -29,16 +32,26 @@ template <std::size_t n> class AverageFilter : public Filter {
    * @return filtered result
    */
   double filter(const double ireading) override {
+    // Keep a running sum instead of re-summing the window. The sum is Kahan-compensated so that
+    // rounding error from repeatedly adding and removing samples does not accumulate.
+    const double delta = (ireading - data[index]) - compensation;
+    const double newSum = sum + delta;
+    compensation = (newSum - sum) - delta;
+    sum = newSum;
+
     data[index++] = ireading;
     if (index >= n) {
       index = 0;
     }
 
-    output = 0.0;
-    for (size_t i = 0; i < n; i++)
-      output += data[i];
-    output /= (double)n;
+    // A non-finite sample (such as PROS_ERR_F) would leave the running sum non-finite even after it
+    // leaves the window, so re-sum until it has. Re-summing once per pass also drops whatever
+    // rounding error the compensation missed.
+    if (index == 0 || !std::isfinite(sum)) {
+      resum();
+    }
 
+    output = sum / (double)n;
     return output;
   }
 
@@ -54,6 +67,21 @@ template <std::size_t n> class AverageFilter : public Filter {
   protected:
   std::array<double, n> data{0};
   std::size_t index = 0;
+  double sum = 0;
+  double compensation = 0;
   double output = 0;
+
+  /**
+   * Recomputes the sum from the window. A plain sum of one window is accurate enough, and unlike
+   * a compensated one it stays infinite rather than turning to NaN while an infinite sample is in
+   * the window.
+   */
+  void resum() {
+    sum = 0;
+    compensation = 0;
+    for (const double sample : data) {
+      sum += sample;
+    }
+  }
 };
 } // namespace okapi
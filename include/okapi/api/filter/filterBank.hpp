@@ -0,0 +1,213 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/demaFilter.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace okapi {
+/**
+ * A bank of N filters of the same kind which are stepped together. The state of every channel is
+ * stored contiguously and each step is a single non-virtual loop over the channels, so filtering a
+ * pose or a set of wheel velocities costs one call instead of one virtual call per channel. The
+ * loops are written over fixed-size arrays so the compiler can vectorize them.
+ *
+ * Supported kinds are EmaFilter and DemaFilter. The channels behave exactly like N independent
+ * instances of that filter.
+ *
+ * @tparam N The number of channels.
+ * @tparam Kind The filter each channel behaves as.
+ */
+template <std::size_t N, typename Kind> class FilterBank;
+
+template <std::size_t N> class FilterBank<N, EmaFilter> {
+  public:
+  /**
+   * A bank of exponential moving average filters sharing one gain.
+   *
+   * @param ialpha alpha gain
+   */
+  explicit FilterBank(const double ialpha) {
+    setGains(ialpha);
+  }
+
+  /**
+   * A bank of exponential moving average filters with a gain per channel.
+   *
+   * @param ialphas alpha gain for each channel
+   */
+  explicit FilterBank(const std::array<double, N> &ialphas) {
+    setGains(ialphas);
+  }
+
+  /**
+   * Filters one reading per channel.
+   *
+   * @param ireadings new measurements
+   * @return filtered results
+   */
+  const std::array<double, N> &filter(const std::array<double, N> &ireadings) {
+    for (std::size_t i = 0; i < N; i++) {
+      output[i] = alpha[i] * ireadings[i] + (1.0 - alpha[i]) * output[i];
+    }
+
+    return output;
+  }
+
+  /**
+   * Returns the previous output from filter.
+   *
+   * @return the previous output from filter
+   */
+  const std::array<double, N> &getOutput() const {
+    return output;
+  }
+
+  /**
+   * Set the gain of every channel.
+   *
+   * @param ialpha alpha gain
+   */
+  void setGains(const double ialpha) {
+    alpha.fill(ialpha);
+  }
+
+  /**
+   * Set the gain of each channel.
+   *
+   * @param ialphas alpha gain for each channel
+   */
+  void setGains(const std::array<double, N> &ialphas) {
+    alpha = ialphas;
+  }
+
+  protected:
+  alignas(16) std::array<double, N> alpha{};
+  alignas(16) std::array<double, N> output{};
+};
+
+template <std::size_t N> class FilterBank<N, DemaFilter> {
+  public:
+  /**
+   * A bank of double exponential moving average filters sharing one set of gains.
+   *
+   * @param ialpha alpha gain
+   * @param ibeta beta gain
+   */
+  FilterBank(const double ialpha, const double ibeta) {
+    setGains(ialpha, ibeta);
+  }
+
+  /**
+   * A bank of double exponential moving average filters with gains per channel.
+   *
+   * @param ialphas alpha gain for each channel
+   * @param ibetas beta gain for each channel
+   */
+  FilterBank(const std::array<double, N> &ialphas, const std::array<double, N> &ibetas) {
+    setGains(ialphas, ibetas);
+  }
+
+  /**
+   * Filters one reading per channel.
+   *
+   * @param ireadings new measurements
+   * @return filtered results
+   */
+  const std::array<double, N> &filter(const std::array<double, N> &ireadings) {
+    for (std::size_t i = 0; i < N; i++) {
+      const double outputS =
+        alpha[i] * ireadings[i] + (1.0 - alpha[i]) * (lastOutputS[i] + lastOutputB[i]);
+      const double outputB =
+        beta[i] * (outputS - lastOutputS[i]) + (1.0 - beta[i]) * lastOutputB[i];
+      lastOutputS[i] = outputS;
+      lastOutputB[i] = outputB;
+      output[i] = outputS + outputB;
+    }
+
+    return output;
+  }
+
+  /**
+   * Returns the previous output from filter.
+   *
+   * @return the previous output from filter
+   */
+  const std::array<double, N> &getOutput() const {
+    return output;
+  }
+
+  /**
+   * Set the gains of every channel.
+   *
+   * @param ialpha alpha gain
+   * @param ibeta beta gain
+   */
+  void setGains(const double ialpha, const double ibeta) {
+    alpha.fill(ialpha);
+    beta.fill(ibeta);
+  }
+
+  /**
+   * Set the gains of each channel.
+   *
+   * @param ialphas alpha gain for each channel
+   * @param ibetas beta gain for each channel
+   */
+  void setGains(const std::array<double, N> &ialphas, const std::array<double, N> &ibetas) {
+    alpha = ialphas;
+    beta = ibetas;
+  }
+
+  protected:
+  alignas(16) std::array<double, N> alpha{};
+  alignas(16) std::array<double, N> beta{};
+  alignas(16) std::array<double, N> lastOutputS{};
+  alignas(16) std::array<double, N> lastOutputB{};
+  alignas(16) std::array<double, N> output{};
+};
+
+/**
+ * Exposes a single-channel FilterBank as a scalar Filter, so a bank kind can be used anywhere a
+ * Filter is expected.
+ *
+ * @tparam Kind The filter kind of the underlying bank.
+ */
+template <typename Kind> class FilterBankAdapter : public Filter {
+  public:
+  /**
+   * Wraps a single-channel bank. The arguments are forwarded to the FilterBank constructor.
+   */
+  template <typename... Args>
+  explicit FilterBankAdapter(Args &&... iargs) : bank(std::forward<Args>(iargs)...) {
+  }
+
+  /**
+   * Filters a value, like a sensor reading.
+   *
+   * @param ireading new measurement
+   * @return filtered result
+   */
+  double filter(const double ireading) override {
+    return bank.filter({ireading})[0];
+  }
+
+  /**
+   * Returns the previous output from filter.
+   *
+   * @return the previous output from filter
+   */
+  double getOutput() const override {
+    return bank.getOutput()[0];
+  }
+
+  protected:
+  FilterBank<1, Kind> bank;
+};
+} // namespace okapi
@@ -0,0 +1,88 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/velMath.hpp"
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace okapi {
+class LeastSquaresVelMath : public VelMath {
+  public:
+  struct Derivatives {
+    QAngularSpeed velocity{0_rpm};
+    QAngularAcceleration accel{0.0};
+  };
+
+  /**
+   * Velocity math helper which fits a quadratic to the last `iwindowSize` timestamped positions
+   * (a Savitzky-Golay style least-squares fit) and reports the slope and curvature of that fit at
+   * the newest sample. Compared to differencing consecutive readings and filtering, this is less
+   * noisy at low speed and lags less at high speed. The fit is updated from running sums, so each
+   * step costs the same regardless of the window size. Throws a `std::invalid_argument` exception
+   * if `iticksPerRev` is zero or if `iwindowSize` is less than 3.
+   *
+   * @param iticksPerRev The number of ticks per revolution (or whatever units you are using).
+   * @param iwindowSize The number of samples to fit over.
+   * @param iloopDtTimer The timer used to timestamp each sample.
+   * @param ilogger The logger this instance will log to.
+   */
+  LeastSquaresVelMath(double iticksPerRev,
+                      std::size_t iwindowSize,
+                      std::unique_ptr<AbstractTimer> iloopDtTimer,
+                      std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Adds a new position sample and refits. Returns the velocity.
+   *
+   * @param inewPos The new position measurement.
+   * @return The new velocity estimate.
+   */
+  QAngularSpeed step(double inewPos) override;
+
+  /**
+   * Adds a new position sample and refits. Returns the velocity and acceleration.
+   *
+   * @param inewPos The new position measurement.
+   * @return The new velocity and acceleration estimates.
+   */
+  virtual Derivatives stepDerivatives(double inewPos);
+
+  /**
+   * Clears all samples. The next estimates will start from zero.
+   */
+  virtual void reset();
+
+  protected:
+  struct Sample {
+    double time{0}; // Seconds
+    double pos{0};
+  };
+
+  std::vector<Sample> samples;
+  std::size_t index{0};
+  std::size_t count{0};
+
+  // Running sums are taken relative to this sample to keep their magnitude small
+  Sample origin;
+
+  // timeSums[k] is the sum of t^k and posSums[k] is the sum of y * t^k
+  std::array<double, 5> timeSums{};
+  std::array<double, 3> posSums{};
+
+  /**
+   * Adds (isign = 1) or removes (isign = -1) a sample's contribution to the running sums.
+   */
+  void accumulate(const Sample &isample, double isign);
+
+  /**
+   * Moves the origin to the newest sample and recomputes the running sums from scratch, which
+   * discards any rounding error accumulated since the last rebase.
+   */
+  void rebase();
+};
+} // namespace okapi
@@ -1,6 +1,4 @@
 /*
- * Uses the median filter algorithm from N. Wirth’s book, implementation by N. Devillard.
- *
  * This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
@@ -8,19 +6,29 @@
 #pragma once
 
 #include "okapi/api/filter/filter.hpp"
-#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <utility>
 
 namespace okapi {
 /**
- * A filter which returns the median value of list of values.
+ * A filter which returns the median value of list of values. For an even number of taps, the
+ * lower of the two middle values is returned.
+ *
+ * The window is kept in two indexed heaps: a max-heap holding the lower half of the samples and a
+ * min-heap holding the upper half. A new reading overwrites the oldest sample in place, so each
+ * call to filter() costs O(log n) and never copies the window.
  *
  * @tparam n number of taps in the filter
  */
 template <std::size_t n> class MedianFilter : public Filter {
   public:
-  MedianFilter() : middleIndex((((n)&1) ? ((n) / 2) : (((n) / 2) - 1))) {
+  MedianFilter() {
+    // Every sample starts at zero, so the identity layout is already a valid pair of heaps
+    for (std::size_t i = 0; i < n; i++) {
+      heap[i] = i;
+      position[i] = i;
+    }
   }
 
   /**
@@ -30,12 +38,15 @@ template <std::size_t n> class MedianFilter : public Filter {
    * @return filtered result
    */
   double filter(const double ireading) override {
-    data[index++] = ireading;
+    data[index] = ireading;
+    update(position[index]);
+
+    index++;
     if (index >= n) {
       index = 0;
     }
 
-    output = kth_smallset();
+    output = data[heap[0]];
     return output;
   }
 
@@ -52,43 +63,79 @@ template <std::size_t n> class MedianFilter : public Filter {
   std::array<double, n> data{0};
   std::size_t index = 0;
   double output = 0;
-  const size_t middleIndex;
+
+  // Number of samples in the lower (max-heap) half. Its top is the median.
+  static constexpr std::size_t lowSize = (n + 1) / 2;
+
+  // Sample indices; [0, lowSize) is the lower max-heap and [lowSize, n) is the upper min-heap
+  std::array<std::size_t, n> heap{};
+
+  // The position of each sample in heap
+  std::array<std::size_t, n> position{};
 
   /**
-   * Algorithm from N. Wirth’s book, implementation by N. Devillard.
+   * Restores both heaps after the sample at heap node inode changed value.
    */
-  double kth_smallset() {
-    std::array<double, n> dataCopy = data;
-    size_t j, l, m;
-    l = 0;
-    m = n - 1;
-
-    while (l < m) {
-      double x = dataCopy[middleIndex];
-      size_t i = l;
-      j = m;
-      do {
-        while (dataCopy[i] < x) {
-          i++;
-        }
-        while (x < dataCopy[j]) {
-          j--;
-        }
-        if (i <= j) {
-          const double t = dataCopy[i];
-          dataCopy[i] = dataCopy[j];
-          dataCopy[j] = t;
-          i++;
-          j--;
-        }
-      } while (i <= j);
-      if (j < middleIndex)
-        l = i;
-      if (middleIndex < i)
-        m = j;
+  void update(const std::size_t inode) {
+    sift(inode);
+
+    // Only one sample changed, so at most one exchange between the halves is needed
+    if (lowSize < n && data[heap[0]] > data[heap[lowSize]]) {
+      swapNodes(0, lowSize);
+      sift(0);
+      sift(lowSize);
     }
+  }
+
+  /**
+   * Moves the node at inode up or down within its own half until that half is a heap again.
+   */
+  void sift(const std::size_t inode) {
+    const bool isLow = inode < lowSize;
+    const std::size_t base = isLow ? 0 : lowSize;
+    const std::size_t size = isLow ? lowSize : n - lowSize;
+    std::size_t i = inode - base;
+
+    while (i > 0) {
+      const std::size_t parent = (i - 1) / 2;
+      if (!isAbove(base + i, base + parent, isLow)) {
+        break;
+      }
+
+      swapNodes(base + i, base + parent);
+      i = parent;
+    }
+
+    while (true) {
+      std::size_t child = 2 * i + 1;
+      if (child >= size) {
+        break;
+      }
+
+      if (child + 1 < size && isAbove(base + child + 1, base + child, isLow)) {
+        child++;
+      }
+
+      if (!isAbove(base + child, base + i, isLow)) {
+        break;
+      }
+
+      swapNodes(base + child, base + i);
+      i = child;
+    }
+  }
+
+  /**
+   * Returns whether node ia belongs above node ib in the given half.
+   */
+  bool isAbove(const std::size_t ia, const std::size_t ib, const bool iisLow) const {
+    return iisLow ? data[heap[ia]] > data[heap[ib]] : data[heap[ia]] < data[heap[ib]];
+  }
 
-    return dataCopy[middleIndex];
+  void swapNodes(const std::size_t ia, const std::size_t ib) {
+    std::swap(heap[ia], heap[ib]);
+    position[heap[ia]] = ia;
+    position[heap[ib]] = ib;
   }
 };
 } // namespace okapi
@@ -0,0 +1,107 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace okapi {
+/**
+ * A compile-time alternative to ComposableFilter. The input signal is passed through each filter
+ * in sequence and the output is the output of the last filter. Every stage is stored by value and
+ * called non-virtually, so the whole chain can be inlined into one function with no pointer
+ * chasing. Unlike ComposableFilter, stages cannot be added after construction.
+ *
+ * @tparam Filters The concrete filter type of each stage, in order.
+ */
+template <typename... Filters> class StaticFilterChain {
+  static_assert(sizeof...(Filters) > 0, "StaticFilterChain needs at least one filter.");
+
+  public:
+  /**
+   * Builds a chain from its stages.
+   *
+   * @param istages The filters to use in sequence.
+   */
+  explicit StaticFilterChain(Filters... istages) : stages(std::move(istages)...) {
+  }
+
+  /**
+   * Filters a value.
+   *
+   * @param ireading A new measurement.
+   * @return The filtered result.
+   */
+  double filter(const double ireading) {
+    output = filterStages(ireading, std::index_sequence_for<Filters...>{});
+    return output;
+  }
+
+  /**
+   * @return The previous output from filter.
+   */
+  double getOutput() const {
+    return output;
+  }
+
+  /**
+   * @return The filter at stage I.
+   */
+  template <std::size_t I> auto &getStage() {
+    return std::get<I>(stages);
+  }
+
+  protected:
+  std::tuple<Filters...> stages;
+  double output = 0;
+
+  template <std::size_t... Is>
+  double filterStages(double ivalue, std::index_sequence<Is...>) {
+    // Qualified calls bypass the vtable since each stage's concrete type is known
+    ((ivalue = std::get<Is>(stages).Filters::filter(ivalue)), ...);
+    return ivalue;
+  }
+};
+
+/**
+ * Exposes a StaticFilterChain as a Filter, so a fused chain can be passed anywhere a Filter is
+ * expected. Only the call into the chain is virtual; the stages inside it are not.
+ *
+ * @tparam Filters The concrete filter type of each stage, in order.
+ */
+template <typename... Filters> class StaticFilterChainAdapter : public Filter {
+  public:
+  /**
+   * Builds a chain from its stages.
+   *
+   * @param istages The filters to use in sequence.
+   */
+  explicit StaticFilterChainAdapter(Filters... istages) : chain(std::move(istages)...) {
+  }
+
+  /**
+   * Filters a value.
+   *
+   * @param ireading A new measurement.
+   * @return The filtered result.
+   */
+  double filter(const double ireading) override {
+    return chain.filter(ireading);
+  }
+
+  /**
+   * @return The previous output from filter.
+   */
+  double getOutput() const override {
+    return chain.getOutput();
+  }
+
+  protected:
+  StaticFilterChain<Filters...> chain;
+};
+} // namespace okapi
@@ -0,0 +1,92 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/units/QTime.hpp"
+
+namespace okapi {
+class HeadingFusion {
+  public:
+  /**
+   * A complementary filter which fuses an absolute but noisy heading (such as the GPS yaw) with a
+   * smooth but drifting relative heading (such as the IMU rotation). Changes in the relative
+   * heading are applied directly, and the estimate is pulled towards the absolute heading along the
+   * shortest rotation, so the ±180 degree wrap of the absolute heading never causes a jump. When
+   * the absolute heading is unavailable the estimate follows the relative heading alone.
+   *
+   * Both headings must increase in the same rotational direction.
+   *
+   * @param itimeConstant How long the absolute heading takes to correct about 63% of the drift.
+   * Larger values trust the relative heading more.
+   * @param imaxAbsoluteError Absolute readings whose reported error is above this are ignored.
+   */
+  explicit HeadingFusion(QTime itimeConstant = 1_s, double imaxAbsoluteError = 0.05);
+
+  virtual ~HeadingFusion();
+
+  /**
+   * Does one iteration of the filter.
+   *
+   * @param irelative The new relative heading. Must be continuous (not wrapped).
+   * @param iabsolute The new absolute heading, in any wrapping convention.
+   * @param iabsoluteError The reported error of the absolute heading. Non-finite values and values
+   * above the maximum error mark the absolute heading as unavailable.
+   * @param idt The time since the previous step.
+   * @return The new heading estimate.
+   */
+  virtual QAngle step(QAngle irelative, QAngle iabsolute, double iabsoluteError, QTime idt);
+
+  /**
+   * Does one iteration of the filter without an absolute heading.
+   *
+   * @param irelative The new relative heading. Must be continuous (not wrapped).
+   * @return The new heading estimate.
+   */
+  virtual QAngle step(QAngle irelative);
+
+  /**
+   * @return The heading estimate. It is continuous, so it is not wrapped into any range.
+   */
+  virtual QAngle getHeading() const;
+
+  /**
+   * @return The heading estimate constrained to [-180, 180) degrees.
+   */
+  virtual QAngle getWrappedHeading() const;
+
+  /**
+   * @return Whether the absolute heading was used in the last step.
+   */
+  virtual bool isAbsoluteValid() const;
+
+  /**
+   * @return Whether an absolute heading has ever been used since the last reset.
+   */
+  virtual bool hasAbsoluteFix() const;
+
+  /**
+   * Forgets all readings. The next step starts a new estimate.
+   */
+  virtual void reset();
+
+  /**
+   * Sets the time constant. See the constructor docs.
+   *
+   * @param itimeConstant The new time constant.
+   */
+  virtual void setTimeConstant(QTime itimeConstant);
+
+  protected:
+  QTime timeConstant;
+  double maxAbsoluteError;
+  QAngle heading{0_deg};
+  QAngle lastRelative{0_deg};
+  bool hasRelative{false};
+  bool absoluteValid{false};
+  bool absoluteFix{false};
+};
+} // namespace okapi
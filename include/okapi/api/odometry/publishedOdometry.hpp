@@ -0,0 +1,96 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/util/seqLock.hpp"
+#include <cstdint>
+#include <memory>
+
+namespace okapi {
+class PublishedOdometry : public Odometry {
+  public:
+  /**
+   * Wraps another Odometry and publishes its state after every step through a SeqLock. getState()
+   * reads the published copy, so any number of tasks can read the pose at any rate without ever
+   * contending with the task running the odometry.
+   *
+   * Pass this in place of the wrapped odometry when building an OdomChassisController, then read
+   * the pose from this object.
+   *
+   * @param iodometry The odometry to wrap.
+   */
+  explicit PublishedOdometry(std::shared_ptr<Odometry> iodometry);
+
+  /**
+   * Sets the drive and turn scales.
+   */
+  void setScales(const ChassisScales &ichassisScales) override;
+
+  /**
+   * Does one odometry step, then publishes the new state.
+   */
+  void step() override;
+
+  /**
+   * Returns the last published state. This never blocks.
+   *
+   * @param imode The mode to return the state in.
+   * @return The current state in the given format.
+   */
+  OdomState getState(const StateMode &imode = StateMode::FRAME_TRANSFORMATION) const override;
+
+  /**
+   * Returns the last published state and its version. Compare the version with getVersion() to
+   * tell whether the state changed since it was read.
+   *
+   * @param oversion Set to the version of the returned state.
+   * @param imode The mode to return the state in.
+   * @return The current state in the given format.
+   */
+  virtual OdomState getState(std::uint32_t &oversion,
+                             const StateMode &imode = StateMode::FRAME_TRANSFORMATION) const;
+
+  /**
+   * @return The number of times the state has been published. It wraps around.
+   */
+  virtual std::uint32_t getVersion() const;
+
+  /**
+   * Sets a new state to be the current state and publishes it.
+   *
+   * @param istate The new state in the given format.
+   * @param imode The mode to treat the input state as.
+   */
+  void setState(const OdomState &istate,
+                const StateMode &imode = StateMode::FRAME_TRANSFORMATION) override;
+
+  /**
+   * @return The internal ChassisModel.
+   */
+  std::shared_ptr<ReadOnlyChassisModel> getModel() override;
+
+  /**
+   * @return The internal ChassisScales.
+   */
+  ChassisScales getScales() override;
+
+  protected:
+  struct Snapshot {
+    OdomState frameTransformation;
+    OdomState cartesian;
+  };
+
+  std::shared_ptr<Odometry> odometry;
+  SeqLock<Snapshot> published;
+
+  // Serializes step() and setState(), which are usually called from different tasks
+  CrossplatformMutex writeMutex;
+
+  void publish();
+};
+} // namespace okapi
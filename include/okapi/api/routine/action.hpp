@@ -0,0 +1,183 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace okapi {
+/**
+ * One step of an autonomous routine. An Action is a small state machine which is advanced by
+ * repeated calls to tick() until it reports that it is done. It never blocks, so any number of
+ * actions can run concurrently from a single task (see RoutineScheduler). Actions are built and
+ * combined with the factories in Actions.
+ */
+class Action {
+  public:
+  enum class Status { running, done };
+
+  virtual ~Action() = default;
+
+  /**
+   * Advances the action. The first call starts it.
+   *
+   * @param inow The current time. Every action in one scheduler tick sees the same time.
+   * @return Whether the action is done.
+   */
+  Status tick(QTime inow);
+
+  /**
+   * Stops the action before it is done, for example because it lost a race or timed out. The
+   * action counts as done afterwards. Does nothing if the action is already done.
+   */
+  void cancel();
+
+  /**
+   * @return Whether the action has finished.
+   */
+  bool isDone() const;
+
+  protected:
+  /**
+   * Called once, right before the first call to step().
+   */
+  virtual void start(QTime inow);
+
+  /**
+   * Advances the action.
+   */
+  virtual Status step(QTime inow) = 0;
+
+  /**
+   * Called when the action is cancelled while running.
+   */
+  virtual void stop();
+
+  private:
+  bool started{false};
+  bool done{false};
+};
+
+using ActionPtr = std::unique_ptr<Action>;
+
+/**
+ * Factories for building routines out of actions.
+ *
+ * ```cpp
+ * scheduler.add(Actions::sequence(
+ *   Actions::call([&] { drive->moveDistanceAsync(24_in); }),
+ *   Actions::parallel(Actions::settled(drive), Actions::moveTo(lift, 600)),
+ *   Actions::timeout(Actions::waitUntil([&] { return intakeFull(); }), 2_s)));
+ * ```
+ */
+class Actions {
+  public:
+  /**
+   * Runs a function once and finishes immediately.
+   */
+  static ActionPtr call(std::function<void()> ifunction);
+
+  /**
+   * Calls istep every tick until it returns true. This is the escape hatch for custom logic.
+   */
+  static ActionPtr task(std::function<bool(QTime)> istep);
+
+  /**
+   * Finishes once itime has passed.
+   */
+  static ActionPtr waitFor(QTime itime);
+
+  /**
+   * Finishes once icondition returns true, which is checked every tick.
+   */
+  static ActionPtr waitUntil(std::function<bool()> icondition);
+
+  /**
+   * Finishes once icontroller has settled. Takes a pointer to anything with isSettled(), such as
+   * an AsyncPosPIDController or a ChassisController.
+   *
+   * A controller keeps reporting whether its last target was settled until its task next steps,
+   * so right after a new target is set it can still report settled. This action therefore only
+   * finishes once the controller has reported it is not settled, or iminTime has passed since the
+   * action started, whichever comes first. The default covers two steps of a controller running
+   * every 10 ms.
+   *
+   * @param iminTime How long to trust a settled report which was never preceded by an unsettled
+   * one.
+   */
+  template <typename ControllerPtr>
+  static ActionPtr settled(ControllerPtr icontroller, QTime iminTime = 20_ms) {
+    return task([icontroller, iminTime, startTime = 0_ms, started = false, sawUnsettled = false](
+                  const QTime inow) mutable {
+      if (!started) {
+        started = true;
+        startTime = inow;
+      }
+
+      if (!icontroller->isSettled()) {
+        sawUnsettled = true;
+        return false;
+      }
+      return sawUnsettled || inow - startTime >= iminTime;
+    });
+  }
+
+  /**
+   * Sets the target of icontroller when started and finishes once it has settled at it (see
+   * settled()). itarget is converted to the controller's input type by setTarget(), so
+   * `moveTo(lift, 600)` works for a controller of doubles.
+   */
+  template <typename ControllerPtr, typename Target>
+  static ActionPtr moveTo(ControllerPtr icontroller, Target itarget) {
+    return sequence(call([icontroller, itarget] { icontroller->setTarget(itarget); }),
+                    settled(icontroller));
+  }
+
+  /**
+   * Runs iaction, cancelling it if it has not finished after itimeout.
+   */
+  static ActionPtr timeout(ActionPtr iaction, QTime itimeout);
+
+  /**
+   * Runs the actions one after another. An action which finishes immediately lets the next one
+   * start in the same tick.
+   */
+  static ActionPtr sequence(std::vector<ActionPtr> iactions);
+
+  /**
+   * Runs the actions together and finishes once all of them have finished.
+   */
+  static ActionPtr parallel(std::vector<ActionPtr> iactions);
+
+  /**
+   * Runs the actions together, finishes once any of them finishes, and cancels the rest.
+   */
+  static ActionPtr race(std::vector<ActionPtr> iactions);
+
+  template <typename... Ts> static ActionPtr sequence(ActionPtr ifirst, Ts &&... irest) {
+    return sequence(collect(std::move(ifirst), std::forward<Ts>(irest)...));
+  }
+
+  template <typename... Ts> static ActionPtr parallel(ActionPtr ifirst, Ts &&... irest) {
+    return parallel(collect(std::move(ifirst), std::forward<Ts>(irest)...));
+  }
+
+  template <typename... Ts> static ActionPtr race(ActionPtr ifirst, Ts &&... irest) {
+    return race(collect(std::move(ifirst), std::forward<Ts>(irest)...));
+  }
+
+  protected:
+  template <typename... Ts> static std::vector<ActionPtr> collect(Ts &&... iactions) {
+    std::vector<ActionPtr> out;
+    out.reserve(sizeof...(Ts));
+    (out.push_back(std::forward<Ts>(iactions)), ...);
+    return out;
+  }
+};
+} // namespace okapi
@@ -0,0 +1,96 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/routine/action.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+class RoutineHandle {
+  public:
+  /**
+   * @return Whether the routine finished or was cancelled.
+   */
+  bool isDone() const;
+
+  /**
+   * Asks the scheduler to cancel the routine on its next tick.
+   */
+  void cancel();
+
+  protected:
+  friend class RoutineScheduler;
+  std::atomic_bool done{false};
+  std::atomic_bool cancelRequested{false};
+};
+
+class RoutineScheduler {
+  public:
+  /**
+   * Runs any number of routines from whichever task calls tick(). Each routine is an Action; every
+   * tick advances each running routine once, in the order they were added, with the same
+   * timestamp. A routine waiting on a controller or a sensor costs one small object instead of a
+   * task with its own stack.
+   *
+   * tick() can be called from a ControlExecutor step, or runUntilDone() can drive the scheduler
+   * from the current task.
+   *
+   * @param itimeUtil The TimeUtil used for timestamps and for the rate of runUntilDone().
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit RoutineScheduler(const TimeUtil &itimeUtil,
+                            std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Adds a routine. It starts on the next tick. This may be called from any task, including from
+   * inside a running action.
+   *
+   * @param iroutine The routine.
+   * @return A handle for checking on or cancelling the routine.
+   */
+  std::shared_ptr<RoutineHandle> add(ActionPtr iroutine);
+
+  /**
+   * Advances every running routine once.
+   */
+  void tick();
+
+  /**
+   * Ticks every iperiod until no routines are left. This blocks the current task.
+   *
+   * @param iperiod The time between ticks.
+   */
+  void runUntilDone(QTime iperiod = 10_ms);
+
+  /**
+   * @return The number of routines which have been added and have not finished.
+   */
+  std::size_t getNumRunning() const;
+
+  protected:
+  struct Entry {
+    ActionPtr routine;
+    std::shared_ptr<RoutineHandle> handle;
+  };
+
+  std::shared_ptr<Logger> logger;
+  TimeUtil timeUtil;
+  std::unique_ptr<AbstractTimer> timer;
+
+  // Only touched by the ticking task
+  std::vector<Entry> running;
+
+  // Routines added since the last tick
+  std::vector<Entry> pending;
+  mutable CrossplatformMutex pendingMutex;
+  std::atomic<std::size_t> numRunning{0};
+};
+} // namespace okapi
@@ -0,0 +1,199 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logFormat.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace okapi {
+/**
+ * One fixed-size log entry. A payload longer than one record continues in the records right after
+ * it, each of which but the last has continues set.
+ */
+struct LogRecord {
+  static constexpr std::size_t payloadSize = 55;
+
+  std::uint32_t time;     // us
+  std::uint16_t formatId; // A LogFormat id, or 0 if the payload is a line of text
+  std::uint8_t level;     // A Logger::LogLevel, or 0 for a line of text
+  std::uint8_t continues;
+  std::uint8_t size;      // Bytes of the payload in this record
+  std::uint8_t payload[payloadSize];
+};
+
+static_assert(sizeof(LogRecord) == 64, "A LogRecord should be exactly 64 bytes.");
+
+class AsyncLogSink {
+  public:
+  enum class Mode {
+    text,  ///< Write each message as a line of text, formatting LOG_*_F statements on the brain.
+    binary ///< Write the records as they are and leave the formatting to the host decoder.
+  };
+
+  /**
+   * A log destination which takes the formatting and the write off the calling task. Callers copy
+   * their message into fixed-size records in a ring buffer of their own, which takes no lock and
+   * never blocks: if the ring is full the message is dropped and counted instead. A low priority
+   * drain task formats the records and writes them to the file, so a blocking serial write no
+   * longer stalls control loops.
+   *
+   * Each task gets its ring the first time it logs, up to maxTasks tasks. Messages from one task
+   * stay in order; messages from different tasks are written a ring at a time.
+   *
+   * Log to it through an AsyncLogger, which the LOG_* and LOG_*_F macros write to like any other
+   * Logger:
+   *
+   * ```cpp
+   * auto sink = std::make_shared<AsyncLogSink>(
+   *   std::make_unique<MicroTimer>(), std::make_unique<Rate>(), fopen("/ser/sout", "w"));
+   * sink->startThread();
+   * Logger::setDefaultLogger(std::make_shared<AsyncLogger>(
+   *   TimeUtilFactory::createDefault(), sink, Logger::LogLevel::debug));
+   * ```
+   *
+   * @param itimer The timer to timestamp LOG_*_F messages and dropped counts with. Times are
+   * stored in microseconds, so a MicroTimer gives them microsecond resolution and a Timer only
+   * whole milliseconds.
+   * @param irate The rate the drain task runs at.
+   * @param ifile The file to write to. Will be closed by the sink!
+   * @param iringCapacity The number of records in each task's ring, rounded up to a power of two.
+   * @param idrainPeriod How often the drain task writes out what has been logged.
+   * @param imode Whether to write text or binary. Binary output is several times smaller and is
+   * turned back into text by sim/tools/logDecoder.cpp.
+   */
+  AsyncLogSink(std::unique_ptr<AbstractTimer> itimer,
+               std::unique_ptr<AbstractRate> irate,
+               FILE *ifile,
+               std::size_t iringCapacity = 64,
+               QTime idrainPeriod = 20_ms,
+               Mode imode = Mode::text);
+
+  AsyncLogSink(const AsyncLogSink &) = delete;
+  AsyncLogSink &operator=(const AsyncLogSink &) = delete;
+
+  virtual ~AsyncLogSink();
+
+  /**
+   * Copies a message into the calling task's ring and timestamps it. Safe to call from any task.
+   *
+   * @param ilevel The Logger::LogLevel of the message, or 0 for a line of text.
+   * @param iformatId The LogFormat id of the message, or 0 if ipayload is a line of text which is
+   * written as it is.
+   * @param ipayload The payload.
+   * @param isize The size of the payload in bytes.
+   * @return Whether the message fit. If it did not, it was counted as dropped.
+   */
+  bool append(std::uint8_t ilevel,
+              std::uint16_t iformatId,
+              const void *ipayload,
+              std::size_t isize) noexcept;
+
+  /**
+   * Formats and writes every complete message in every ring, then flushes the file. This is what
+   * the drain task runs each period; call it directly to flush, for example before the program
+   * exits.
+   */
+  void drain();
+
+  /**
+   * @return The number of messages dropped because a ring was full or no ring was free.
+   */
+  std::uint32_t getDropped() const;
+
+  /**
+   * Starts the drain task at the lowest priority above idle, so it only writes while every
+   * control task is waiting.
+   */
+  void startThread();
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  static constexpr std::size_t maxTasks = 16;
+
+  /**
+   * The binary output starts with binaryMagic and binaryVersion, followed by frames which each
+   * start with one of these bytes. All numbers are little endian.
+   *
+   * format: u16 id, u8 length, signature, u16 length, format
+   * task: u8 task, u8 length, name
+   * message: u8 task, u32 time (us), u8 level, u16 format id, u16 length, payload
+   * dropped: u8 task (255 if the task had no ring), u32 time (us), u32 count
+   *
+   * A format is written before the first message which uses it and a task's name before its first
+   * message. A message with format id 0 is a line of text, already formatted by the Logger.
+   */
+  enum class Frame : std::uint8_t { format = 'F', task = 'T', message = 'M', dropped = 'D' };
+
+  static constexpr std::uint8_t unownedTask = 255;
+  static constexpr char binaryMagic[] = "OKLG";
+  static constexpr std::uint8_t binaryVersion = 2;
+
+  protected:
+  struct Ring {
+    std::atomic<const void *> owner{nullptr};
+    std::atomic<bool> ready{false};
+    char name[32]{};
+    std::unique_ptr<LogRecord[]> records;
+
+    // head is only written by the owning task and tail only by the drain
+    std::atomic<std::uint32_t> head{0};
+    std::atomic<std::uint32_t> tail{0};
+    std::atomic<std::uint32_t> dropped{0};
+    std::uint32_t reportedDropped{0};
+    bool nameWritten{false};
+  };
+
+  std::unique_ptr<AbstractTimer> timer;
+  std::unique_ptr<AbstractRate> rate;
+  FILE *file;
+  const std::uint32_t capacity;
+  const QTime drainPeriod;
+  const Mode mode;
+  std::array<Ring, maxTasks> rings;
+  std::atomic<std::uint32_t> unownedDropped{0};
+  std::uint32_t reportedUnownedDropped{0};
+  std::string message;
+  std::string line;
+  std::uint16_t formatsWritten{0};
+  CrossplatformMutex drainMutex;
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * @return The calling task's ring, claiming a free one the first time, or nullptr if every ring
+   * belongs to another task.
+   */
+  Ring *findRing() noexcept;
+
+  void writeText(std::size_t iring, const LogRecord &ifirst);
+
+  void writeBinary(std::size_t iring, const LogRecord &ifirst);
+
+  void writeDropped(std::size_t iring, const char *itaskName, std::uint32_t icount);
+
+  /**
+   * @return The timer's time, rounded to the microsecond and truncated to 32 bits.
+   */
+  std::uint32_t now() const;
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
@@ -0,0 +1,163 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/asyncLogSink.hpp"
+#include "okapi/api/util/logFormat.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+
+// printf-style statements which store the arguments instead of building a string. See
+// AsyncLogger::logf.
+#define LOG_DEBUG_F(format, ...)                                                                   \
+  okapi::AsyncLogger::logf(                                                                        \
+    logger, okapi::Logger::LogLevel::debug, []() { return format; }, ##__VA_ARGS__)
+#define LOG_INFO_F(format, ...)                                                                    \
+  okapi::AsyncLogger::logf(                                                                        \
+    logger, okapi::Logger::LogLevel::info, []() { return format; }, ##__VA_ARGS__)
+#define LOG_WARN_F(format, ...)                                                                    \
+  okapi::AsyncLogger::logf(                                                                        \
+    logger, okapi::Logger::LogLevel::warn, []() { return format; }, ##__VA_ARGS__)
+#define LOG_ERROR_F(format, ...)                                                                   \
+  okapi::AsyncLogger::logf(                                                                        \
+    logger, okapi::Logger::LogLevel::error, []() { return format; }, ##__VA_ARGS__)
+
+namespace okapi {
+class AsyncLogger : public Logger {
+  public:
+  /**
+   * A Logger which writes to an AsyncLogSink, so log statements never block on the file. It is a
+   * Logger in every other way: install it with Logger::setDefaultLogger or pass it to a
+   * constructor, and the LOG_* macros write to it unchanged. Several loggers can share one sink.
+   *
+   * The Logger formats each LOG_* line itself and writes it to a stream whose writes are appended
+   * to the sink, so a line costs one copy into the calling task's ring. LOG_*_F statements skip
+   * the formatting and append their arguments instead.
+   *
+   * @param itimeUtil The timer timestamps LOG_* lines.
+   * @param isink The sink to append messages to.
+   * @param ilevel The log level. Log statements more verbose than this level will be disabled.
+   */
+  AsyncLogger(const TimeUtil &itimeUtil,
+              std::shared_ptr<AsyncLogSink> isink,
+              const LogLevel &ilevel);
+
+  AsyncLogger(const AsyncLogger &) = delete;
+  AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+  ~AsyncLogger();
+
+  /**
+   * @return The sink this logger appends to.
+   */
+  std::shared_ptr<AsyncLogSink> getSink() const;
+
+  /**
+   * Logs a printf-style message without formatting it. The format is given an id the first time
+   * the statement runs and only the arguments are stored, so nothing is allocated. If ilogger is
+   * an AsyncLogger, the arguments go to its sink and the drain task or the host decoder does the
+   * formatting; any other Logger gets the message formatted here, on the stack, cut to
+   * maxTextSize. Use it through LOG_DEBUG_F and the other LOG_*_F macros, which work in any class
+   * with a `logger`:
+   *
+   * ```cpp
+   * LOG_DEBUG_F("AsyncWrapper: Set target to %f", itarget);
+   * ```
+   *
+   * @param ilogger The logger to log to.
+   * @param ilevel The level of the message.
+   * @param iformat A captureless lambda returning the format string literal.
+   * @param iargs Numbers, bools, enums, or strings.
+   */
+  template <typename F, typename... Args>
+  static void logf(const std::shared_ptr<Logger> &ilogger,
+                   const LogLevel ilevel,
+                   F iformat,
+                   const Args &... iargs) noexcept {
+    if (!isEnabled(*ilogger, ilevel)) {
+      return;
+    }
+
+    using Signature = LogSignature<Args...>;
+
+    // Each statement's lambda is its own type, so this runs once per statement
+    static const std::uint16_t id = LogFormat::intern(iformat(), Signature::value);
+
+    std::uint8_t payload[LogFormat::maxPayload];
+    const std::size_t size = LogFormat::pack(payload, iargs...);
+
+    if (const AsyncLogger *async = find(ilogger.get()); async && id != 0) {
+      async->sink->append(static_cast<std::uint8_t>(ilevel), id, payload, size);
+      return;
+    }
+
+    char text[maxTextSize];
+    LogFormat::format(iformat(), Signature::value, payload, size, text, sizeof(text));
+    const auto message = [&]() { return Text{text}; };
+
+    switch (ilevel) {
+    case LogLevel::debug:
+      ilogger->debug(message);
+      break;
+    case LogLevel::info:
+      ilogger->info(message);
+      break;
+    case LogLevel::warn:
+      ilogger->warn(message);
+      break;
+    case LogLevel::error:
+      ilogger->error(message);
+      break;
+    default:
+      break;
+    }
+  }
+
+  /**
+   * The most AsyncLoggers which LOG_*_F statements recognize at once. LOG_*_F statements on an
+   * AsyncLogger made past this are formatted to text where they are logged.
+   */
+  static constexpr std::size_t maxLoggers = 8;
+
+  /**
+   * The longest LOG_*_F message, in characters, formatted for a Logger which is not an
+   * AsyncLogger. Longer ones are cut short.
+   */
+  static constexpr std::size_t maxTextSize = 256;
+
+  protected:
+  std::shared_ptr<AsyncLogSink> sink;
+
+  /**
+   * Text formatted on the stack, in the form Logger prints its messages in.
+   */
+  struct Text {
+    const char *text;
+
+    const char *c_str() const noexcept {
+      return text;
+    }
+  };
+
+  /**
+   * @return The AsyncLogger ilogger is, or nullptr if it is another Logger. Logger has no virtual
+   * functions to ask it with, so this looks ilogger up among the live AsyncLoggers.
+   */
+  static const AsyncLogger *find(const Logger *ilogger) noexcept;
+
+  static bool isEnabled(const Logger &ilogger, LogLevel ilevel) noexcept;
+
+  /**
+   * @return An unbuffered stream whose writes are appended to isink as lines of text, or nullptr
+   * if one could not be opened. The stream keeps the sink alive until the Logger closes it.
+   */
+  static FILE *openStream(const std::shared_ptr<AsyncLogSink> &isink);
+};
+} // namespace okapi
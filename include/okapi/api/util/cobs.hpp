@@ -0,0 +1,51 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace okapi {
+/**
+ * Consistent Overhead Byte Stuffing. An encoded frame contains no zero bytes, so frames sent back
+ * to back can be split on a zero byte, and a reader which starts in the middle of a stream finds
+ * the next frame after at most one bad one. Encoding adds one byte per 254 bytes, plus one.
+ */
+namespace cobs {
+/**
+ * @return The largest encoded size of isize bytes, not counting the zero delimiter.
+ */
+constexpr std::size_t maxEncodedSize(const std::size_t isize) {
+  return isize + isize / 254 + 1;
+}
+
+/**
+ * Encodes a frame. Does not write the zero delimiter.
+ *
+ * @param idata The bytes to encode.
+ * @param isize The number of bytes to encode.
+ * @param oout Where to write the encoded bytes, at least maxEncodedSize(isize) long.
+ * @return The number of bytes written.
+ */
+std::size_t encode(const std::uint8_t *idata, std::size_t isize, std::uint8_t *oout);
+
+/**
+ * Decodes a frame, without its zero delimiter.
+ *
+ * @param idata The encoded bytes.
+ * @param isize The number of encoded bytes.
+ * @param oout The decoded bytes. Replaced, not appended to.
+ * @return Whether the frame was valid.
+ */
+bool decode(const std::uint8_t *idata, std::size_t isize, std::vector<std::uint8_t> &oout);
+
+/**
+ * @return The CRC-16/CCITT-FALSE of the bytes, for checking a frame survived the link.
+ */
+std::uint16_t crc16(const std::uint8_t *idata, std::size_t isize);
+} // namespace cobs
+} // namespace okapi
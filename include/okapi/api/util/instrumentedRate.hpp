@@ -0,0 +1,70 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/loopTiming.hpp"
+#include <memory>
+
+namespace okapi {
+class InstrumentedRate : public AbstractRate {
+  public:
+  /**
+   * A rate which records the loop's timing in a LoopTiming around each delay. The iteration ends
+   * when a delay is called and the next one begins when it returns, so the loop needs no other
+   * changes. Anything which takes its rates from a TimeUtil can be timed by giving it a rate
+   * supplier which returns one of these:
+   *
+   * ```cpp
+   * auto timing = std::make_shared<LoopTiming>(std::make_unique<MicroTimer>(), "executor");
+   * TimeUtil timeUtil(
+   *   Supplier<std::unique_ptr<AbstractTimer>>([] { return std::make_unique<Timer>(); }),
+   *   Supplier<std::unique_ptr<AbstractRate>>(
+   *     [=] { return std::make_unique<InstrumentedRate>(std::make_unique<Rate>(), timing); }),
+   *   TimeUtilFactory::createDefault().getSettledUtilSupplier());
+   * ```
+   *
+   * Each loop should get its own LoopTiming, since only one task may record into one.
+   *
+   * @param irate The rate which does the delaying.
+   * @param itiming The timing to record into.
+   */
+  InstrumentedRate(std::unique_ptr<AbstractRate> irate, std::shared_ptr<LoopTiming> itiming);
+
+  /**
+   * Delay the current task such that it runs at the given frequency. The first delay will run for
+   * 1000/(ihz). Subsequent delays will adjust according to the previous runtime of the task.
+   *
+   * @param ihz the frequency
+   */
+  void delay(QFrequency ihz) override;
+
+  /**
+   * Delay the current task until itime has passed. This method can be used by periodic tasks to
+   * ensure a consistent execution frequency.
+   *
+   * @param itime the time period
+   */
+  void delayUntil(QTime itime) override;
+
+  /**
+   * Delay the current task until ims milliseconds have passed. This method can be used by
+   * periodic tasks to ensure a consistent execution frequency.
+   *
+   * @param ims the time period
+   */
+  void delayUntil(uint32_t ims) override;
+
+  /**
+   * @return The timing this rate records into.
+   */
+  std::shared_ptr<LoopTiming> getTiming() const;
+
+  protected:
+  std::unique_ptr<AbstractRate> rate;
+  std::shared_ptr<LoopTiming> timing;
+};
+} // namespace okapi
@@ -0,0 +1,190 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace okapi {
+/**
+ * How one argument of a formatted log statement is stored. The tag names the type in a format's
+ * signature; the argument itself is stored as its raw bytes, or for strings as a one byte length
+ * and the characters.
+ */
+template <typename T, typename = void> struct LogArg {
+  static_assert(sizeof(T) == 0,
+                "LOG_*_F arguments must be numbers, bools, enums, or strings. Convert units with "
+                "convert() first.");
+};
+
+template <> struct LogArg<bool> {
+  static constexpr char tag = 'b';
+  using Stored = std::uint8_t;
+};
+
+template <typename T>
+struct LogArg<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+  static constexpr char tag = std::is_signed_v<T> ? (sizeof(T) <= 4 ? 'i' : 'l')
+                                                  : (sizeof(T) <= 4 ? 'I' : 'L');
+  using Stored = std::conditional_t<
+    std::is_signed_v<T>,
+    std::conditional_t<sizeof(T) <= 4, std::int32_t, std::int64_t>,
+    std::conditional_t<sizeof(T) <= 4, std::uint32_t, std::uint64_t>>;
+};
+
+template <typename T> struct LogArg<T, std::enable_if_t<std::is_enum_v<T>>> {
+  static constexpr char tag = LogArg<std::underlying_type_t<T>>::tag;
+  using Stored = typename LogArg<std::underlying_type_t<T>>::Stored;
+};
+
+template <> struct LogArg<float> {
+  static constexpr char tag = 'f';
+  using Stored = float;
+};
+
+template <> struct LogArg<double> {
+  static constexpr char tag = 'd';
+  using Stored = double;
+};
+
+template <> struct LogArg<const char *> { static constexpr char tag = 's'; };
+template <> struct LogArg<char *> { static constexpr char tag = 's'; };
+template <std::size_t N> struct LogArg<char[N]> { static constexpr char tag = 's'; };
+template <> struct LogArg<std::string> { static constexpr char tag = 's'; };
+template <> struct LogArg<std::string_view> { static constexpr char tag = 's'; };
+
+/**
+ * The signature of a formatted log statement: the tag of each argument, in order.
+ */
+template <typename... Args> struct LogSignature {
+  static constexpr char value[] = {LogArg<std::decay_t<Args>>::tag..., '\0'};
+};
+
+class LogFormat {
+  public:
+  /**
+   * The most bytes of arguments one statement stores. Strings are cut short to fit.
+   */
+  static constexpr std::size_t maxPayload = 220;
+
+  /**
+   * The most distinct formats. Statements past this are formatted to text where they are logged.
+   */
+  static constexpr std::size_t maxFormats = 512;
+
+  struct Entry {
+    const char *format;
+    const char *signature;
+  };
+
+  /**
+   * Returns the id of a format, giving it the next free id the first time it is seen. Ids start
+   * at 1, since 0 marks a message which is already text. The LOG_*_F macros call this once per
+   * statement and keep the id.
+   *
+   * @param iformat The printf-style format. Must outlive the program, like a string literal.
+   * @param isignature The signature of the arguments.
+   * @return The id, or 0 if there are already maxFormats formats.
+   */
+  static std::uint16_t intern(const char *iformat, const char *isignature);
+
+  /**
+   * @param iid A format id.
+   * @return The format with that id, or nullptr if there is none.
+   */
+  static const Entry *find(std::uint16_t iid);
+
+  /**
+   * @return The number of formats interned so far. Their ids are 1 to this.
+   */
+  static std::uint16_t count();
+
+  /**
+   * Formats stored arguments. Each conversion in the format takes the next argument, converted to
+   * what the conversion expects, so "%d" with a double argument prints it truncated rather than
+   * garbage. Missing arguments print as "?".
+   *
+   * @param iformat The printf-style format.
+   * @param isignature The signature of the arguments.
+   * @param ipayload The stored arguments.
+   * @param isize The size of ipayload in bytes.
+   * @param oout The string to append the message to.
+   */
+  static void format(const char *iformat,
+                     const char *isignature,
+                     const std::uint8_t *ipayload,
+                     std::size_t isize,
+                     std::string &oout);
+
+  /**
+   * Formats stored arguments like the other format(), into a buffer instead of a string, so
+   * nothing is allocated. Like snprintf, a message too long for the buffer is cut short.
+   *
+   * @param iformat The printf-style format.
+   * @param isignature The signature of the arguments.
+   * @param ipayload The stored arguments.
+   * @param isize The size of ipayload in bytes.
+   * @param obuffer The buffer to write the nul terminated message to.
+   * @param icapacity The size of obuffer in bytes.
+   * @return The length of the whole message, which is icapacity or more if it was cut short.
+   */
+  static std::size_t format(const char *iformat,
+                            const char *isignature,
+                            const std::uint8_t *ipayload,
+                            std::size_t isize,
+                            char *obuffer,
+                            std::size_t icapacity) noexcept;
+
+  /**
+   * Stores arguments in the layout format() reads. Arguments past maxPayload bytes are left out.
+   *
+   * @param obuffer The buffer to write to, at least maxPayload bytes.
+   * @return The number of bytes written.
+   */
+  template <typename... Args>
+  static std::size_t pack([[maybe_unused]] std::uint8_t *obuffer, const Args &... iargs) noexcept {
+    std::size_t size = 0;
+    static_cast<void>((packOne(obuffer, size, iargs) && ...));
+    return size;
+  }
+
+  protected:
+  /**
+   * @return Whether the argument fit.
+   */
+  template <typename T>
+  static bool packOne(std::uint8_t *obuffer, std::size_t &iosize, const T &iarg) noexcept {
+    using Decayed = std::decay_t<T>;
+    if constexpr (LogArg<Decayed>::tag == 's') {
+      if (iosize >= maxPayload) {
+        return false;
+      }
+
+      const std::string_view text(iarg);
+      const std::size_t length =
+        std::min<std::size_t>({text.size(), 255, maxPayload - iosize - 1});
+      obuffer[iosize++] = static_cast<std::uint8_t>(length);
+      std::memcpy(obuffer + iosize, text.data(), length);
+      iosize += length;
+      return true;
+    } else {
+      using Stored = typename LogArg<Decayed>::Stored;
+      if (iosize + sizeof(Stored) > maxPayload) {
+        return false;
+      }
+
+      const auto value = static_cast<Stored>(iarg);
+      std::memcpy(obuffer + iosize, &value, sizeof(Stored));
+      iosize += sizeof(Stored);
+      return true;
+    }
+  }
+};
+} // namespace okapi
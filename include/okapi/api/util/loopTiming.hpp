@@ -0,0 +1,170 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace okapi {
+class LoopTiming {
+  public:
+  static constexpr std::size_t bucketsPerDoubling = 4;
+  static constexpr std::size_t numBuckets = 124;
+
+  /**
+   * Counts samples in microseconds in log-scale buckets: 0 to 3 us get a bucket each, and above
+   * that every doubling is split into four equal buckets, so a bucket is at most 25% wide. That is
+   * fine enough to tell a 10 ms loop running at 11 ms from one running at 13 ms.
+   */
+  struct Histogram {
+    std::array<std::uint32_t, numBuckets> buckets{};
+    std::uint32_t count{0};
+    std::uint32_t max{0};   ///< In microseconds
+    std::uint64_t total{0}; ///< In microseconds
+
+    /**
+     * @return The mean of the samples.
+     */
+    QTime mean() const;
+
+    /**
+     * @param ifraction The fraction of samples, from 0 to 1.
+     * @return The upper bound of the bucket holding that fraction of the samples, so at least
+     * ifraction of the samples are no longer than it.
+     */
+    QTime percentile(double ifraction) const;
+
+    /**
+     * @return The longest sample in bucket ibucket.
+     */
+    static QTime bucketUpperBound(std::size_t ibucket);
+
+    /**
+     * @return The bucket a sample of imicros microseconds goes in.
+     */
+    static std::size_t bucketOf(std::uint32_t imicros) noexcept;
+  };
+
+  struct Stats {
+    Histogram period;    ///< From the start of one iteration to the start of the next
+    Histogram execution; ///< From the start of an iteration to its delay
+    std::uint32_t overruns{0};
+  };
+
+  /**
+   * Measures how long each iteration of a periodic loop runs and how far apart iterations start,
+   * and counts the iterations which ran longer than their period. Recording a sample is a couple
+   * of timer reads, a count of leading zeros, a shift and a few stores, so it can stay on in
+   * competition.
+   *
+   * Call begin() at the top of each iteration and end() just before the loop delays, or wrap the
+   * loop's rate in an InstrumentedRate to do both. Only the loop's own task may call begin(), end()
+   * and stop(); getStats(), reset() and print() may be called from any task.
+   *
+   * ```cpp
+   * auto timing = std::make_shared<LoopTiming>(std::make_unique<MicroTimer>(), "drive");
+   * InstrumentedRate rate(std::make_unique<Rate>(), timing);
+   * while (true) {
+   *   step();
+   *   rate.delayUntil(10_ms);
+   * }
+   * // Elsewhere
+   * timing->print(stdout);
+   * ```
+   *
+   * @param itimer The timer to read. A MicroTimer gives microsecond resolution.
+   * @param iname The name print() shows.
+   */
+  explicit LoopTiming(std::unique_ptr<AbstractTimer> itimer, std::string iname = "loop");
+
+  LoopTiming(const LoopTiming &) = delete;
+  LoopTiming &operator=(const LoopTiming &) = delete;
+
+  virtual ~LoopTiming();
+
+  /**
+   * Marks the start of an iteration.
+   */
+  void begin();
+
+  /**
+   * Marks the end of an iteration's work.
+   *
+   * @param iperiod The period the loop is trying to keep. An iteration whose work took longer than
+   * this is counted as an overrun.
+   */
+  void end(QTime iperiod);
+
+  /**
+   * Marks that the loop has stopped, so the time until its next begin() is not counted as a
+   * period. Call this when a loop which runs more than once, such as a movement, finishes.
+   */
+  void stop();
+
+  /**
+   * Copies the histograms. The copy is taken field by field while the loop may be recording, so
+   * its counts can be off by the sample being recorded.
+   *
+   * @return The histograms and overrun count.
+   */
+  Stats getStats() const;
+
+  /**
+   * Clears the histograms and overrun count. Takes effect at the loop's next begin().
+   */
+  void reset();
+
+  /**
+   * Writes the stats as text, such as to stdout or a file on the SD card.
+   *
+   * @param ifile The file to write to.
+   */
+  void print(FILE *ifile) const;
+
+  /**
+   * @return The name given to the constructor.
+   */
+  const std::string &getName() const;
+
+  protected:
+  struct AtomicHistogram {
+    std::array<std::atomic<std::uint32_t>, numBuckets> buckets{};
+    std::atomic<std::uint32_t> count{0};
+    std::atomic<std::uint32_t> max{0};
+    std::atomic<std::uint64_t> total{0};
+
+    // Only one task records, so each field is read and written separately instead of with a
+    // read-modify-write, which would be a retry loop on the brain
+    void record(std::uint32_t imicros) noexcept;
+    Histogram load() const;
+    void clear() noexcept;
+  };
+
+  std::unique_ptr<AbstractTimer> timer;
+  const std::string name;
+
+  AtomicHistogram period;
+  AtomicHistogram execution;
+  std::atomic<std::uint32_t> overruns{0};
+  std::atomic_bool resetRequested{false};
+
+  std::uint32_t lastBegin{0};
+  bool started{false};
+
+  /**
+   * @return The timer's time in whole microseconds. Wraps after about 71 minutes, which the
+   * differences taken of it do not mind.
+   */
+  std::uint32_t now() const;
+};
+} // namespace okapi
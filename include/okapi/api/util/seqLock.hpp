@@ -0,0 +1,118 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace okapi {
+/**
+ * Publishes a value from one writer task to any number of reader tasks without locks. Readers
+ * never block the writer and never see a half-written value.
+ *
+ * The value is double buffered: each store writes the slot readers are not being pointed at, then
+ * bumps a sequence number. A reader only has to retry if the writer finishes a whole store and
+ * starts the next one while the reader is copying, which at control loop rates does not happen in
+ * practice.
+ *
+ * Only one task may call store() at a time.
+ *
+ * @tparam T The value type. It must be trivially copyable.
+ */
+template <typename T> class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type.");
+
+  public:
+  explicit SeqLock(const T &iinitial = T{}) {
+    writeSlot(0, iinitial);
+  }
+
+  SeqLock(const SeqLock &) = delete;
+  SeqLock &operator=(const SeqLock &) = delete;
+
+  /**
+   * Publishes a new value.
+   *
+   * @param ivalue The new value.
+   */
+  void store(const T &ivalue) {
+    // The sequence is odd while a store is in progress. Its upper bits count completed stores,
+    // which also selects the slot holding the latest value.
+    const std::uint32_t seq = sequence.load(std::memory_order_relaxed);
+    const std::uint32_t version = (seq >> 1) + 1;
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    writeSlot(version & 1, ivalue);
+    sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  /**
+   * @return The latest value.
+   */
+  T load() const {
+    std::uint32_t version;
+    return load(version);
+  }
+
+  /**
+   * Reads the latest value and its version. Compare the version with getVersion() later to tell
+   * whether a newer value was stored since.
+   *
+   * @param oversion Set to the version of the returned value.
+   * @return The latest value.
+   */
+  T load(std::uint32_t &oversion) const {
+    T out;
+    while (true) {
+      const std::uint32_t seq = sequence.load(std::memory_order_acquire);
+      const std::uint32_t version = seq >> 1;
+      readSlot(version & 1, out);
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      // The slot read is only overwritten once the store after the next one begins
+      if (sequence.load(std::memory_order_relaxed) - (version << 1) < 3) {
+        oversion = version;
+        return out;
+      }
+    }
+  }
+
+  /**
+   * @return The number of completed stores. It increases by one per store and wraps around.
+   */
+  std::uint32_t getVersion() const {
+    return sequence.load(std::memory_order_acquire) >> 1;
+  }
+
+  protected:
+  static constexpr std::size_t numWords =
+    (sizeof(T) + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+
+  // The slots are stored as relaxed atomic words so concurrent reads and writes are well defined
+  std::array<std::array<std::atomic<std::uint32_t>, numWords>, 2> slots{};
+  std::atomic<std::uint32_t> sequence{0};
+
+  void writeSlot(const std::size_t islot, const T &ivalue) {
+    std::array<std::uint32_t, numWords> words{};
+    std::memcpy(words.data(), &ivalue, sizeof(T));
+    for (std::size_t i = 0; i < numWords; i++) {
+      slots[islot][i].store(words[i], std::memory_order_relaxed);
+    }
+  }
+
+  void readSlot(const std::size_t islot, T &ovalue) const {
+    std::array<std::uint32_t, numWords> words;
+    for (std::size_t i = 0; i < numWords; i++) {
+      words[i] = slots[islot][i].load(std::memory_order_relaxed);
+    }
+    std::memcpy(static_cast<void *>(&ovalue), words.data(), sizeof(T));
+  }
+};
+} // namespace okapi
@@ -0,0 +1,162 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/telemetryOutput.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace okapi {
+class Telemetry {
+  public:
+  struct Stats {
+    std::uint32_t packetsSent{0};
+    std::uint32_t packetsDropped{0}; ///< Sample packets left out to stay within the budget
+    std::uint32_t bytesSent{0};
+  };
+
+  /**
+   * Streams signals to a host as binary packets. Control code registers its signals once and then
+   * calls set() with each new value, which is a single atomic store. A task samples the latest
+   * values every period and writes them out, so the control loop never formats or writes
+   * anything. sim/tools/telemetryDecoder.cpp turns the stream into CSV.
+   *
+   * Each packet is checked with a CRC-16 and COBS framed (see okapi/api/util/cobs.hpp). A
+   * signal's decimation sends it every that many periods. If a period's packet would go over the
+   * bandwidth budget it is dropped and counted, and the next one is sent as usual. The list of
+   * signals is sent again every second so a decoder started late can still decode the stream.
+   *
+   * ```cpp
+   * auto telemetry = std::make_shared<Telemetry>(
+   *   TimeUtilFactory::createDefault(),
+   *   std::make_unique<FileTelemetryOutput>(fopen("/ser/serr", "wb")));
+   * const auto x = telemetry->addSignal("x");
+   * telemetry->startThread();
+   * // In the control loop
+   * telemetry->set(x, gpsData.x);
+   * ```
+   *
+   * The packets are, before framing, with all numbers little endian:
+   *
+   * signal: 'N', u8 id, u16 decimation, u8 length, name
+   * sample: 'S', u32 time (us), u8 count, count times (u8 id, f32 value)
+   *
+   * each followed by the CRC-16 of the packet, then COBS encoded with a zero byte either side.
+   *
+   * @param itimeUtil The TimeUtil used for the sample rate and timestamps.
+   * @param ioutput The link to write to.
+   * @param ibytesPerSecond The bandwidth budget, including framing.
+   * @param iperiod The time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  Telemetry(const TimeUtil &itimeUtil,
+            std::unique_ptr<TelemetryOutput> ioutput,
+            std::uint32_t ibytesPerSecond = 10000,
+            QTime iperiod = 10_ms,
+            std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  Telemetry(const Telemetry &) = delete;
+  Telemetry &operator=(const Telemetry &) = delete;
+
+  virtual ~Telemetry();
+
+  /**
+   * Registers a signal. Warns if the signals registered so far need more than the budget.
+   *
+   * @param iname The name of the signal, which becomes its CSV column.
+   * @param idecimation Send the signal every this many periods.
+   * @return The id to pass to set().
+   */
+  std::uint8_t addSignal(const std::string &iname, std::uint16_t idecimation = 1);
+
+  /**
+   * Sets the latest value of a signal. Safe to call from any task.
+   *
+   * @param isignal The id from addSignal().
+   * @param ivalue The value.
+   */
+  void set(std::uint8_t isignal, double ivalue) noexcept;
+
+  /**
+   * Samples the signals and writes a packet if any are due. This is what the task runs each
+   * period.
+   */
+  void tick();
+
+  /**
+   * @return How many packets and bytes have been sent and dropped.
+   */
+  Stats getStats() const;
+
+  /**
+   * Starts the sampling task at a low priority.
+   */
+  void startThread();
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  static constexpr std::size_t maxSignals = 64;
+
+  protected:
+  struct Signal {
+    std::string name;
+    std::uint16_t decimation;
+  };
+
+  std::shared_ptr<Logger> logger;
+  TimeUtil timeUtil;
+  std::unique_ptr<AbstractTimer> timer;
+  std::unique_ptr<TelemetryOutput> output;
+  const std::uint32_t bytesPerSecond;
+  const QTime period;
+
+  mutable CrossplatformMutex mutex;
+  std::vector<Signal> signals;
+  std::array<std::atomic<float>, maxSignals> values{};
+  std::atomic<std::size_t> signalCount{0};
+
+  std::uint32_t tickCount{0};
+  double budget{0}; // Bytes which can be sent now
+  QTime lastTick{0_ms};
+  QTime lastSchema{0_ms};
+  bool schemaSent{false};
+  Stats stats;
+
+  std::vector<std::uint8_t> packet;
+  std::vector<std::uint8_t> frame;
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * @return The bytes the link needs for one packet of isize bytes.
+   */
+  static std::size_t frameSize(std::size_t isize);
+
+  /**
+   * Frames the packet and writes it.
+   */
+  void send();
+
+  void sendSchema();
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
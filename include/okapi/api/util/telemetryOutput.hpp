@@ -0,0 +1,45 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace okapi {
+class TelemetryOutput {
+  public:
+  virtual ~TelemetryOutput();
+
+  /**
+   * Writes bytes to the link. Called from the Telemetry task only.
+   *
+   * @param idata The bytes to write.
+   * @param isize The number of bytes.
+   */
+  virtual void write(const std::uint8_t *idata, std::size_t isize) = 0;
+};
+
+class FileTelemetryOutput : public TelemetryOutput {
+  public:
+  /**
+   * Writes telemetry to a file, such as /ser/serr or a file on the SD card. Over USB, PROS wraps
+   * everything written to /ser/sout and /ser/serr in frames of its own naming the stream, so
+   * telemetry on /ser/serr is kept apart from text printed to stdout. The decoder only reads the
+   * stream it is told to, and skips anything else printed to it.
+   *
+   * @param ifile The file to write to. Will be closed by the output!
+   */
+  explicit FileTelemetryOutput(FILE *ifile);
+
+  ~FileTelemetryOutput() override;
+
+  void write(const std::uint8_t *idata, std::size_t isize) override;
+
+  protected:
+  FILE *file;
+};
+} // namespace okapi
@@ -0,0 +1,265 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logFormat.hpp"
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+#define OKAPI_TRACE_CONCAT_INNER(a, b) a##b
+#define OKAPI_TRACE_CONCAT(a, b) OKAPI_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * Records a span named by a string literal from here to the end of the enclosing scope, on the
+ * default Tracer. Does nothing but check a pointer if no default Tracer is set.
+ */
+#define TRACE_SPAN(name)                                                                           \
+  okapi::TraceSpan OKAPI_TRACE_CONCAT(okapiTraceSpan, __LINE__)([]() { return name; })
+
+namespace okapi {
+/**
+ * One fixed-size trace entry.
+ */
+struct TraceEvent {
+  std::uint32_t time; // us
+  std::uint16_t name; // A LogFormat id
+  char phase;         // A Tracer::Phase
+  std::uint8_t reserved;
+};
+
+static_assert(sizeof(TraceEvent) == 8, "A TraceEvent should be exactly 8 bytes.");
+
+class Tracer {
+  public:
+  enum class Mode {
+    json,  ///< Write Chrome trace events as they are drained.
+    binary ///< Write the events as they are and leave the JSON to sim/tools/traceExport.cpp.
+  };
+
+  /**
+   * The phases of the trace-event format which are recorded.
+   */
+  enum class Phase : char { begin = 'B', end = 'E', instant = 'i' };
+
+  /**
+   * Records named spans from any number of tasks so they can be looked at together on a timeline,
+   * to see which task preempts which, how long a task waits on a mutex, and where nothing runs.
+   * Each task records into a ring of its own without taking a lock, the same way AsyncLogSink
+   * does, and a low priority task drains the rings to the file. If a ring is full the event is
+   * dropped and counted. A span's begin is only recorded if there is also room for its end, so a
+   * full ring drops whole spans and never leaves one open.
+   *
+   * The output loads into chrome://tracing or https://ui.perfetto.dev, with one track per task.
+   * JSON mode writes the trace-event JSON directly, which suits the simulator. On the brain, binary
+   * mode to a file on the SD card is several times smaller; convert it on a computer with
+   * sim/tools/traceExport.cpp. Neither needs the file closed properly, so a dump from a brain which
+   * lost power still loads.
+   *
+   * Spans are recorded with TRACE_SPAN on the default Tracer:
+   *
+   * ```cpp
+   * auto tracer = std::make_shared<Tracer>(std::make_unique<MicroTimer>(),
+   *                                        std::make_unique<Rate>(),
+   *                                        fopen("/usd/trace.bin", "wb"));
+   * tracer->startThread();
+   * Tracer::setDefault(tracer);
+   * // Anywhere
+   * {
+   *   TRACE_SPAN("odom step");
+   *   odom->step();
+   * }
+   * ```
+   *
+   * @param itimer The timer to timestamp events with. A MicroTimer gives microsecond resolution.
+   * @param irate The rate the drain task runs at.
+   * @param ifile The file to write to. Will be closed by the tracer!
+   * @param iringCapacity The number of events in each task's ring, rounded up to a power of two.
+   * @param idrainPeriod How often the drain task writes out what has been recorded.
+   * @param imode Whether to write JSON or binary.
+   */
+  Tracer(std::unique_ptr<AbstractTimer> itimer,
+         std::unique_ptr<AbstractRate> irate,
+         FILE *ifile,
+         std::size_t iringCapacity = 256,
+         QTime idrainPeriod = 50_ms,
+         Mode imode = Mode::binary);
+
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+
+  virtual ~Tracer();
+
+  /**
+   * Gives a name an id to record it with. Names are shared with the LOG_*_F format table, so
+   * interning the same name twice gives the same id.
+   *
+   * @param iname The name. It must outlive the tracer, so it is usually a string literal.
+   * @return The id, or 0 if the table is full.
+   */
+  static std::uint16_t intern(const char *iname);
+
+  /**
+   * Copies an event into the calling task's ring. Safe to call from any task. A begin reserves
+   * room for its end, so record an end only for a begin which returned true, in the same task.
+   *
+   * @param iphase The phase of the event.
+   * @param iname The id from intern(). Events with id 0 are not recorded.
+   * @return Whether the event fit. If it did not, it was counted as dropped.
+   */
+  bool record(Phase iphase, std::uint16_t iname) noexcept;
+
+  /**
+   * Writes every event in every ring, then flushes the file. This is what the drain task runs
+   * each period; call it directly to flush, for example before the program exits.
+   */
+  void drain();
+
+  /**
+   * @return The number of events dropped because a ring was full or no ring was free.
+   */
+  std::uint32_t getDropped() const;
+
+  /**
+   * Starts the drain task at the lowest priority above idle, so it only writes while every
+   * control task is waiting.
+   */
+  void startThread();
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  /**
+   * @return The tracer TRACE_SPAN records on, or nullptr if there is none.
+   */
+  static Tracer *getDefault() noexcept;
+
+  /**
+   * Sets the tracer TRACE_SPAN records on. Set it before starting the tasks which trace, and do
+   * not change it while they run: a span which began on one tracer ends on the same one.
+   *
+   * @param itracer The tracer, or nullptr to stop tracing.
+   */
+  static void setDefault(std::shared_ptr<Tracer> itracer);
+
+  static constexpr std::size_t maxTasks = 16;
+
+  /**
+   * The binary output starts with binaryMagic and binaryVersion, followed by frames which each
+   * start with one of these bytes. All numbers are little endian.
+   *
+   * name: u16 id, u8 length, name
+   * task: u8 task, u8 length, name
+   * event: u8 task, u32 time (us), u8 phase, u16 name id
+   * dropped: u8 task (255 if the task had no ring), u32 time (us), u32 count
+   *
+   * A name is written before the first event which uses it and a task's name before its first
+   * event.
+   */
+  enum class Frame : std::uint8_t { name = 'N', task = 'T', event = 'E', dropped = 'D' };
+
+  static constexpr std::uint8_t unownedTask = 255;
+  static constexpr char binaryMagic[] = "OKTR";
+  static constexpr std::uint8_t binaryVersion = 1;
+
+  protected:
+  struct Ring {
+    std::atomic<const void *> owner{nullptr};
+    std::atomic<bool> ready{false};
+    char name[32]{};
+    std::unique_ptr<TraceEvent[]> events;
+
+    // head is only written by the owning task and tail only by the drain
+    std::atomic<std::uint32_t> head{0};
+    std::atomic<std::uint32_t> tail{0};
+    std::atomic<std::uint32_t> dropped{0};
+    std::uint32_t openSpans{0}; // Begins whose end has a slot reserved. Only used by the owner.
+    std::uint32_t reportedDropped{0};
+    bool nameWritten{false};
+    std::uint64_t lastTime{0}; // The last event's time with the wraps of the u32 added back
+  };
+
+  std::unique_ptr<AbstractTimer> timer;
+  std::unique_ptr<AbstractRate> rate;
+  FILE *file;
+  const std::uint32_t capacity;
+  const QTime drainPeriod;
+  const Mode mode;
+  std::array<Ring, maxTasks> rings;
+  std::atomic<std::uint32_t> unownedDropped{0};
+  std::uint32_t reportedUnownedDropped{0};
+  std::bitset<LogFormat::maxFormats + 1> namesWritten;
+  CrossplatformMutex drainMutex;
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * @return The calling task's ring, claiming a free one the first time, or nullptr if every ring
+   * belongs to another task.
+   */
+  Ring *findRing() noexcept;
+
+  /**
+   * @return The time now (us), truncated to 32 bits.
+   */
+  std::uint32_t now() const;
+
+  void writeEvent(std::size_t iring, const TraceEvent &ievent);
+
+  void writeDropped(std::size_t iring, const char *itaskName, std::uint32_t icount);
+
+  void writeJsonString(const char *itext);
+
+  static void trampoline(void *context);
+  void loop();
+};
+
+class TraceSpan {
+  public:
+  /**
+   * Records the begin event of a span now and the end event when destroyed, on the default
+   * Tracer. Use TRACE_SPAN rather than this directly.
+   *
+   * @param iname Returns the name. Only called the first time, to intern it.
+   */
+  template <typename F> explicit TraceSpan(F iname) noexcept : tracer(Tracer::getDefault()) {
+    if (tracer) {
+      // Every TRACE_SPAN has its own lambda type, so each interns its name once
+      static const std::uint16_t id = Tracer::intern(iname());
+      if (tracer->record(Tracer::Phase::begin, id)) {
+        name = id;
+      }
+    }
+  }
+
+  /**
+   * Records a span with a name interned already.
+   *
+   * @param iname The id from Tracer::intern().
+   */
+  explicit TraceSpan(std::uint16_t iname) noexcept;
+
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+  ~TraceSpan();
+
+  protected:
+  Tracer *tracer;
+  std::uint16_t name{0};
+};
+} // namespace okapi
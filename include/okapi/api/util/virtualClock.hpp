@@ -0,0 +1,250 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#ifdef THREADS_STD
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace okapi {
+class VirtualClock {
+  public:
+  /**
+   * A simulated clock for running okapi code faster than real time. Timers made by this clock read
+   * it instead of the system clock, and rates made by it advance it instead of sleeping.
+   *
+   * Under THREADS_STD, the thread which creates the clock and every thread started with
+   * startThread() or which calls attach() are participants. Participants run one at a time: when
+   * the running participant waits, the clock jumps straight to the earliest wake time and resumes
+   * whoever asked for it, breaking ties in the order the waits were made. A simulation of several
+   * controller threads therefore runs as fast as the host allows and takes the same steps every
+   * time. Threads which never wait on the clock are not affected by it. A participant must not
+   * block on anything except this clock while other participants need to run, or the simulation
+   * stops; call detachCurrentThread() first.
+   *
+   * A thread only counts once it is a participant, so the clock can move on without a thread
+   * which has been started but has not attached yet. startThread() attaches the new thread before
+   * it returns, so threads started with it before runFor() all begin at the same simulated time.
+   * A thread started some other way, such as the one in an AsyncWrapper, attaches on its first
+   * wait. Call expectThreads() before starting it so the clock waits for that first wait; without
+   * it, runs which use such threads are not guaranteed to repeat. Until its first wait, the new
+   * thread runs alongside the one which started it, so let it get there with runFor(0_ms) before
+   * changing anything it reads.
+   *
+   * Without THREADS_STD there is a single participant, and waiting just advances the clock.
+   *
+   * The clock must outlive every timer, rate and participant thread using it, and must be destroyed
+   * by the thread which created it.
+   *
+   * ```cpp
+   * VirtualClock clock;
+   * clock.expectThreads(1); // The controller's task
+   * auto controller = AsyncPosControllerBuilder()...withTimeUtil(clock.createTimeUtil()).build();
+   * clock.runFor(0_ms); // Until the controller's task has taken its first step
+   * controller->setTarget(100);
+   * clock.runFor(2_s); // Returns as soon as 2 simulated seconds have passed
+   * clock.detachCurrentThread(); // So the controller's task can run until it is stopped
+   * ```
+   *
+   * @param istart The starting time.
+   */
+  explicit VirtualClock(QTime istart = 0_ms);
+
+  virtual ~VirtualClock();
+
+  VirtualClock(const VirtualClock &) = delete;
+  VirtualClock &operator=(const VirtualClock &) = delete;
+
+  /**
+   * @return The current simulated time.
+   */
+  QTime now() const;
+
+  /**
+   * Moves the clock forward without waiting for anyone. This is for code which steps a
+   * simulation by hand and must not be used while other threads participate.
+   *
+   * @param idt How far to move the clock.
+   */
+  void advance(QTime idt);
+
+  /**
+   * Blocks the current thread until the clock reaches iwakeTime, letting the other participants
+   * run in the meantime. Returns immediately if iwakeTime has passed.
+   *
+   * @param iwakeTime The time to wake at.
+   */
+  void sleepUntil(QTime iwakeTime);
+
+  /**
+   * Lets the simulation run for iduration of simulated time. The calling thread participates.
+   *
+   * @param iduration How long to run for.
+   */
+  void runFor(QTime iduration);
+
+  /**
+   * Makes the current thread a participant, so the clock waits for it from now on. Call it before
+   * the thread which started this one next waits on the clock, or use startThread(), which does.
+   */
+  void attach();
+
+  /**
+   * Makes the current thread a participant, and counts icount threads which have not attached yet
+   * as participants too, so the clock waits for them. The next icount threads to attach take
+   * their places. Each must wait on the clock soon after it starts, or the simulation stops.
+   *
+   * @param icount How many threads are about to be started.
+   */
+  void expectThreads(std::size_t icount);
+
+  /**
+   * Stops the current thread from participating, so the other participants keep running while it
+   * blocks on something else (such as waitUntilSettled()). It participates again the next time it
+   * waits on the clock. Threads detach automatically when they exit.
+   */
+  void detachCurrentThread();
+
+#ifdef THREADS_STD
+  /**
+   * Starts a thread which participates from the start. The calling thread becomes a participant
+   * if it was not one and waits until the new thread has attached, the same way the simulator's
+   * task_create() does, so the new thread cannot be missed by the clock. The new thread then runs
+   * ifunction when the clock schedules it. Call detachCurrentThread() before joining it.
+   *
+   * @param ifunction The function to run.
+   * @return The thread.
+   */
+  std::thread startThread(std::function<void()> ifunction);
+#endif
+
+  /**
+   * @return A timer which reads this clock.
+   */
+  std::unique_ptr<AbstractTimer> createTimer();
+
+  /**
+   * @return A rate which waits on this clock.
+   */
+  std::unique_ptr<AbstractRate> createRate();
+
+  /**
+   * Makes a TimeUtil whose timers and rates all use this clock.
+   *
+   * @param iatTargetError The SettledUtil error threshold.
+   * @param iatTargetDerivative The SettledUtil derivative threshold.
+   * @param iatTargetTime The SettledUtil time threshold.
+   * @return The TimeUtil.
+   */
+  TimeUtil createTimeUtil(double iatTargetError = 50,
+                          double iatTargetDerivative = 5,
+                          QTime iatTargetTime = 250_ms);
+
+  protected:
+  // Seconds, so it can be read without locking
+  std::atomic<double> time;
+
+#ifdef THREADS_STD
+  struct Sleeper {
+    double wakeTime;
+    std::uint64_t order;
+    std::thread::id id;
+  };
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::vector<Sleeper> sleepers;
+  std::uint64_t nextOrder{0};
+  std::size_t numParticipants{0};
+  // Threads counted in numParticipants which have not attached yet
+  std::size_t numExpected{0};
+  std::thread::id resumed;
+
+  /**
+   * Resumes the participant with the earliest wake time if no participant is running. Must be
+   * called with the mutex held.
+   */
+  void dispatch();
+
+  /**
+   * Makes the current thread a participant if it is not one. Must be called with the mutex held.
+   */
+  void attachLocked();
+
+  void detach(std::thread::id iid);
+
+  friend struct VirtualClockParticipation;
+#endif
+};
+
+class VirtualTimer : public AbstractTimer {
+  public:
+  /**
+   * A Timer which reads a VirtualClock.
+   *
+   * @param iclock The clock.
+   */
+  explicit VirtualTimer(const VirtualClock &iclock);
+
+  /**
+   * Returns the current simulated time.
+   *
+   * @return the current time
+   */
+  QTime millis() const override;
+
+  protected:
+  const VirtualClock &clock;
+};
+
+class VirtualRate : public AbstractRate {
+  public:
+  /**
+   * A Rate which waits on a VirtualClock. Like Rate, each delay is measured from the end of the
+   * previous one, so a loop keeps a fixed period regardless of how long its body takes.
+   *
+   * @param iclock The clock.
+   */
+  explicit VirtualRate(VirtualClock &iclock);
+
+  /**
+   * Delay the current task such that it runs at the given frequency.
+   *
+   * @param ihz the frequency
+   */
+  void delay(QFrequency ihz) override;
+
+  /**
+   * Delay the current task until itime has passed since the end of the last delay.
+   *
+   * @param itime the time period
+   */
+  void delayUntil(QTime itime) override;
+
+  /**
+   * Delay the current task until ims milliseconds have passed since the end of the last delay.
+   *
+   * @param ims the time period
+   */
+  void delayUntil(uint32_t ims) override;
+
+  protected:
+  VirtualClock &clock;
+  QTime lastTime;
+};
+} // namespace okapi
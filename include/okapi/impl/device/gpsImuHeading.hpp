@@ -0,0 +1,111 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "api.h"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/odometry/headingFusion.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+#include <atomic>
+#include <memory>
+
+namespace okapi {
+class GpsImuHeading {
+  public:
+  /**
+   * Fuses the GPS yaw with the IMU rotation in a background task (see HeadingFusion). The latest
+   * estimate is cached, so reading it never waits on either device. The GPS yaw is ignored while
+   * the GPS reports more than `imaxGpsError` meters of error, such as when it cannot see the field
+   * strip, and the estimate follows the IMU alone until the GPS recovers.
+   *
+   * ```cpp
+   * auto heading = std::make_shared<GpsImuHeading>(pros::Gps(9), pros::Imu(10));
+   * heading->startThread();
+   * double yaw = heading->getWrappedHeading().convert(degree);
+   * ```
+   *
+   * @param igps The GPS sensor.
+   * @param iimu The IMU.
+   * @param itimeConstant How long the GPS takes to correct about 63% of the IMU drift.
+   * @param imaxGpsError GPS readings with more error than this (in meters) are ignored.
+   * @param itimeUtil The TimeUtil used for the rate of the background task.
+   * @param ilogger The logger this instance will log to.
+   */
+  GpsImuHeading(const pros::Gps &igps,
+                const pros::Imu &iimu,
+                QTime itimeConstant = 1_s,
+                double imaxGpsError = 0.05,
+                const TimeUtil &itimeUtil = TimeUtilFactory::createDefault(),
+                std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  GpsImuHeading(const GpsImuHeading &) = delete;
+  GpsImuHeading(GpsImuHeading &&other) = delete;
+  GpsImuHeading &operator=(const GpsImuHeading &other) = delete;
+  GpsImuHeading &operator=(GpsImuHeading &&other) = delete;
+
+  virtual ~GpsImuHeading();
+
+  /**
+   * @return The latest heading estimate. It is continuous, so it is not wrapped into any range.
+   */
+  virtual QAngle getHeading() const;
+
+  /**
+   * @return The latest heading estimate constrained to [-180, 180) degrees, which matches the
+   * range of the GPS yaw.
+   */
+  virtual QAngle getWrappedHeading() const;
+
+  /**
+   * @return The latest angular rate from the IMU gyro.
+   */
+  virtual QAngularSpeed getRate() const;
+
+  /**
+   * @return Whether the GPS was used in the latest estimate.
+   */
+  virtual bool isGpsValid() const;
+
+  /**
+   * Sets the period of the background task. The default is 10 ms.
+   *
+   * @param isampleTime The new period.
+   */
+  virtual void setSampleTime(QTime isampleTime);
+
+  /**
+   * Starts the internal thread. This should be called once after construction.
+   */
+  void startThread();
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  pros::Gps gps;
+  pros::Imu imu;
+  TimeUtil timeUtil;
+  HeadingFusion fusion;
+  std::atomic<double> sampleTimeMs{10};
+
+  // The latest estimate, published for readers on other tasks
+  std::atomic<double> headingDeg{0};
+  std::atomic<double> rateDegPerSec{0};
+  std::atomic_bool gpsValid{false};
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
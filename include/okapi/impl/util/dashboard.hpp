@@ -0,0 +1,129 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace okapi {
+class Dashboard {
+  public:
+  /**
+   * Shows values on the brain screen, one field per line, without drawing from the control loop.
+   * The control loop calls set(), which only stores the value and marks the field changed. A low
+   * priority task redraws every period, and only the lines whose text changed, so a value which
+   * holds still is neither formatted nor drawn again.
+   *
+   * ```cpp
+   * auto dashboard = std::make_shared<Dashboard>(TimeUtilFactory::createDefault());
+   * const auto x = dashboard->addField("X Position");
+   * dashboard->startThread();
+   * // In the control loop
+   * dashboard->set(x, gpsData.x);
+   * ```
+   *
+   * @param itimeUtil The TimeUtil used for the refresh rate.
+   * @param iperiod The time between redraws. The screen only updates so fast, so there is no
+   * point going much below 50 ms.
+   * @param ifirstLine The screen line of the first field.
+   * @param ilogger The logger this instance will log to.
+   */
+  Dashboard(const TimeUtil &itimeUtil,
+            QTime iperiod = 100_ms,
+            std::int16_t ifirstLine = 1,
+            std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  Dashboard(const Dashboard &) = delete;
+  Dashboard &operator=(const Dashboard &) = delete;
+
+  virtual ~Dashboard();
+
+  /**
+   * Adds a line showing a number.
+   *
+   * @param ilabel The text before the value.
+   * @param iformat The printf format of the value.
+   * @return The id to pass to set().
+   */
+  std::size_t addField(const std::string &ilabel, const std::string &iformat = "%.3f");
+
+  /**
+   * Adds a line whose text is computed on the dashboard task every period, for values which take
+   * work to describe. The line is still only drawn when the text changes.
+   *
+   * @param ilabel The text before the value.
+   * @param itext Returns the value's text. Called from the dashboard task.
+   * @return The id of the field.
+   */
+  std::size_t addTextField(const std::string &ilabel, std::function<std::string()> itext);
+
+  /**
+   * Sets a number field's value. Safe to call from any task.
+   *
+   * @param ifield The id from addField().
+   * @param ivalue The value.
+   */
+  void set(std::size_t ifield, double ivalue) noexcept;
+
+  /**
+   * Redraws the fields which changed. This is what the task runs each period.
+   */
+  void render();
+
+  /**
+   * Starts the redraw task at a low priority.
+   */
+  void startThread();
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  static constexpr std::size_t maxFields = 12;
+
+  protected:
+  struct Field {
+    std::string label;
+    std::string format;
+    std::function<std::string()> text;
+
+    std::atomic<double> value{0};
+    std::atomic<bool> dirty{true};
+    std::string drawn; // The text on the screen now
+  };
+
+  std::shared_ptr<Logger> logger;
+  TimeUtil timeUtil;
+  const QTime period;
+  const std::int16_t firstLine;
+
+  CrossplatformMutex mutex;
+  std::array<Field, maxFields> fields;
+  std::atomic<std::size_t> fieldCount{0};
+  std::string line;
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  std::size_t add(const std::string &ilabel,
+                  const std::string &iformat,
+                  std::function<std::string()> itext);
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
@@ -0,0 +1,26 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/abstractTimer.hpp"
+
+namespace okapi {
+class MicroTimer : public AbstractTimer {
+  public:
+  /**
+   * A Timer which reads the microsecond clock instead of the millisecond clock. Use this when
+   * timing things which take less than a millisecond, such as one pass of a control loop.
+   */
+  MicroTimer();
+
+  /**
+   * Returns the current time in units of QTime, with microsecond resolution.
+   *
+   * @return the current time
+   */
+  QTime millis() const override;
+};
+} // namespace okapi
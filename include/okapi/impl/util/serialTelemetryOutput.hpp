@@ -0,0 +1,29 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/telemetryOutput.hpp"
+#include "pros/serial.hpp"
+
+namespace okapi {
+class SerialTelemetryOutput : public TelemetryOutput {
+  public:
+  /**
+   * Writes telemetry to a smart port set up as a generic serial port, for example to a radio or a
+   * USB-serial adapter. At the default 115200 baud the link carries about 11500 bytes/s, so pass
+   * Telemetry a budget below that.
+   *
+   * @param iport The smart port number.
+   * @param ibaudrate The baudrate to run the port at.
+   */
+  explicit SerialTelemetryOutput(std::uint8_t iport, std::int32_t ibaudrate = 115200);
+
+  void write(const std::uint8_t *idata, std::size_t isize) override;
+
+  protected:
+  pros::Serial serial;
+};
+} // namespace okapi
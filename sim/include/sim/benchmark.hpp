@@ -0,0 +1,148 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "sim/config.hpp"
+#include "sim/simulator.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sim {
+/**
+ * A pose on the field in the GPS convention: meters, and degrees clockwise from +y.
+ */
+struct Waypoint {
+  double x;
+  double y;
+  double heading;
+};
+
+/**
+ * One entry of the benchmark catalogue: where the robot starts, the waypoints it must reach in
+ * order, and optionally a push partway through.
+ */
+struct Scenario {
+  std::string name;
+  Waypoint start;
+  std::vector<Waypoint> waypoints;
+
+  std::uint32_t pushTime{0}; // ms after the start, or 0 for no push
+  double pushX{0};           // N*s along the field +x
+  double pushY{0};           // N*s along the field +y
+
+  // How close to the last waypoint counts as settled, the same as goTo()
+  double positionTolerance{0.08};
+  double headingTolerance{8};
+};
+
+/**
+ * @return Every scenario, in a fixed order.
+ */
+const std::vector<Scenario> &getScenarios();
+
+/**
+ * @return The scenario called iname, or nullptr if there is none.
+ */
+const Scenario *findScenario(const std::string &iname);
+
+/**
+ * @return The names of the controllers every scenario is run against, in a fixed order.
+ */
+const std::vector<std::string> &getControllers();
+
+/**
+ * What a benchmark run measured. Values which do not apply to a run are negative and are written
+ * as null.
+ */
+struct Metrics {
+  bool completed{false};
+  double time{0};             // s until the controller returned
+  double settleTime{-1};      // s until the robot was last within tolerance of the end and stayed
+  double overshoot{0};        // m past a waypoint along the leg's direction, worst over the legs
+  double headingOvershoot{0}; // deg past a waypoint's heading once at it, worst over the legs
+  double pathLengthRatio{-1}; // Distance driven over the total length of the legs
+  double peakCurrent{0};      // A drawn by the drive motors together
+  double cpuPerTick{0};       // us of host CPU per run of a user task
+  double positionError{0};    // m from the last waypoint at the end
+  double headingError{0};     // deg from the last waypoint at the end, always positive
+
+  /**
+   * @return One line of JSON with the scenario and controller names and every metric.
+   */
+  std::string toJson(const std::string &iscenario, const std::string &icontroller) const;
+};
+
+/**
+ * Records the robot's motion on every physics step of a scenario, applies the scenario's push,
+ * and computes its metrics.
+ */
+class BenchmarkRecorder {
+  public:
+  // How long to keep recording after the controller returns, to catch drift and late overshoot
+  static constexpr std::uint32_t holdTime = 500;
+
+  explicit BenchmarkRecorder(const Scenario &iscenario);
+
+  /**
+   * Starts recording at the current time.
+   */
+  void start();
+
+  /**
+   * Marks that the controller is now heading for waypoint ileg.
+   */
+  void beginLeg(std::size_t ileg);
+
+  /**
+   * Marks that the controller has returned.
+   */
+  void finish();
+
+  /**
+   * Stops recording.
+   */
+  void stop();
+
+  /**
+   * @param icompleted Whether the controller returned before the run's duration ran out.
+   * @return The metrics of everything recorded.
+   */
+  Metrics getMetrics(bool icompleted) const;
+
+  const Scenario &getScenario() const;
+
+  protected:
+  struct Sample {
+    double time; // s since the start
+    double x;
+    double y;
+    double heading; // Not wrapped, so it is continuous
+    double current;
+    std::size_t leg;
+  };
+
+  const Scenario &scenario;
+  std::vector<Sample> samples;
+  std::uint64_t startTime{0};
+  double finishTime{-1};
+  std::size_t leg{0};
+  bool pushed{false};
+  std::vector<TaskStats> startStats;
+  std::vector<TaskStats> stopStats;
+
+  void record(std::uint64_t itime, XDrivePhysics &iphysics);
+};
+
+/**
+ * Drives a scenario with one of getControllers(), calling irecorder.beginLeg() as it heads for
+ * each waypoint. Implemented in benchmarkControllers.cpp, which needs OkapiLib and the user
+ * program's goTo().
+ */
+void runScenario(const Scenario &iscenario,
+                 const std::string &icontroller,
+                 BenchmarkRecorder &irecorder);
+} // namespace sim
@@ -0,0 +1,62 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sim {
+/**
+ * Simulated time shared by every simulated task. Tasks run one at a time: when the running task
+ * waits, time jumps to the earliest wake time and that task resumes, with ties broken in the
+ * order the waits were made. The simulation is therefore repeatable and runs as fast as the host
+ * allows. Time is kept in integer microseconds so it never drifts.
+ */
+class Clock {
+  public:
+  /**
+   * @return The current time in microseconds.
+   */
+  std::uint64_t now() const;
+
+  /**
+   * Makes the current thread a participant. Its first wait decides when it next runs.
+   */
+  void attach();
+
+  /**
+   * Stops the current thread from participating, letting the others run.
+   */
+  void detach();
+
+  /**
+   * Blocks the current participant until iwakeTime, running the others in the meantime.
+   *
+   * @param iwakeTime The time to wake at, in microseconds.
+   */
+  void sleepUntil(std::uint64_t iwakeTime);
+
+  protected:
+  struct Sleeper {
+    std::uint64_t wakeTime;
+    std::uint64_t order;
+    std::thread::id id;
+  };
+
+  mutable std::mutex mutex;
+  std::condition_variable condition;
+  std::uint64_t time{0};
+  std::vector<Sleeper> sleepers;
+  std::vector<std::thread::id> participants;
+  std::uint64_t nextOrder{0};
+  std::thread::id resumed;
+
+  void dispatch();
+};
+} // namespace sim
@@ -0,0 +1,97 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sim {
+/**
+ * Everything about the simulated robot and field which can be tuned. Lengths are in meters, angles
+ * in degrees and times in milliseconds unless noted. Headings follow the VEX GPS convention: 0 is
+ * along +y and angles increase clockwise.
+ */
+struct Config {
+  enum class Mode { opcontrol, autonomous };
+
+  // Which user function to run, and for how long
+  Mode mode{Mode::opcontrol};
+  std::uint32_t duration{15000};
+
+  // Physics step
+  std::uint32_t physicsPeriodUs{1000};
+
+  // Start pose of the robot center
+  double startX{0};
+  double startY{0};
+  double startHeading{0};
+
+  // Drive ports (absolute) in the order top left, top right, bottom right, bottom left
+  std::array<std::uint8_t, 4> drivePorts{{1, 2, 4, 3}};
+
+  // Drive geometry and mass
+  double wheelRadius{0.0508};
+  double halfTrack{0.18};
+  double mass{6.0};
+
+  // Friction: viscous (N per m/s, and N*m per rad/s) plus Coulomb (N and N*m)
+  double linearDamping{2.0};
+  double angularDamping{0.2};
+  double linearFriction{4.0};
+  double angularFriction{0.4};
+
+  // Battery voltage under load. Motors can apply at most 12 V, less on a weak battery.
+  double batteryVoltage{12.8};
+
+  // Coefficient of friction between the wheels and the tiles. Limits the force each wheel can
+  // apply along its drive direction before it slips.
+  double wheelTraction{0.8};
+
+  // GPS sensor model
+  std::uint8_t gpsPort{9};
+  double gpsPositionNoise{0.005};
+  double gpsHeadingNoise{0.2};
+  std::uint32_t gpsLatency{40};
+  std::uint32_t gpsDataRate{20};
+
+  // IMU sensor model
+  std::uint8_t imuPort{10};
+  double imuDriftPerSecond{0.005};
+  std::uint32_t imuCalibrationTime{2000};
+
+  /**
+   * An undriven tracking wheel read by an ADI encoder (360 ticks per revolution).
+   */
+  struct TrackingWheel {
+    std::uint8_t topPort;
+    double x;         // Position forward of the robot center
+    double y;         // Position left of the robot center
+    double heading;   // Rolling direction, counterclockwise from forward, in degrees
+    double radius{0.0349};
+  };
+
+  std::vector<TrackingWheel> trackingWheels;
+
+  // Seed for all sensor noise, so runs are repeatable
+  std::uint32_t seed{1};
+
+  // Print brain screen lines to stdout when they change
+  bool echoScreen{false};
+
+  // Run a benchmark scenario with one controller instead of the mode (see sim/benchmark.hpp).
+  // The scenario sets the start pose.
+  std::string scenario;
+  std::string controller{"goTo"};
+
+  /**
+   * Parses `--key=value` options, such as `--mode=autonomous --duration=15000 --gps-noise=0.01`.
+   * Unknown options throw `std::invalid_argument`.
+   */
+  static Config fromArgs(int argc, char **argv);
+};
+} // namespace sim
@@ -0,0 +1,131 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace sim {
+/**
+ * Ranges the Monte Carlo runner draws each trial's conditions from. Uniform ranges are given as
+ * {min, max}; the start pose is perturbed by zero-mean Gaussian noise.
+ */
+struct Randomization {
+  double gpsPositionNoise[2]{0.002, 0.015};
+  double gpsHeadingNoise[2]{0.1, 0.5};
+  double gpsLatency[2]{20, 80};
+  double wheelTraction[2]{0.6, 1.0};
+  double linearFriction[2]{2.0, 6.0};
+  double angularFriction[2]{0.2, 0.6};
+  double batteryVoltage[2]{11.5, 12.8};
+  double startPositionStdDev{0.02};
+  double startHeadingStdDev{2.0};
+};
+
+/**
+ * One run of the simulator: the seed it was drawn from and the arguments it is run with.
+ */
+struct Trial {
+  std::uint32_t seed;
+  std::vector<std::string> args;
+};
+
+struct TrialResult {
+  enum class Outcome { success, missedTarget, timedOut, crashed };
+
+  Trial trial;
+  Outcome outcome{Outcome::crashed};
+  double time{0};          // s until the routine returned
+  double x{0};             // m
+  double y{0};             // m
+  double heading{0};       // deg
+  double positionError{0}; // m from the target
+  double headingError{0};  // deg from the target, always positive
+};
+
+/**
+ * Runs a simulated routine many times under randomized conditions, spread across the host's
+ * cores, and summarizes how robust it is.
+ *
+ * Every trial is a separate simulator process. The simulator and the user program's globals
+ * (like the chassis built in src/main.cpp) are process-wide, so processes are what lets trials
+ * run side by side. Each trial's conditions come only from the base seed and the trial's index,
+ * so any trial in a report can be rerun on its own with the command line the report prints.
+ */
+class MonteCarloRunner {
+  public:
+  struct Options {
+    std::string simulator;
+    std::size_t trials{1000};
+    std::size_t jobs{0}; // 0 means one per hardware thread
+    std::uint32_t seed{1};
+
+    std::string mode{"autonomous"};
+    std::uint32_t duration{15000};
+    double startX{0};
+    double startY{0};
+    double startHeading{0};
+
+    // Where the routine is supposed to end, and how close counts as success
+    double targetX{0};
+    double targetY{0};
+    double targetHeading{0};
+    double positionTolerance{0.08};
+    double headingTolerance{8};
+
+    Randomization randomization;
+
+    // Passed to every trial after the randomized arguments
+    std::vector<std::string> extraArgs;
+  };
+
+  explicit MonteCarloRunner(const Options &ioptions);
+
+  /**
+   * Draws the conditions for one trial.
+   *
+   * @param iindex The trial's index.
+   * @return The trial.
+   */
+  Trial makeTrial(std::size_t iindex) const;
+
+  /**
+   * Runs one trial and waits for it to finish.
+   *
+   * @param itrial The trial.
+   * @return Its result.
+   */
+  TrialResult runTrial(const Trial &itrial) const;
+
+  /**
+   * Runs every trial across the configured number of jobs.
+   *
+   * @return The results, in trial order.
+   */
+  std::vector<TrialResult> run() const;
+
+  /**
+   * Prints outcome counts, percentiles of completion time and final pose error, and the command
+   * lines of the worst trials.
+   *
+   * @param iresults The results to summarize.
+   * @param ostream Where to print.
+   */
+  void printReport(const std::vector<TrialResult> &iresults, std::FILE *ostream) const;
+
+  /**
+   * @return The p-th percentile (0 to 100) of ivalues by nearest rank, or 0 if it is empty.
+   */
+  static double percentile(std::vector<double> ivalues, double ip);
+
+  protected:
+  Options options;
+
+  std::size_t getJobs() const;
+};
+} // namespace sim
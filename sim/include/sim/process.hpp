@@ -0,0 +1,21 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace sim {
+/**
+ * Runs a program, discarding its stderr, and waits for it to exit.
+ *
+ * @param iargv The program's path followed by its arguments.
+ * @param ooutput Set to everything the program wrote to stdout.
+ * @param istdin A file descriptor to give the program as its stdin, or -1 to share this one's.
+ * @return Whether it ran and exited with status 0.
+ */
+bool runProcess(const std::vector<std::string> &iargv, std::string &ooutput, int istdin = -1);
+} // namespace sim
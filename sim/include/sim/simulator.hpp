@@ -0,0 +1,235 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+/**
+ * Host-side stand-in for the V5 brain. The files under sim/src implement the subset of the PROS
+ * C and C++ API used by this project (motors, GPS, IMU, ADI encoders, brain screen, controller,
+ * competition status, and RTOS tasks, delays, notifications, mutexes and semaphores) on top of a
+ * physics model of the four-motor X-drive. Time is simulated, so a 15 second routine finishes as
+ * fast as the host can compute it, and a run with the same Config always does the same thing.
+ *
+ * The simulator is linked in place of libpros, and the OkapiLib classes this project uses are
+ * reimplemented for the host under sim/src/okapi. sim/Makefile builds it with the user code:
+ *
+ *   make -C sim
+ *   sim/build/gpstest-sim --mode=opcontrol --duration=15000 --gps-noise=0.01 --echo-screen=1
+ *
+ * sim/src/main.cpp provides main(), which calls initialize() and then runs autonomous() or
+ * opcontrol() in a task, like the PROS kernel does.
+ */
+
+#include "api.h"
+#include "sim/clock.hpp"
+#include "sim/config.hpp"
+#include "sim/xDrivePhysics.hpp"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace sim {
+constexpr int numPorts = 21;
+
+struct MotorDevice {
+  enum class Mode { voltage, velocity, position };
+
+  Mode mode{Mode::voltage};
+  double command{0};       // mV in voltage mode, rpm in velocity and position mode
+  double targetPosition{0}; // Encoder units
+
+  pros::motor_gearset_e_t gearset{pros::E_MOTOR_GEARSET_18};
+  pros::motor_encoder_units_e_t units{pros::E_MOTOR_ENCODER_DEGREES};
+  pros::motor_brake_mode_e_t brakeMode{pros::E_MOTOR_BRAKE_COAST};
+  bool reversed{false};
+  std::int32_t voltageLimit{12000};
+  std::int32_t currentLimit{2500};
+
+  // State of the output shaft in its physical direction, before reversing
+  double angle{0};    // rad
+  double velocity{0}; // rad/s
+  double torque{0};   // N*m
+  double voltage{0};  // V actually applied
+  double zero{0};     // rad, in the motor's (possibly reversed) direction
+
+  /**
+   * @return The torque-speed curve of this motor's cartridge.
+   */
+  XDrivePhysics::MotorCurve curve() const;
+
+  /**
+   * Converts an angle in radians into this motor's encoder units.
+   */
+  double toUnits(double iradians) const;
+
+  /**
+   * @return The current position in encoder units.
+   */
+  double position() const;
+
+  /**
+   * @return The current velocity in rpm.
+   */
+  double rpm() const;
+
+  /**
+   * Runs the motor's internal controller.
+   *
+   * @return The voltage it applies, in its physical direction.
+   */
+  double computeVoltage() const;
+
+  /**
+   * @return Whether the motor is disconnected from its windings.
+   */
+  bool isCoasting() const;
+
+  /**
+   * @return The current the motor draws, in amps. It is proportional to torque, reaching 2.5 A
+   * at stall.
+   */
+  double current() const;
+};
+
+struct GpsDevice {
+  struct Sample {
+    std::uint64_t deliverTime;
+    pros::c::gps_status_s_t status;
+    double rotation;
+  };
+
+  double xOffset{0};
+  double yOffset{0};
+  std::uint32_t dataRate;
+  std::uint64_t nextSampleTime{0};
+  std::deque<Sample> pending;
+  pros::c::gps_status_s_t latest{};
+  double latestRotation{0};
+  double rotationOffset{0};
+};
+
+struct ImuDevice {
+  double rotation{0};       // Clockwise degrees, including drift
+  double rotationOffset{0};
+  double headingOffset{0};
+  double rate{0};           // Clockwise degrees per second
+  std::uint64_t calibratedTime{0};
+};
+
+struct EncoderDevice {
+  int wheel{-1}; // Index into Config::trackingWheels, or -1 if nothing is attached
+  bool reversed{false};
+  double ticks{0};
+  double zero{0};
+};
+
+struct ControllerDevice {
+  std::array<std::int32_t, 4> analog{};
+  std::array<bool, 12> digital{};
+  std::array<bool, 12> reported{};
+};
+
+class Simulator {
+  public:
+  /**
+   * @return The simulator. It is created on first use, which may be during static
+   * initialization of user globals.
+   */
+  static Simulator &get();
+
+  /**
+   * Replaces the configuration. Must be called before start().
+   */
+  void configure(const Config &iconfig);
+
+  /**
+   * Starts the physics task. The calling thread becomes a participant in the clock.
+   */
+  void start();
+
+  const Config &getConfig() const;
+
+  Clock &getClock();
+
+  /**
+   * @return The physics model, or nullptr before start().
+   */
+  const XDrivePhysics *getPhysics() const;
+
+  /**
+   * Guards every device below. Held by the physics task while it steps.
+   */
+  std::mutex &getMutex();
+
+  MotorDevice &motor(std::uint8_t iport);
+  GpsDevice &gps();
+  ImuDevice &imu();
+  ControllerDevice &controller(pros::controller_id_e_t iid);
+
+  /**
+   * @return The ADI encoders, keyed by (smart port << 8) | top ADI port.
+   */
+  std::map<std::int32_t, EncoderDevice> &encoders();
+
+  /**
+   * Writes a line of the brain screen.
+   */
+  void setScreenLine(std::int16_t iline, const std::string &itext);
+
+  /**
+   * @return The brain screen lines which have been written, by line number.
+   */
+  std::map<std::int16_t, std::string> getScreen() const;
+
+  /**
+   * Sets a function the physics task calls after every step, with the devices locked and the
+   * time in microseconds. It may read any device and push the robot, but must not block.
+   */
+  void setStepObserver(std::function<void(std::uint64_t, XDrivePhysics &)> iobserver);
+
+  protected:
+  Simulator();
+
+  Config config;
+  Clock clock;
+  mutable std::mutex mutex;
+  std::unique_ptr<XDrivePhysics> physics;
+  std::mt19937 random;
+
+  std::array<MotorDevice, numPorts> motors;
+  GpsDevice gpsDevice;
+  ImuDevice imuDevice;
+  std::array<ControllerDevice, 2> controllers;
+  std::map<std::int32_t, EncoderDevice> encoderDevices;
+  std::map<std::int16_t, std::string> screen;
+  std::function<void(std::uint64_t, XDrivePhysics &)> stepObserver;
+
+  void loop();
+  void stepMotors(double idt);
+  void stepSensors(double idt);
+};
+
+/**
+ * Host CPU time a task spent running user code, from waking up until it next waited.
+ */
+struct TaskStats {
+  std::string name;
+  std::uint64_t cpuTime{0}; // ns
+  std::uint64_t runs{0};    // Times it woke up and ran
+};
+
+/**
+ * @return The stats of every task created so far, including the main task. Implemented
+ * alongside the RTOS.
+ */
+std::vector<TaskStats> getTaskStats();
+} // namespace sim
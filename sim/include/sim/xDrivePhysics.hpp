@@ -0,0 +1,116 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "sim/config.hpp"
+#include <array>
+
+namespace sim {
+/**
+ * Rigid-body model of a four-motor X-drive on omni wheels. Each wheel pushes only along its drive
+ * direction (its rollers let it slide freely sideways) and can push at most its share of the
+ * robot's weight times the traction coefficient before it slips. Each motor is modeled as a DC
+ * motor whose torque falls linearly from stall torque at zero speed to zero at free speed.
+ *
+ * The field frame has +x to the right and +y forward (north); theta is counterclockwise from +x.
+ * Wheels are indexed top left, top right, bottom right, bottom left.
+ */
+class XDrivePhysics {
+  public:
+  struct Pose {
+    double x{0};
+    double y{0};
+    double theta{0};
+  };
+
+  /**
+   * The torque-speed curve of one motor at its output shaft.
+   */
+  struct MotorCurve {
+    double stallTorque; // N*m at 12 V
+    double freeSpeed;   // rad/s at 12 V
+  };
+
+  explicit XDrivePhysics(const Config &iconfig);
+
+  /**
+   * Advances the model.
+   *
+   * @param idt The time step in seconds.
+   * @param ivoltages The voltage applied to each motor, in volts, in its physical direction.
+   * @param icurves The torque-speed curve of each motor.
+   * @param icoasting Whether each motor is disconnected (coast with zero voltage).
+   */
+  void step(double idt,
+            const std::array<double, 4> &ivoltages,
+            const std::array<MotorCurve, 4> &icurves,
+            const std::array<bool, 4> &icoasting);
+
+  /**
+   * @return The pose of the robot center.
+   */
+  const Pose &getPose() const;
+
+  /**
+   * @return The angular velocity of the robot in rad/s, counterclockwise.
+   */
+  double getAngularVelocity() const;
+
+  /**
+   * @param iwheel The wheel index.
+   * @return The wheel's angle in radians since the start, in its physical direction.
+   */
+  double getWheelAngle(int iwheel) const;
+
+  /**
+   * @param iwheel The wheel index.
+   * @return The wheel's angular velocity in rad/s, in its physical direction.
+   */
+  double getWheelVelocity(int iwheel) const;
+
+  /**
+   * @param iwheel The wheel index.
+   * @return The torque the motor produced on the last step, in N*m.
+   */
+  double getWheelTorque(int iwheel) const;
+
+  /**
+   * Returns the speed of a point on the robot along a direction, both in the robot frame
+   * (+x forward, +y left). Used for tracking wheels.
+   *
+   * @param ix The point's forward offset.
+   * @param iy The point's left offset.
+   * @param iheading The direction, counterclockwise from forward, in radians.
+   * @return The speed in m/s.
+   */
+  double getPointSpeed(double ix, double iy, double iheading) const;
+
+  /**
+   * Pushes the robot center, as if it were hit by something.
+   *
+   * @param ix The impulse along the field +x, in N*s.
+   * @param iy The impulse along the field +y, in N*s.
+   */
+  void applyImpulse(double ix, double iy);
+
+  protected:
+  const Config &config;
+  Pose pose;
+
+  // Robot frame velocity (+x forward, +y left) and angular velocity
+  double vx{0};
+  double vy{0};
+  double omega{0};
+
+  std::array<double, 4> wheelAngles{};
+  std::array<double, 4> wheelVelocities{};
+  std::array<double, 4> wheelTorques{};
+
+  // Wheel positions and physical drive directions in the robot frame
+  std::array<std::array<double, 2>, 4> wheelPositions;
+  std::array<std::array<double, 2>, 4> wheelDirections;
+};
+} // namespace sim
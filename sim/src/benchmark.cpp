@@ -0,0 +1,169 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/benchmark.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+namespace {
+constexpr double pi = 3.14159265358979323846;
+
+// Legs shorter than this are turns in place
+constexpr double minLegLength = 0.01;
+
+double wrap180(const double iangle) {
+  return std::remainder(iangle, 360.0);
+}
+} // namespace
+
+BenchmarkRecorder::BenchmarkRecorder(const Scenario &iscenario) : scenario(iscenario) {
+}
+
+void BenchmarkRecorder::start() {
+  auto &simulator = Simulator::get();
+  startStats = getTaskStats();
+  startTime = simulator.getClock().now();
+  simulator.setStepObserver(
+    [this](const std::uint64_t itime, XDrivePhysics &iphysics) { record(itime, iphysics); });
+}
+
+void BenchmarkRecorder::beginLeg(const std::size_t ileg) {
+  std::lock_guard<std::mutex> lock(Simulator::get().getMutex());
+  leg = ileg;
+}
+
+void BenchmarkRecorder::finish() {
+  finishTime = (Simulator::get().getClock().now() - startTime) / 1e6;
+}
+
+void BenchmarkRecorder::stop() {
+  Simulator::get().setStepObserver(nullptr);
+  stopStats = getTaskStats();
+}
+
+const Scenario &BenchmarkRecorder::getScenario() const {
+  return scenario;
+}
+
+void BenchmarkRecorder::record(const std::uint64_t itime, XDrivePhysics &iphysics) {
+  auto &simulator = Simulator::get();
+  const double time = (itime - startTime) / 1e6;
+
+  if (scenario.pushTime != 0 && !pushed && time * 1000 >= scenario.pushTime) {
+    iphysics.applyImpulse(scenario.pushX, scenario.pushY);
+    pushed = true;
+  }
+
+  double current = 0;
+  for (const auto port : simulator.getConfig().drivePorts) {
+    current += simulator.motor(port).current();
+  }
+
+  const auto &pose = iphysics.getPose();
+  samples.push_back({time, pose.x, pose.y, 90.0 - pose.theta * 180.0 / pi, current, leg});
+}
+
+Metrics BenchmarkRecorder::getMetrics(const bool icompleted) const {
+  Metrics metrics;
+  metrics.completed = icompleted;
+  metrics.time = icompleted ? finishTime : -1;
+  if (samples.empty() || scenario.waypoints.empty()) {
+    return metrics;
+  }
+
+  // Each leg's target heading on the same continuous scale as the samples, taking the short way
+  std::vector<double> targetHeadings;
+  double heading = samples.front().heading;
+  double plannedLength = 0;
+  for (std::size_t i = 0; i < scenario.waypoints.size(); i++) {
+    const auto &from = i == 0 ? scenario.start : scenario.waypoints[i - 1];
+    const auto &to = scenario.waypoints[i];
+    heading += wrap180(to.heading - from.heading);
+    targetHeadings.push_back(heading);
+    plannedLength += std::hypot(to.x - from.x, to.y - from.y);
+  }
+
+  const auto &end = scenario.waypoints.back();
+  const auto within = [&](const Sample &isample) {
+    return std::hypot(isample.x - end.x, isample.y - end.y) <= scenario.positionTolerance &&
+           std::abs(isample.heading - targetHeadings.back()) <= scenario.headingTolerance;
+  };
+
+  // Settled from the start of the last stretch within tolerance, if it lasted to the end
+  if (within(samples.back())) {
+    auto first = samples.rbegin();
+    while (std::next(first) != samples.rend() && within(*std::next(first))) {
+      first++;
+    }
+    metrics.settleTime = first->time;
+  }
+
+  // Which way each waypoint's heading is turned to once the robot is there, or 0 to not count it
+  std::vector<bool> reached(scenario.waypoints.size(), false);
+  std::vector<double> side(scenario.waypoints.size(), 0);
+
+  double driven = 0;
+  for (std::size_t i = 0; i < samples.size(); i++) {
+    const auto &sample = samples[i];
+    const std::size_t index = std::min(sample.leg, scenario.waypoints.size() - 1);
+    const auto &from = index == 0 ? scenario.start : scenario.waypoints[index - 1];
+    const auto &to = scenario.waypoints[index];
+
+    const double legLength = std::hypot(to.x - from.x, to.y - from.y);
+    if (legLength > minLegLength) {
+      const double past =
+        ((sample.x - to.x) * (to.x - from.x) + (sample.y - to.y) * (to.y - from.y)) / legLength;
+      metrics.overshoot = std::max(metrics.overshoot, past);
+    }
+
+    // Controllers which turn to face the waypoint first may pass its heading on the way, and then
+    // turn back to it from the other side, so only count turning past it once the robot is at
+    // the waypoint, and from the side it was on then
+    const bool arrived = std::hypot(sample.x - to.x, sample.y - to.y) <= scenario.positionTolerance;
+    if (arrived && !reached[index]) {
+      reached[index] = true;
+      const double remaining = targetHeadings[index] - sample.heading;
+      const double turn = wrap180(to.heading - from.heading);
+      if (std::abs(remaining) > scenario.headingTolerance) {
+        side[index] = std::copysign(1.0, remaining);
+      } else if (std::abs(turn) > scenario.headingTolerance) {
+        side[index] = std::copysign(1.0, turn);
+      }
+    }
+    if (arrived) {
+      const double past = side[index] * (sample.heading - targetHeadings[index]);
+      metrics.headingOvershoot = std::max(metrics.headingOvershoot, past);
+    }
+
+    if (i > 0) {
+      driven += std::hypot(sample.x - samples[i - 1].x, sample.y - samples[i - 1].y);
+    }
+    metrics.peakCurrent = std::max(metrics.peakCurrent, sample.current);
+  }
+
+  if (plannedLength > minLegLength) {
+    metrics.pathLengthRatio = driven / plannedLength;
+  }
+
+  metrics.positionError = std::hypot(samples.back().x - end.x, samples.back().y - end.y);
+  metrics.headingError = std::abs(wrap180(samples.back().heading - end.heading));
+
+  // The main task only waits for the run to end, so only the other tasks are the controller
+  std::uint64_t cpuTime = 0;
+  std::uint64_t runs = 0;
+  for (std::size_t i = 0; i < stopStats.size(); i++) {
+    if (stopStats[i].name == "main") {
+      continue;
+    }
+    const bool existed = i < startStats.size();
+    cpuTime += stopStats[i].cpuTime - (existed ? startStats[i].cpuTime : 0);
+    runs += stopStats[i].runs - (existed ? startStats[i].runs : 0);
+  }
+  metrics.cpuPerTick = runs > 0 ? cpuTime / 1e3 / runs : 0;
+
+  return metrics;
+}
+} // namespace sim
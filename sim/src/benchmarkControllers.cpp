@@ -0,0 +1,115 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "main.h"
+#include "sim/benchmark.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace sim {
+namespace {
+// The gains opcontrol() passes to goTo()
+const okapi::IterativePosPIDController::Gains goToDriveGains{2.0, 0.0, 0.01};
+const okapi::IterativePosPIDController::Gains goToTurnGains{1.0 / 90.0, 0.0, 0.001};
+
+// Moves shorter than these are skipped
+constexpr double minDistance = 0.01;
+constexpr double minTurn = 0.5;
+
+/**
+ * A ChassisControllerPID for the same drive as src/main.cpp. An X-drive's wheels roll at 45
+ * degrees to the robot, so it moves sqrt(2) times as far as its wheels roll, and turning rolls
+ * them around the circle through the corners; the scales account for both.
+ *
+ * The controllers count as settled within 50 motor degrees, about 10 degrees of a turn, and each
+ * drive goes along whatever heading the turn before it ended at, so the turn gain is high enough
+ * to end turns well inside that.
+ */
+std::shared_ptr<okapi::ChassisController> buildChassisPid() {
+  const auto &config = Simulator::get().getConfig();
+  const double wheelDiameter = 2 * config.wheelRadius * std::sqrt(2.0);
+  const double wheelTrack = 4 * config.halfTrack;
+
+  return okapi::ChassisControllerBuilder()
+    .withMotors(1, -2, -4, 3)
+    .withDimensions(
+      okapi::AbstractMotor::gearset::green,
+      {{wheelDiameter * okapi::meter, wheelTrack * okapi::meter}, okapi::imev5GreenTPR})
+    .withGains({0.004, 0, 0.0001}, {0.01, 0, 0.0003}, {0.001, 0, 0.0001})
+    .build();
+}
+
+/**
+ * Reaches each waypoint by turning to face it, driving straight to it, and turning to its
+ * heading. The moves are planned from the previous waypoint, not from where the robot is, since
+ * these controllers only see their encoders.
+ *
+ * @param idrive Drives forward by a distance in meters.
+ * @param iturn Turns clockwise by an angle in degrees.
+ */
+template <typename Drive, typename Turn>
+void turnDriveTurn(const Scenario &iscenario,
+                   BenchmarkRecorder &irecorder,
+                   Drive &&idrive,
+                   Turn &&iturn) {
+  const auto turn = [&](const double iangle) {
+    if (std::abs(iangle) > minTurn) {
+      iturn(iangle);
+    }
+  };
+
+  Waypoint from = iscenario.start;
+  for (std::size_t i = 0; i < iscenario.waypoints.size(); i++) {
+    irecorder.beginLeg(i);
+    const auto &to = iscenario.waypoints[i];
+    double heading = from.heading;
+
+    const double distance = std::hypot(to.x - from.x, to.y - from.y);
+    if (distance > minDistance) {
+      const double bearing = std::atan2(to.x - from.x, to.y - from.y) * okapi::radianToDegree;
+      turn(std::remainder(bearing - heading, 360.0));
+      heading = bearing;
+      idrive(distance);
+    }
+
+    turn(std::remainder(to.heading - heading, 360.0));
+    from = to;
+  }
+}
+
+void runGoTo(const Scenario &iscenario, BenchmarkRecorder &irecorder) {
+  for (std::size_t i = 0; i < iscenario.waypoints.size(); i++) {
+    irecorder.beginLeg(i);
+    const auto &to = iscenario.waypoints[i];
+    goTo({to.x * okapi::meter, to.y * okapi::meter},
+         to.heading * okapi::degree,
+         goToDriveGains,
+         goToTurnGains);
+  }
+}
+
+void runChassisPid(const Scenario &iscenario, BenchmarkRecorder &irecorder) {
+  const auto chassis = buildChassisPid();
+  turnDriveTurn(
+    iscenario,
+    irecorder,
+    [&](const double idistance) { chassis->moveDistance(idistance * okapi::meter); },
+    [&](const double iangle) { chassis->turnAngle(iangle * okapi::degree); });
+}
+
+} // namespace
+
+void runScenario(const Scenario &iscenario,
+                 const std::string &icontroller,
+                 BenchmarkRecorder &irecorder) {
+  if (icontroller == "goTo") {
+    runGoTo(iscenario, irecorder);
+  } else if (icontroller == "chassisPid") {
+    runChassisPid(iscenario, irecorder);
+  } else {
+    throw std::invalid_argument("runScenario: Unknown controller " + icontroller);
+  }
+}
+} // namespace sim
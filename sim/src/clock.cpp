@@ -0,0 +1,61 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/clock.hpp"
+#include <algorithm>
+
+namespace sim {
+std::uint64_t Clock::now() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return time;
+}
+
+void Clock::attach() {
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto id = std::this_thread::get_id();
+  if (std::find(participants.begin(), participants.end(), id) == participants.end()) {
+    participants.push_back(id);
+  }
+}
+
+void Clock::detach() {
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto id = std::this_thread::get_id();
+  participants.erase(std::remove(participants.begin(), participants.end(), id),
+                     participants.end());
+  dispatch();
+}
+
+void Clock::sleepUntil(const std::uint64_t iwakeTime) {
+  const auto id = std::this_thread::get_id();
+  std::unique_lock<std::mutex> lock(mutex);
+  if (std::find(participants.begin(), participants.end(), id) == participants.end()) {
+    participants.push_back(id);
+  }
+
+  sleepers.push_back({std::max(iwakeTime, time), nextOrder++, id});
+  dispatch();
+
+  condition.wait(lock, [&] { return resumed == id; });
+  resumed = std::thread::id();
+}
+
+void Clock::dispatch() {
+  // Wait until every participant is asleep and the last one resumed has woken up
+  if (sleepers.empty() || sleepers.size() < participants.size() || resumed != std::thread::id()) {
+    return;
+  }
+
+  const auto next =
+    std::min_element(sleepers.begin(), sleepers.end(), [](const Sleeper &a, const Sleeper &b) {
+      return a.wakeTime < b.wakeTime || (a.wakeTime == b.wakeTime && a.order < b.order);
+    });
+
+  time = std::max(time, next->wakeTime);
+  resumed = next->id;
+  sleepers.erase(next);
+  condition.notify_all();
+}
+} // namespace sim
@@ -0,0 +1,66 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/config.hpp"
+#include <functional>
+#include <map>
+#include <stdexcept>
+
+namespace sim {
+Config Config::fromArgs(const int argc, char **argv) {
+  Config config;
+
+  const std::map<std::string, std::function<void(const std::string &)>> options{
+    {"mode",
+     [&](const std::string &value) {
+       if (value == "opcontrol") {
+         config.mode = Mode::opcontrol;
+       } else if (value == "autonomous") {
+         config.mode = Mode::autonomous;
+       } else {
+         throw std::invalid_argument("Config: Unknown mode " + value);
+       }
+     }},
+    {"duration", [&](const std::string &value) { config.duration = std::stoul(value); }},
+    {"physics-period",
+     [&](const std::string &value) { config.physicsPeriodUs = std::stoul(value); }},
+    {"x", [&](const std::string &value) { config.startX = std::stod(value); }},
+    {"y", [&](const std::string &value) { config.startY = std::stod(value); }},
+    {"heading", [&](const std::string &value) { config.startHeading = std::stod(value); }},
+    {"mass", [&](const std::string &value) { config.mass = std::stod(value); }},
+    {"traction", [&](const std::string &value) { config.wheelTraction = std::stod(value); }},
+    {"linear-friction",
+     [&](const std::string &value) { config.linearFriction = std::stod(value); }},
+    {"angular-friction",
+     [&](const std::string &value) { config.angularFriction = std::stod(value); }},
+    {"battery", [&](const std::string &value) { config.batteryVoltage = std::stod(value); }},
+    {"gps-noise", [&](const std::string &value) { config.gpsPositionNoise = std::stod(value); }},
+    {"gps-heading-noise",
+     [&](const std::string &value) { config.gpsHeadingNoise = std::stod(value); }},
+    {"gps-latency", [&](const std::string &value) { config.gpsLatency = std::stoul(value); }},
+    {"gps-rate", [&](const std::string &value) { config.gpsDataRate = std::stoul(value); }},
+    {"imu-drift", [&](const std::string &value) { config.imuDriftPerSecond = std::stod(value); }},
+    {"seed", [&](const std::string &value) { config.seed = std::stoul(value); }},
+    {"echo-screen", [&](const std::string &value) { config.echoScreen = value != "0"; }},
+    {"scenario", [&](const std::string &value) { config.scenario = value; }},
+    {"controller", [&](const std::string &value) { config.controller = value; }}};
+
+  for (int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    const auto equals = arg.find('=');
+    if (arg.compare(0, 2, "--") != 0 || equals == std::string::npos) {
+      throw std::invalid_argument("Config: Expected --key=value, got " + arg);
+    }
+
+    const auto option = options.find(arg.substr(2, equals - 2));
+    if (option == options.end()) {
+      throw std::invalid_argument("Config: Unknown option " + arg);
+    }
+    option->second(arg.substr(equals + 1));
+  }
+
+  return config;
+}
+} // namespace sim
@@ -0,0 +1,126 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "pros/rtos.h"
+#include "sim/benchmark.hpp"
+#include "sim/simulator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+
+extern "C" {
+void initialize(void);
+void autonomous(void);
+void opcontrol(void);
+}
+
+namespace {
+pros::task_t mainTask = nullptr;
+std::unique_ptr<sim::BenchmarkRecorder> recorder;
+
+void runMode(void *) {
+  const auto &config = sim::Simulator::get().getConfig();
+  if (recorder) {
+    recorder->start();
+    sim::runScenario(recorder->getScenario(), config.controller, *recorder);
+    recorder->finish();
+    pros::c::delay(sim::BenchmarkRecorder::holdTime);
+  } else if (config.mode == sim::Config::Mode::autonomous) {
+    autonomous();
+  } else {
+    opcontrol();
+  }
+
+  pros::c::task_notify(mainTask);
+}
+
+/**
+ * Starts the robot where the scenario named in the config starts.
+ */
+const sim::Scenario &applyScenario(sim::Config &oconfig) {
+  const auto scenario = sim::findScenario(oconfig.scenario);
+  if (!scenario) {
+    throw std::invalid_argument("Unknown scenario " + oconfig.scenario);
+  }
+
+  const auto &controllers = sim::getControllers();
+  if (std::find(controllers.begin(), controllers.end(), oconfig.controller) == controllers.end()) {
+    throw std::invalid_argument("Unknown controller " + oconfig.controller);
+  }
+
+  oconfig.startX = scenario->start.x;
+  oconfig.startY = scenario->start.y;
+  oconfig.startHeading = scenario->start.heading;
+  return *scenario;
+}
+} // namespace
+
+/**
+ * Runs the program like the PROS kernel would with a field controller attached: initialize()
+ * first, then the chosen mode in its own task until it returns or the duration runs out. Prints
+ * the brain screen and a result line, then exits without waiting for user tasks, which may never
+ * return.
+ *
+ * The result line is `result completed=<0|1> time=<s> x=<m> y=<m> heading=<deg>`, where time is
+ * when the mode function returned (or the duration, if it did not).
+ *
+ * With --scenario, the chosen benchmark scenario is run with --controller in place of the mode,
+ * and a `benchmark <json>` line with its metrics (see sim::Metrics) is printed as well.
+ */
+int main(int argc, char **argv) {
+  auto &simulator = sim::Simulator::get();
+  try {
+    auto config = sim::Config::fromArgs(argc, argv);
+    if (!config.scenario.empty()) {
+      recorder = std::make_unique<sim::BenchmarkRecorder>(applyScenario(config));
+    }
+    simulator.configure(config);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  const auto &config = simulator.getConfig();
+  simulator.start();
+  mainTask = pros::c::task_get_current();
+
+  initialize();
+  const std::uint32_t startTime = pros::c::millis();
+  pros::c::task_create(runMode, nullptr, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "User");
+  const bool completed = pros::c::task_notify_take(true, config.duration) != 0;
+  const std::uint32_t endTime = pros::c::millis();
+
+  if (recorder) {
+    recorder->stop();
+  }
+
+  for (const auto &line : simulator.getScreen()) {
+    std::printf("screen %2d: %s\n", line.first, line.second.c_str());
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(simulator.getMutex());
+    const auto &pose = simulator.getPhysics()->getPose();
+    const double heading =
+      std::fmod(std::fmod(90.0 - pose.theta * 180.0 / M_PI, 360.0) + 360.0, 360.0);
+    std::printf("result completed=%d time=%.3f x=%.4f y=%.4f heading=%.2f\n",
+                completed ? 1 : 0,
+                (endTime - startTime) / 1000.0,
+                pose.x,
+                pose.y,
+                heading);
+  }
+
+  if (recorder) {
+    std::printf("benchmark %s\n",
+                recorder->getMetrics(completed).toJson(config.scenario, config.controller).c_str());
+  }
+
+  std::fflush(stdout);
+  std::_Exit(0);
+}
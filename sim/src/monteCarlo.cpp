@@ -0,0 +1,230 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/monteCarlo.hpp"
+#include "sim/process.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace sim {
+namespace {
+double uniform(std::mt19937 &irandom, const double (&irange)[2]) {
+  return std::uniform_real_distribution<double>(irange[0], irange[1])(irandom);
+}
+
+std::string arg(const char *iname, const double ivalue) {
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "--%s=%.6g", iname, ivalue);
+  return buffer;
+}
+
+const char *outcomeName(const TrialResult::Outcome ioutcome) {
+  switch (ioutcome) {
+  case TrialResult::Outcome::success:
+    return "success";
+  case TrialResult::Outcome::missedTarget:
+    return "missed target";
+  case TrialResult::Outcome::timedOut:
+    return "timed out";
+  default:
+    return "crashed";
+  }
+}
+} // namespace
+
+MonteCarloRunner::MonteCarloRunner(const Options &ioptions) : options(ioptions) {
+  if (options.simulator.empty()) {
+    throw std::invalid_argument("MonteCarloRunner: The simulator path must not be empty.");
+  }
+}
+
+Trial MonteCarloRunner::makeTrial(const std::size_t iindex) const {
+  const auto &r = options.randomization;
+  Trial trial;
+  trial.seed = options.seed + static_cast<std::uint32_t>(iindex);
+
+  std::mt19937 random(trial.seed);
+  std::normal_distribution<double> startPosition(0.0, r.startPositionStdDev);
+  std::normal_distribution<double> startHeading(0.0, r.startHeadingStdDev);
+
+  trial.args = {"--mode=" + options.mode,
+                "--duration=" + std::to_string(options.duration),
+                "--seed=" + std::to_string(trial.seed),
+                arg("x", options.startX + startPosition(random)),
+                arg("y", options.startY + startPosition(random)),
+                arg("heading", options.startHeading + startHeading(random)),
+                arg("gps-noise", uniform(random, r.gpsPositionNoise)),
+                arg("gps-heading-noise", uniform(random, r.gpsHeadingNoise)),
+                arg("gps-latency", std::round(uniform(random, r.gpsLatency))),
+                arg("traction", uniform(random, r.wheelTraction)),
+                arg("linear-friction", uniform(random, r.linearFriction)),
+                arg("angular-friction", uniform(random, r.angularFriction)),
+                arg("battery", uniform(random, r.batteryVoltage))};
+  trial.args.insert(trial.args.end(), options.extraArgs.begin(), options.extraArgs.end());
+  return trial;
+}
+
+TrialResult MonteCarloRunner::runTrial(const Trial &itrial) const {
+  TrialResult result;
+  result.trial = itrial;
+
+  std::vector<std::string> argv{options.simulator};
+  argv.insert(argv.end(), itrial.args.begin(), itrial.args.end());
+
+  std::string output;
+  if (!runProcess(argv, output)) {
+    return result;
+  }
+
+  const auto line = output.rfind("result ");
+  int completed = 0;
+  if (line == std::string::npos ||
+      std::sscanf(output.c_str() + line,
+                  "result completed=%d time=%lf x=%lf y=%lf heading=%lf",
+                  &completed,
+                  &result.time,
+                  &result.x,
+                  &result.y,
+                  &result.heading) != 5) {
+    return result;
+  }
+
+  result.positionError = std::hypot(result.x - options.targetX, result.y - options.targetY);
+  result.headingError =
+    std::abs(std::remainder(result.heading - options.targetHeading, 360.0));
+
+  if (!completed) {
+    result.outcome = TrialResult::Outcome::timedOut;
+  } else if (result.positionError > options.positionTolerance ||
+             result.headingError > options.headingTolerance) {
+    result.outcome = TrialResult::Outcome::missedTarget;
+  } else {
+    result.outcome = TrialResult::Outcome::success;
+  }
+
+  return result;
+}
+
+std::vector<TrialResult> MonteCarloRunner::run() const {
+  std::vector<TrialResult> results(options.trials);
+  std::atomic<std::size_t> next{0};
+
+  std::vector<std::thread> workers;
+  for (std::size_t i = 0; i < std::min(getJobs(), options.trials); i++) {
+    workers.emplace_back([&]() {
+      for (std::size_t index = next++; index < options.trials; index = next++) {
+        results[index] = runTrial(makeTrial(index));
+      }
+    });
+  }
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  return results;
+}
+
+void MonteCarloRunner::printReport(const std::vector<TrialResult> &iresults,
+                                   std::FILE *ostream) const {
+  const std::size_t total = iresults.size();
+  std::fprintf(ostream, "Monte Carlo: %zu trials, %zu jobs\n", total, getJobs());
+  if (total == 0) {
+    return;
+  }
+
+  const TrialResult::Outcome outcomes[] = {TrialResult::Outcome::success,
+                                           TrialResult::Outcome::missedTarget,
+                                           TrialResult::Outcome::timedOut,
+                                           TrialResult::Outcome::crashed};
+  for (const auto outcome : outcomes) {
+    const auto count = std::count_if(iresults.begin(),
+                                     iresults.end(),
+                                     [&](const TrialResult &r) { return r.outcome == outcome; });
+    std::fprintf(ostream,
+                 "  %-14s %6zu (%5.1f%%)\n",
+                 outcomeName(outcome),
+                 static_cast<std::size_t>(count),
+                 100.0 * count / total);
+  }
+
+  // Completion time only means something for routines that finished; pose error is over every
+  // trial which produced a result
+  std::vector<double> times;
+  std::vector<double> positionErrors;
+  std::vector<double> headingErrors;
+  for (const auto &result : iresults) {
+    if (result.outcome == TrialResult::Outcome::crashed) {
+      continue;
+    }
+    if (result.outcome != TrialResult::Outcome::timedOut) {
+      times.push_back(result.time);
+    }
+    positionErrors.push_back(result.positionError);
+    headingErrors.push_back(result.headingError);
+  }
+
+  std::fprintf(ostream, "\n  %-20s %9s %9s %9s %9s\n", "", "p50", "p90", "p99", "max");
+  const auto row = [&](const char *iname, const std::vector<double> &ivalues) {
+    std::fprintf(ostream,
+                 "  %-20s %9.3f %9.3f %9.3f %9.3f\n",
+                 iname,
+                 percentile(ivalues, 50),
+                 percentile(ivalues, 90),
+                 percentile(ivalues, 99),
+                 percentile(ivalues, 100));
+  };
+  row("completion time (s)", times);
+  row("position error (m)", positionErrors);
+  row("heading error (deg)", headingErrors);
+
+  // Failures first, then the worst position error, so the top of the list is worth rerunning
+  std::vector<const TrialResult *> worst;
+  for (const auto &result : iresults) {
+    worst.push_back(&result);
+  }
+  std::sort(worst.begin(), worst.end(), [](const TrialResult *a, const TrialResult *b) {
+    const bool aFailed = a->outcome != TrialResult::Outcome::success;
+    const bool bFailed = b->outcome != TrialResult::Outcome::success;
+    return aFailed != bFailed ? aFailed : a->positionError > b->positionError;
+  });
+
+  std::fprintf(ostream, "\nWorst trials:\n");
+  for (std::size_t i = 0; i < std::min<std::size_t>(5, worst.size()); i++) {
+    std::fprintf(ostream,
+                 "  %s (%.3f m, %.1f deg): %s",
+                 outcomeName(worst[i]->outcome),
+                 worst[i]->positionError,
+                 worst[i]->headingError,
+                 options.simulator.c_str());
+    for (const auto &a : worst[i]->trial.args) {
+      std::fprintf(ostream, " %s", a.c_str());
+    }
+    std::fprintf(ostream, "\n");
+  }
+}
+
+double MonteCarloRunner::percentile(std::vector<double> ivalues, const double ip) {
+  if (ivalues.empty()) {
+    return 0;
+  }
+
+  const auto rank = static_cast<std::size_t>(std::ceil(ip / 100.0 * ivalues.size()));
+  const auto nth = ivalues.begin() + std::min(std::max<std::size_t>(rank, 1), ivalues.size()) - 1;
+  std::nth_element(ivalues.begin(), nth, ivalues.end());
+  return *nth;
+}
+
+std::size_t MonteCarloRunner::getJobs() const {
+  if (options.jobs != 0) {
+    return options.jobs;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+} // namespace sim
@@ -0,0 +1,159 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/chassisControllerIntegrated.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+
+namespace okapi {
+ChassisControllerIntegrated::ChassisControllerIntegrated(
+  const TimeUtil &itimeUtil,
+  std::shared_ptr<ChassisModel> imodel,
+  std::unique_ptr<AsyncPosIntegratedController> ileftController,
+  std::unique_ptr<AsyncPosIntegratedController> irightController,
+  const AbstractMotor::GearsetRatioPair &igearset,
+  const ChassisScales &iscales,
+  std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    chassisModel(std::move(imodel)),
+    timeUtil(itimeUtil),
+    leftController(std::move(ileftController)),
+    rightController(std::move(irightController)),
+    lastTarget(0),
+    scales(iscales),
+    gearsetRatioPair(igearset) {
+  if (igearset.ratio == 0) {
+    std::string msg = "ChassisControllerIntegrated: The gear ratio cannot be zero! Check if you "
+                      "are using integer division.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  chassisModel->setGearing(igearset.internalGearset);
+  chassisModel->setEncoderUnits(AbstractMotor::encoderUnits::degrees);
+}
+
+void ChassisControllerIntegrated::moveDistanceAsync(const QLength itarget) {
+  LOG_INFO("ChassisControllerIntegrated: moving " + std::to_string(itarget.convert(meter)) +
+           " meters");
+
+  const double newTarget = itarget.convert(meter) * scales.straight * gearsetRatioPair.ratio;
+  moveRawAsync(newTarget);
+}
+
+void ChassisControllerIntegrated::moveRawAsync(const double itarget) {
+  LOG_INFO("ChassisControllerIntegrated: moving " + std::to_string(itarget) + " motor degrees");
+
+  leftController->reset();
+  rightController->reset();
+  leftController->flipDisable(false);
+  rightController->flipDisable(false);
+  leftController->tarePosition();
+  rightController->tarePosition();
+  leftController->setTarget(itarget);
+  rightController->setTarget(itarget);
+  lastTarget = static_cast<int>(itarget);
+}
+
+void ChassisControllerIntegrated::moveDistance(const QLength itarget) {
+  moveDistanceAsync(itarget);
+  waitUntilSettled();
+}
+
+void ChassisControllerIntegrated::moveRaw(const double itarget) {
+  moveRawAsync(itarget);
+  waitUntilSettled();
+}
+
+void ChassisControllerIntegrated::turnAngleAsync(const QAngle idegTarget) {
+  LOG_INFO("ChassisControllerIntegrated: turning " + std::to_string(idegTarget.convert(degree)) +
+           " degrees");
+
+  const double newTarget = idegTarget.convert(degree) * scales.turn * gearsetRatioPair.ratio;
+  turnRawAsync(newTarget);
+}
+
+void ChassisControllerIntegrated::turnRawAsync(const double idegTarget) {
+  LOG_INFO("ChassisControllerIntegrated: turning " + std::to_string(idegTarget) +
+           " motor degrees");
+
+  const double target = idegTarget * boolToSign(normalTurns);
+
+  leftController->reset();
+  rightController->reset();
+  leftController->flipDisable(false);
+  rightController->flipDisable(false);
+  leftController->tarePosition();
+  rightController->tarePosition();
+  leftController->setTarget(target);
+  rightController->setTarget(-target);
+  lastTarget = static_cast<int>(target);
+}
+
+void ChassisControllerIntegrated::turnAngle(const QAngle idegTarget) {
+  turnAngleAsync(idegTarget);
+  waitUntilSettled();
+}
+
+void ChassisControllerIntegrated::turnRaw(const double idegTarget) {
+  turnRawAsync(idegTarget);
+  waitUntilSettled();
+}
+
+void ChassisControllerIntegrated::setTurnsMirrored(const bool ishouldMirror) {
+  normalTurns = !ishouldMirror;
+}
+
+bool ChassisControllerIntegrated::isSettled() {
+  return leftController->isSettled() && rightController->isSettled();
+}
+
+void ChassisControllerIntegrated::waitUntilSettled() {
+  LOG_INFO_S("ChassisControllerIntegrated: Waiting to settle");
+
+  auto rate = timeUtil.getRate();
+  while (!isSettled()) {
+    rate->delayUntil(motorUpdateRate);
+  }
+
+  leftController->flipDisable(true);
+  rightController->flipDisable(true);
+
+  LOG_INFO_S("ChassisControllerIntegrated: Done waiting to settle");
+}
+
+void ChassisControllerIntegrated::stop() {
+  LOG_INFO_S("ChassisControllerIntegrated: Stopping");
+
+  leftController->stop();
+  rightController->stop();
+  chassisModel->stop();
+}
+
+ChassisScales ChassisControllerIntegrated::getChassisScales() const {
+  return scales;
+}
+
+AbstractMotor::GearsetRatioPair ChassisControllerIntegrated::getGearsetRatioPair() const {
+  return gearsetRatioPair;
+}
+
+std::shared_ptr<ChassisModel> ChassisControllerIntegrated::getModel() {
+  return chassisModel;
+}
+
+ChassisModel &ChassisControllerIntegrated::model() {
+  return *chassisModel;
+}
+
+void ChassisControllerIntegrated::setMaxVelocity(const double imaxVelocity) {
+  chassisModel->setMaxVelocity(imaxVelocity);
+  leftController->setMaxVelocity(static_cast<std::int32_t>(imaxVelocity));
+  rightController->setMaxVelocity(static_cast<std::int32_t>(imaxVelocity));
+}
+
+double ChassisControllerIntegrated::getMaxVelocity() const {
+  return chassisModel->getMaxVelocity();
+}
+} // namespace okapi
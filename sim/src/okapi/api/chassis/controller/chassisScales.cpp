@@ -0,0 +1,54 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+
+namespace okapi {
+ChassisScales::ChassisScales(const std::initializer_list<QLength> &idimensions,
+                             const double itpr,
+                             const std::shared_ptr<Logger> &ilogger)
+  : tpr(itpr) {
+  validateInputSize(idimensions.size(), ilogger);
+
+  const std::vector<QLength> vec(idimensions);
+  wheelDiameter = vec.at(0);
+  wheelTrack = vec.at(1);
+  middleWheelDistance = vec.size() >= 3 ? vec.at(2) : 0_m;
+  middleWheelDiameter = vec.size() >= 4 ? vec.at(3) : wheelDiameter;
+
+  straight = 360 / (wheelDiameter.convert(meter) * pi);
+  turn = wheelTrack.convert(meter) / wheelDiameter.convert(meter);
+  middle = 360 / (middleWheelDiameter.convert(meter) * pi);
+}
+
+ChassisScales::ChassisScales(const std::initializer_list<double> &iscales,
+                             const double itpr,
+                             const std::shared_ptr<Logger> &ilogger)
+  : tpr(itpr) {
+  validateInputSize(iscales.size(), ilogger);
+
+  const std::vector<double> vec(iscales);
+  straight = vec.at(0);
+  turn = vec.at(1);
+  middleWheelDistance = (vec.size() >= 3 ? vec.at(2) : 0) * meter;
+  middle = vec.size() >= 4 ? vec.at(3) : straight;
+
+  wheelDiameter = 360 / (straight * pi) * meter;
+  wheelTrack = turn * wheelDiameter;
+  middleWheelDiameter = 360 / (middle * pi) * meter;
+}
+
+void ChassisScales::validateInputSize(const std::size_t inputSize,
+                                      const std::shared_ptr<Logger> &logger) {
+  if (inputSize < 2) {
+    std::string msg = "ChassisScales: The dimensions or scales list must contain at least two "
+                      "elements, but it contained " +
+                      std::to_string(inputSize) + " elements.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+} // namespace okapi
@@ -0,0 +1,241 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/model/xDriveModel.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+namespace {
+double deadband(const double ivalue, const double ithreshold) {
+  const double value = std::clamp(ivalue, -1.0, 1.0);
+  return std::abs(value) <= ithreshold ? 0 : value;
+}
+} // namespace
+
+XDriveModel::XDriveModel(std::shared_ptr<AbstractMotor> itopLeftMotor,
+                         std::shared_ptr<AbstractMotor> itopRightMotor,
+                         std::shared_ptr<AbstractMotor> ibottomRightMotor,
+                         std::shared_ptr<AbstractMotor> ibottomLeftMotor,
+                         std::shared_ptr<ContinuousRotarySensor> ileftEnc,
+                         std::shared_ptr<ContinuousRotarySensor> irightEnc,
+                         const double imaxVelocity,
+                         const double imaxVoltage)
+  : maxVelocity(imaxVelocity),
+    maxVoltage(imaxVoltage),
+    topLeftMotor(std::move(itopLeftMotor)),
+    topRightMotor(std::move(itopRightMotor)),
+    bottomRightMotor(std::move(ibottomRightMotor)),
+    bottomLeftMotor(std::move(ibottomLeftMotor)),
+    leftSensor(std::move(ileftEnc)),
+    rightSensor(std::move(irightEnc)) {
+}
+
+void XDriveModel::forward(const double ispeed) {
+  const double speed = std::clamp(ispeed, -1.0, 1.0) * maxVelocity;
+  topLeftMotor->moveVelocity(static_cast<std::int16_t>(speed));
+  topRightMotor->moveVelocity(static_cast<std::int16_t>(speed));
+  bottomRightMotor->moveVelocity(static_cast<std::int16_t>(speed));
+  bottomLeftMotor->moveVelocity(static_cast<std::int16_t>(speed));
+}
+
+void XDriveModel::driveVector(const double iforwardSpeed, const double iyaw) {
+  // Scale both sides down together so the ratio between them, and so the curvature, is kept
+  const double forwardSpeed = std::clamp(iforwardSpeed, -1.0, 1.0);
+  const double yaw = std::clamp(iyaw, -1.0, 1.0);
+
+  double leftOutput = forwardSpeed + yaw;
+  double rightOutput = forwardSpeed - yaw;
+  if (const double maxInputMag = std::max(std::abs(leftOutput), std::abs(rightOutput));
+      maxInputMag > 1) {
+    leftOutput /= maxInputMag;
+    rightOutput /= maxInputMag;
+  }
+
+  topLeftMotor->moveVelocity(static_cast<std::int16_t>(leftOutput * maxVelocity));
+  topRightMotor->moveVelocity(static_cast<std::int16_t>(rightOutput * maxVelocity));
+  bottomRightMotor->moveVelocity(static_cast<std::int16_t>(rightOutput * maxVelocity));
+  bottomLeftMotor->moveVelocity(static_cast<std::int16_t>(leftOutput * maxVelocity));
+}
+
+void XDriveModel::driveVectorVoltage(const double iforwardSpeed, const double iyaw) {
+  const double forwardSpeed = std::clamp(iforwardSpeed, -1.0, 1.0);
+  const double yaw = std::clamp(iyaw, -1.0, 1.0);
+
+  double leftOutput = forwardSpeed + yaw;
+  double rightOutput = forwardSpeed - yaw;
+  if (const double maxInputMag = std::max(std::abs(leftOutput), std::abs(rightOutput));
+      maxInputMag > 1) {
+    leftOutput /= maxInputMag;
+    rightOutput /= maxInputMag;
+  }
+
+  topLeftMotor->moveVoltage(static_cast<std::int16_t>(leftOutput * maxVoltage));
+  topRightMotor->moveVoltage(static_cast<std::int16_t>(rightOutput * maxVoltage));
+  bottomRightMotor->moveVoltage(static_cast<std::int16_t>(rightOutput * maxVoltage));
+  bottomLeftMotor->moveVoltage(static_cast<std::int16_t>(leftOutput * maxVoltage));
+}
+
+void XDriveModel::rotate(const double ispeed) {
+  const double speed = std::clamp(ispeed, -1.0, 1.0) * maxVelocity;
+  topLeftMotor->moveVelocity(static_cast<std::int16_t>(speed));
+  topRightMotor->moveVelocity(static_cast<std::int16_t>(-speed));
+  bottomRightMotor->moveVelocity(static_cast<std::int16_t>(-speed));
+  bottomLeftMotor->moveVelocity(static_cast<std::int16_t>(speed));
+}
+
+void XDriveModel::strafe(const double ispeed) {
+  const double speed = std::clamp(ispeed, -1.0, 1.0) * maxVelocity;
+  topLeftMotor->moveVelocity(static_cast<std::int16_t>(speed));
+  topRightMotor->moveVelocity(static_cast<std::int16_t>(-speed));
+  bottomRightMotor->moveVelocity(static_cast<std::int16_t>(speed));
+  bottomLeftMotor->moveVelocity(static_cast<std::int16_t>(-speed));
+}
+
+void XDriveModel::strafeVector(const double istrafeSpeed, const double iyaw) {
+  const double strafeSpeed = std::clamp(istrafeSpeed, -1.0, 1.0);
+  const double yaw = std::clamp(iyaw, -1.0, 1.0);
+
+  double leftOutput = strafeSpeed + yaw;
+  double rightOutput = strafeSpeed - yaw;
+  if (const double maxInputMag = std::max(std::abs(leftOutput), std::abs(rightOutput));
+      maxInputMag > 1) {
+    leftOutput /= maxInputMag;
+    rightOutput /= maxInputMag;
+  }
+
+  topLeftMotor->moveVelocity(static_cast<std::int16_t>(leftOutput * maxVelocity));
+  topRightMotor->moveVelocity(static_cast<std::int16_t>(-rightOutput * maxVelocity));
+  bottomRightMotor->moveVelocity(static_cast<std::int16_t>(rightOutput * maxVelocity));
+  bottomLeftMotor->moveVelocity(static_cast<std::int16_t>(-leftOutput * maxVelocity));
+}
+
+void XDriveModel::stop() {
+  topLeftMotor->moveVelocity(0);
+  topRightMotor->moveVelocity(0);
+  bottomRightMotor->moveVelocity(0);
+  bottomLeftMotor->moveVelocity(0);
+}
+
+void XDriveModel::tank(const double ileftSpeed,
+                       const double irightSpeed,
+                       const double ithreshold) {
+  const double leftSpeed = deadband(ileftSpeed, ithreshold);
+  const double rightSpeed = deadband(irightSpeed, ithreshold);
+
+  topLeftMotor->moveVoltage(static_cast<std::int16_t>(leftSpeed * maxVoltage));
+  topRightMotor->moveVoltage(static_cast<std::int16_t>(rightSpeed * maxVoltage));
+  bottomRightMotor->moveVoltage(static_cast<std::int16_t>(rightSpeed * maxVoltage));
+  bottomLeftMotor->moveVoltage(static_cast<std::int16_t>(leftSpeed * maxVoltage));
+}
+
+void XDriveModel::arcade(const double iforwardSpeed,
+                         const double iyaw,
+                         const double ithreshold) {
+  const double forwardSpeed = deadband(iforwardSpeed, ithreshold);
+  const double yaw = deadband(iyaw, ithreshold);
+
+  const double leftOutput = std::clamp(forwardSpeed + yaw, -1.0, 1.0);
+  const double rightOutput = std::clamp(forwardSpeed - yaw, -1.0, 1.0);
+
+  topLeftMotor->moveVoltage(static_cast<std::int16_t>(leftOutput * maxVoltage));
+  topRightMotor->moveVoltage(static_cast<std::int16_t>(rightOutput * maxVoltage));
+  bottomRightMotor->moveVoltage(static_cast<std::int16_t>(rightOutput * maxVoltage));
+  bottomLeftMotor->moveVoltage(static_cast<std::int16_t>(leftOutput * maxVoltage));
+}
+
+void XDriveModel::xArcade(const double irightSpeed,
+                          const double iforwardSpeed,
+                          const double iyaw,
+                          const double ithreshold) {
+  const double rightSpeed = deadband(irightSpeed, ithreshold);
+  const double forwardSpeed = deadband(iforwardSpeed, ithreshold);
+  const double yaw = deadband(iyaw, ithreshold);
+
+  const auto voltage = [&](const double ioutput) {
+    return static_cast<std::int16_t>(std::clamp(ioutput, -1.0, 1.0) * maxVoltage);
+  };
+
+  topLeftMotor->moveVoltage(voltage(forwardSpeed + rightSpeed + yaw));
+  topRightMotor->moveVoltage(voltage(forwardSpeed - rightSpeed - yaw));
+  bottomRightMotor->moveVoltage(voltage(forwardSpeed + rightSpeed - yaw));
+  bottomLeftMotor->moveVoltage(voltage(forwardSpeed - rightSpeed + yaw));
+}
+
+void XDriveModel::left(const double ispeed) {
+  const double speed = std::clamp(ispeed, -1.0, 1.0) * maxVelocity;
+  topLeftMotor->moveVelocity(static_cast<std::int16_t>(speed));
+  bottomLeftMotor->moveVelocity(static_cast<std::int16_t>(speed));
+}
+
+void XDriveModel::right(const double ispeed) {
+  const double speed = std::clamp(ispeed, -1.0, 1.0) * maxVelocity;
+  topRightMotor->moveVelocity(static_cast<std::int16_t>(speed));
+  bottomRightMotor->moveVelocity(static_cast<std::int16_t>(speed));
+}
+
+std::valarray<std::int32_t> XDriveModel::getSensorVals() const {
+  return std::valarray<std::int32_t>{static_cast<std::int32_t>(leftSensor->get()),
+                                     static_cast<std::int32_t>(rightSensor->get())};
+}
+
+void XDriveModel::resetSensors() {
+  leftSensor->reset();
+  rightSensor->reset();
+}
+
+void XDriveModel::setBrakeMode(const AbstractMotor::brakeMode mode) {
+  topLeftMotor->setBrakeMode(mode);
+  topRightMotor->setBrakeMode(mode);
+  bottomRightMotor->setBrakeMode(mode);
+  bottomLeftMotor->setBrakeMode(mode);
+}
+
+void XDriveModel::setEncoderUnits(const AbstractMotor::encoderUnits units) {
+  topLeftMotor->setEncoderUnits(units);
+  topRightMotor->setEncoderUnits(units);
+  bottomRightMotor->setEncoderUnits(units);
+  bottomLeftMotor->setEncoderUnits(units);
+}
+
+void XDriveModel::setGearing(const AbstractMotor::gearset gearset) {
+  topLeftMotor->setGearing(gearset);
+  topRightMotor->setGearing(gearset);
+  bottomRightMotor->setGearing(gearset);
+  bottomLeftMotor->setGearing(gearset);
+}
+
+void XDriveModel::setMaxVelocity(const double imaxVelocity) {
+  maxVelocity = std::max(imaxVelocity, 0.0);
+}
+
+double XDriveModel::getMaxVelocity() const {
+  return maxVelocity;
+}
+
+void XDriveModel::setMaxVoltage(const double imaxVoltage) {
+  maxVoltage = std::clamp(imaxVoltage, 0.0, 12000.0);
+}
+
+double XDriveModel::getMaxVoltage() const {
+  return maxVoltage;
+}
+
+std::shared_ptr<AbstractMotor> XDriveModel::getTopLeftMotor() const {
+  return topLeftMotor;
+}
+
+std::shared_ptr<AbstractMotor> XDriveModel::getTopRightMotor() const {
+  return topRightMotor;
+}
+
+std::shared_ptr<AbstractMotor> XDriveModel::getBottomRightMotor() const {
+  return bottomRightMotor;
+}
+
+std::shared_ptr<AbstractMotor> XDriveModel::getBottomLeftMotor() const {
+  return bottomLeftMotor;
+}
+} // namespace okapi
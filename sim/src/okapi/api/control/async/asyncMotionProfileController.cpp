@@ -0,0 +1,23 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncMotionProfileController.hpp"
+#include <stdexcept>
+
+// The host build cannot construct an AsyncMotionProfileController, see
+// AsyncMotionProfileControllerBuilder. These only exist so code which uses one still links.
+
+namespace okapi {
+void AsyncMotionProfileController::generatePath(std::initializer_list<PathfinderPoint>,
+                                                const std::string &) {
+  throw std::runtime_error(
+    "AsyncMotionProfileController: Motion profiles are not available in the host build.");
+}
+
+bool AsyncMotionProfileController::removePath(const std::string &) {
+  throw std::runtime_error(
+    "AsyncMotionProfileController: Motion profiles are not available in the host build.");
+}
+} // namespace okapi
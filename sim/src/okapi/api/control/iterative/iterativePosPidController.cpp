@@ -0,0 +1,217 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+IterativePosPIDController::IterativePosPIDController(const double ikP,
+                                                     const double ikI,
+                                                     const double ikD,
+                                                     const double ikBias,
+                                                     const TimeUtil &itimeUtil,
+                                                     std::unique_ptr<Filter> iderivativeFilter,
+                                                     std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    derivativeFilter(std::move(iderivativeFilter)),
+    loopDtTimer(itimeUtil.getTimer()),
+    settledUtil(itimeUtil.getSettledUtil()) {
+  if (ikI != 0) {
+    setIntegralLimits(0.4 / ikI, -0.4 / ikI);
+  }
+  setOutputLimits(1, -1);
+  setGains({ikP, ikI, ikD, ikBias});
+}
+
+IterativePosPIDController::IterativePosPIDController(const Gains &igains,
+                                                     const TimeUtil &itimeUtil,
+                                                     std::unique_ptr<Filter> iderivativeFilter,
+                                                     std::shared_ptr<Logger> ilogger)
+  : IterativePosPIDController(igains.kP,
+                              igains.kI,
+                              igains.kD,
+                              igains.kBias,
+                              itimeUtil,
+                              std::move(iderivativeFilter),
+                              std::move(ilogger)) {
+}
+
+bool IterativePosPIDController::Gains::operator==(const Gains &rhs) const {
+  return kP == rhs.kP && kI == rhs.kI && kD == rhs.kD && kBias == rhs.kBias;
+}
+
+bool IterativePosPIDController::Gains::operator!=(const Gains &rhs) const {
+  return !(rhs == *this);
+}
+
+double IterativePosPIDController::step(const double inewReading) {
+  if (controllerIsDisabled) {
+    return 0;
+  }
+
+  loopDtTimer->placeHardMark();
+
+  if (loopDtTimer->getDtFromHardMark() >= sampleTime) {
+    error = target - inewReading;
+
+    const double absError = std::abs(error);
+    if (absError >= errorSumMin && absError <= errorSumMax) {
+      integral += kI * error;
+    }
+
+    if (shouldResetOnCross && std::signbit(error) != std::signbit(lastError)) {
+      integral = 0;
+    }
+
+    integral = std::clamp(integral, integralMin, integralMax);
+
+    // Derivative on measurement, so changing the target does not kick the output
+    derivative = derivativeFilter->filter(inewReading - lastReading);
+
+    output = std::clamp(kP * error + integral - kD * derivative + kBias, outputMin, outputMax);
+
+    lastReading = inewReading;
+    lastError = error;
+    loopDtTimer->clearHardMark();
+  }
+
+  return output;
+}
+
+void IterativePosPIDController::setTarget(const double itarget) {
+  LOG_INFO("IterativePosPIDController: Set target to " + std::to_string(itarget));
+  target = itarget;
+}
+
+void IterativePosPIDController::controllerSet(const double ivalue) {
+  target = remapRange(ivalue, -1, 1, controllerSetTargetMin, controllerSetTargetMax);
+}
+
+double IterativePosPIDController::getTarget() {
+  return target;
+}
+
+double IterativePosPIDController::getTarget() const {
+  return target;
+}
+
+double IterativePosPIDController::getProcessValue() const {
+  return lastReading;
+}
+
+double IterativePosPIDController::getOutput() const {
+  return isDisabled() ? 0 : output;
+}
+
+double IterativePosPIDController::getMaxOutput() {
+  return outputMax;
+}
+
+double IterativePosPIDController::getMinOutput() {
+  return outputMin;
+}
+
+double IterativePosPIDController::getError() const {
+  return error;
+}
+
+bool IterativePosPIDController::isSettled() {
+  return isDisabled() || settledUtil->isSettled(error);
+}
+
+void IterativePosPIDController::setSampleTime(const QTime isampleTime) {
+  if (isampleTime > 0_ms) {
+    const double ratio = isampleTime.convert(second) / sampleTime.convert(second);
+    kI *= ratio;
+    kD /= ratio;
+    sampleTime = isampleTime;
+  }
+}
+
+void IterativePosPIDController::setOutputLimits(double imax, double imin) {
+  if (imin > imax) {
+    std::swap(imin, imax);
+  }
+
+  outputMax = imax;
+  outputMin = imin;
+  output = std::clamp(output, outputMin, outputMax);
+}
+
+void IterativePosPIDController::setControllerSetTargetLimits(double itargetMax,
+                                                             double itargetMin) {
+  if (itargetMin > itargetMax) {
+    std::swap(itargetMin, itargetMax);
+  }
+
+  controllerSetTargetMax = itargetMax;
+  controllerSetTargetMin = itargetMin;
+}
+
+void IterativePosPIDController::setIntegralLimits(double imax, double imin) {
+  if (imin > imax) {
+    std::swap(imin, imax);
+  }
+
+  integralMax = imax;
+  integralMin = imin;
+  integral = std::clamp(integral, integralMin, integralMax);
+}
+
+void IterativePosPIDController::setErrorSumLimits(double imax, double imin) {
+  if (imin > imax) {
+    std::swap(imin, imax);
+  }
+
+  errorSumMax = imax;
+  errorSumMin = imin;
+}
+
+void IterativePosPIDController::setIntegratorReset(const bool iresetOnZero) {
+  shouldResetOnCross = iresetOnZero;
+}
+
+void IterativePosPIDController::setGains(const Gains &igains) {
+  const double sampleTimeSec = sampleTime.convert(second);
+  kP = igains.kP;
+  kI = igains.kI * sampleTimeSec;
+  kD = igains.kD / sampleTimeSec;
+  kBias = igains.kBias;
+}
+
+IterativePosPIDController::Gains IterativePosPIDController::getGains() const {
+  const double sampleTimeSec = sampleTime.convert(second);
+  return {kP, kI / sampleTimeSec, kD * sampleTimeSec, kBias};
+}
+
+void IterativePosPIDController::reset() {
+  LOG_INFO_S("IterativePosPIDController: Reset");
+  error = 0;
+  lastError = 0;
+  lastReading = 0;
+  integral = 0;
+  output = 0;
+  settledUtil->reset();
+}
+
+void IterativePosPIDController::flipDisable() {
+  flipDisable(!controllerIsDisabled);
+}
+
+void IterativePosPIDController::flipDisable(const bool iisDisabled) {
+  LOG_INFO("IterativePosPIDController: flipDisable " + std::to_string(iisDisabled));
+  controllerIsDisabled = iisDisabled;
+}
+
+bool IterativePosPIDController::isDisabled() const {
+  return controllerIsDisabled;
+}
+
+QTime IterativePosPIDController::getSampleTime() const {
+  return sampleTime;
+}
+} // namespace okapi
@@ -0,0 +1,106 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/flywheelSimulator.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+FlywheelSimulator::FlywheelSimulator(const double imass,
+                                     const double ilinkLen,
+                                     const double imuStatic,
+                                     const double imuDynamic,
+                                     const double itimestep)
+  : mass(imass),
+    linkLen(ilinkLen),
+    muStatic(imuStatic),
+    muDynamic(imuDynamic),
+    timestep(itimestep),
+    I(imass * ilinkLen * ilinkLen),
+    torqueFunc([](const double iangle, const double imass, const double ilinkLength) {
+      return ilinkLength * std::cos(iangle) * imass * -9.80665;
+    }) {
+}
+
+FlywheelSimulator::~FlywheelSimulator() = default;
+
+double FlywheelSimulator::step() {
+  return stepImpl();
+}
+
+double FlywheelSimulator::step(const double itorque) {
+  setTorque(itorque);
+  return stepImpl();
+}
+
+double FlywheelSimulator::stepImpl() {
+  const double torque = inputTorque + torqueFunc(angle, mass, linkLen);
+
+  // Static friction holds the link until the torque overcomes it, and dynamic friction opposes
+  // the motion in proportion to the speed
+  const double netTorque =
+    omega == 0 && std::abs(torque) <= muStatic ? 0 : torque - muDynamic * omega;
+
+  accel = netTorque / I;
+  omega += accel * timestep;
+  angle += omega * timestep;
+  return angle;
+}
+
+void FlywheelSimulator::setExternalTorqueFunction(
+  std::function<double(double angle, double mass, double linkLength)> itorqueFunc) {
+  torqueFunc = std::move(itorqueFunc);
+}
+
+void FlywheelSimulator::setTorque(const double itorque) {
+  inputTorque = std::clamp(itorque, -maxTorque, maxTorque);
+}
+
+void FlywheelSimulator::setMaxTorque(const double imaxTorque) {
+  maxTorque = std::abs(imaxTorque);
+}
+
+void FlywheelSimulator::setAngle(const double iangle) {
+  angle = iangle;
+}
+
+void FlywheelSimulator::setMass(const double imass) {
+  mass = imass;
+  I = mass * linkLen * linkLen;
+}
+
+void FlywheelSimulator::setLinkLength(const double ilinkLen) {
+  linkLen = ilinkLen;
+  I = mass * linkLen * linkLen;
+}
+
+void FlywheelSimulator::setStaticFriction(const double imuStatic) {
+  muStatic = imuStatic;
+}
+
+void FlywheelSimulator::setDynamicFriction(const double imuDynamic) {
+  muDynamic = imuDynamic;
+}
+
+void FlywheelSimulator::setTimestep(const double itimestep) {
+  timestep = std::max(itimestep, minTimestep);
+}
+
+double FlywheelSimulator::getAngle() const {
+  return angle;
+}
+
+double FlywheelSimulator::getOmega() const {
+  return omega;
+}
+
+double FlywheelSimulator::getAcceleration() const {
+  return accel;
+}
+
+double FlywheelSimulator::getMaxTorque() const {
+  return maxTorque;
+}
+} // namespace okapi
@@ -0,0 +1,28 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/composableFilter.hpp"
+
+namespace okapi {
+ComposableFilter::ComposableFilter(const std::initializer_list<std::shared_ptr<Filter>> &ilist)
+  : filters(ilist) {
+}
+
+double ComposableFilter::filter(const double ireading) {
+  output = ireading;
+  for (auto &filter : filters) {
+    output = filter->filter(output);
+  }
+  return output;
+}
+
+double ComposableFilter::getOutput() const {
+  return output;
+}
+
+void ComposableFilter::addFilter(std::shared_ptr<Filter> ifilter) {
+  filters.push_back(std::move(ifilter));
+}
+} // namespace okapi
@@ -0,0 +1,56 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/velMath.hpp"
+
+namespace okapi {
+VelMath::VelMath(const double iticksPerRev,
+                 std::unique_ptr<Filter> ifilter,
+                 const QTime isampleTime,
+                 std::unique_ptr<AbstractTimer> iloopDtTimer,
+                 std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    ticksPerRev(iticksPerRev),
+    sampleTime(isampleTime),
+    loopDtTimer(std::move(iloopDtTimer)),
+    filter(std::move(ifilter)) {
+  if (iticksPerRev == 0) {
+    std::string msg = "VelMath: The ticks per revolution cannot be zero! Check if you are using "
+                      "integer division.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+VelMath::~VelMath() = default;
+
+QAngularSpeed VelMath::step(const double inewPos) {
+  const QTime dt = loopDtTimer->readDt();
+
+  if (dt >= sampleTime) {
+    const double revs = (inewPos - lastPos) / ticksPerRev;
+    vel = filter->filter(revs / dt.convert(minute)) * rpm;
+    accel = (vel - lastVel) / dt;
+
+    lastVel = vel;
+    lastPos = inewPos;
+    loopDtTimer->getDt();
+  }
+
+  return vel;
+}
+
+void VelMath::setTicksPerRev(const double iTPR) {
+  ticksPerRev = iTPR;
+}
+
+QAngularSpeed VelMath::getVelocity() const {
+  return vel;
+}
+
+QAngularAcceleration VelMath::getAccel() const {
+  return accel;
+}
+} // namespace okapi
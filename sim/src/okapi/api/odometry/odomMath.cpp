@@ -0,0 +1,47 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/odomMath.hpp"
+#include <cmath>
+
+namespace okapi {
+QLength OdomMath::computeDistanceToPoint(const Point &ipoint, const OdomState &istate) {
+  const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+  return computeDistance(xDiff, yDiff) * meter;
+}
+
+QAngle OdomMath::computeAngleToPoint(const Point &ipoint, const OdomState &istate) {
+  const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+  return computeAngle(xDiff, yDiff, istate.theta.convert(radian)) * radian;
+}
+
+std::pair<QLength, QAngle> OdomMath::computeDistanceAndAngleToPoint(const Point &ipoint,
+                                                                    const OdomState &istate) {
+  const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+  return std::make_pair(computeDistance(xDiff, yDiff) * meter,
+                        computeAngle(xDiff, yDiff, istate.theta.convert(radian)) * radian);
+}
+
+std::pair<double, double> OdomMath::computeDiffs(const Point &ipoint, const OdomState &istate) {
+  return std::make_pair(ipoint.x.convert(meter) - istate.x.convert(meter),
+                        ipoint.y.convert(meter) - istate.y.convert(meter));
+}
+
+double OdomMath::computeDistance(const double xDiff, const double yDiff) {
+  return std::sqrt(xDiff * xDiff + yDiff * yDiff);
+}
+
+double OdomMath::computeAngle(const double xDiff, const double yDiff, const double theta) {
+  return constrainAngle180((std::atan2(yDiff, xDiff) - theta) * radian).convert(radian);
+}
+
+QAngle OdomMath::constrainAngle360(const QAngle &angle) {
+  return angle - 360_deg * std::floor(angle.convert(degree) / 360);
+}
+
+QAngle OdomMath::constrainAngle180(const QAngle &angle) {
+  return angle - 360_deg * std::floor((angle.convert(degree) + 180) / 360);
+}
+} // namespace okapi
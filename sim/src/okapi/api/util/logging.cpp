@@ -0,0 +1,59 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/logging.hpp"
+#include <cstdio>
+#include <unistd.h>
+
+namespace okapi {
+std::shared_ptr<Logger> defaultLogger;
+int DefaultLoggerInitializer::count = 0;
+
+namespace {
+/**
+ * Opens a file the way the brain would. The serial streams have no file on the host, so they
+ * write to copies of stdout and stderr, which the Logger can close without closing those.
+ */
+FILE *openLogFile(const std::string_view ifileName, const char *imode) {
+  const std::string name(ifileName);
+  if (name == "/ser/sout" || name == "/ser/serr") {
+    const int fd = dup(name == "/ser/sout" ? STDOUT_FILENO : STDERR_FILENO);
+    return fd >= 0 ? fdopen(fd, imode) : nullptr;
+  }
+  return fopen(name.c_str(), imode);
+}
+} // namespace
+
+Logger::Logger() noexcept : Logger(nullptr, static_cast<FILE *>(nullptr), LogLevel::off) {
+}
+
+Logger::Logger(std::unique_ptr<AbstractTimer> itimer,
+               const std::string_view ifileName,
+               const LogLevel &ilevel) noexcept
+  : Logger(std::move(itimer),
+           openLogFile(ifileName, isSerialStream(ifileName) ? "w" : "a"),
+           ilevel) {
+}
+
+Logger::Logger(std::unique_ptr<AbstractTimer> itimer, FILE *ifile, const LogLevel &ilevel) noexcept
+  : timer(std::move(itimer)), logLevel(ilevel), logfile(ifile) {
+}
+
+Logger::~Logger() {
+  close();
+}
+
+std::shared_ptr<Logger> Logger::getDefaultLogger() {
+  return defaultLogger;
+}
+
+void Logger::setDefaultLogger(std::shared_ptr<Logger> ilogger) {
+  defaultLogger = std::move(ilogger);
+}
+
+bool Logger::isSerialStream(const std::string_view filename) {
+  return filename.find("/ser/") != std::string_view::npos;
+}
+} // namespace okapi
@@ -0,0 +1,151 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/chassis/controller/chassisControllerBuilder.hpp"
+#include <stdexcept>
+
+// The host build implements the X-drive parts of the builder which this project uses. Building a
+// skid-steer or H-drive chassis, or one with odometry, throws.
+
+namespace okapi {
+ChassisControllerBuilder::ChassisControllerBuilder(const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger) {
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withMotors(const Motor &itopLeft,
+                                                               const Motor &itopRight,
+                                                               const Motor &ibottomRight,
+                                                               const Motor &ibottomLeft) {
+  hasMotors = true;
+  driveMode = DriveMode::XDrive;
+  xDriveMotors = {std::make_shared<Motor>(itopLeft),
+                  std::make_shared<Motor>(itopRight),
+                  std::make_shared<Motor>(ibottomRight),
+                  std::make_shared<Motor>(ibottomLeft)};
+
+  if (!sensorsSetByUser) {
+    leftSensor = xDriveMotors.topLeft->getEncoder();
+    rightSensor = xDriveMotors.topRight->getEncoder();
+  }
+
+  return *this;
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withGains(const IterativePosPIDController::Gains &idistanceGains,
+                                    const IterativePosPIDController::Gains &iturnGains,
+                                    const IterativePosPIDController::Gains &iangleGains) {
+  hasGains = true;
+  distanceGains = idistanceGains;
+  turnGains = iturnGains;
+  angleGains = iangleGains;
+  return *this;
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withDimensions(const AbstractMotor::GearsetRatioPair &igearset,
+                                         const ChassisScales &iscales) {
+  gearset = igearset;
+  driveScales = iscales;
+
+  if (!maxVelSetByUser) {
+    maxVelocity = toUnderlyingType(igearset.internalGearset);
+  }
+
+  return *this;
+}
+
+std::shared_ptr<ChassisController> ChassisControllerBuilder::build() {
+  if (!hasMotors) {
+    std::string msg = "ChassisControllerBuilder: No motors given.";
+    LOG_ERROR(msg);
+    throw std::runtime_error(msg);
+  }
+
+  if (gearset.internalGearset == AbstractMotor::gearset::invalid) {
+    std::string msg = "ChassisControllerBuilder: No gearset given.";
+    LOG_ERROR(msg);
+    throw std::runtime_error(msg);
+  }
+
+  if (hasOdom || driveMode != DriveMode::XDrive) {
+    std::string msg = "ChassisControllerBuilder: Only X-drives without odometry are available in "
+                      "the host build.";
+    LOG_ERROR(msg);
+    throw std::runtime_error(msg);
+  }
+
+  if (hasGains) {
+    return buildCCPID();
+  } else {
+    return buildCCI();
+  }
+}
+
+std::shared_ptr<ChassisControllerPID> ChassisControllerBuilder::buildCCPID() {
+  auto out = std::make_shared<ChassisControllerPID>(
+    chassisControllerTimeUtilFactory.create(),
+    makeChassisModel(),
+    std::make_unique<IterativePosPIDController>(distanceGains,
+                                                closedLoopControllerTimeUtilFactory.create(),
+                                                std::move(distanceFilter),
+                                                controllerLogger),
+    std::make_unique<IterativePosPIDController>(turnGains,
+                                                closedLoopControllerTimeUtilFactory.create(),
+                                                std::move(turnFilter),
+                                                controllerLogger),
+    std::make_unique<IterativePosPIDController>(angleGains,
+                                                closedLoopControllerTimeUtilFactory.create(),
+                                                std::move(angleFilter),
+                                                controllerLogger),
+    gearset,
+    driveScales,
+    controllerLogger);
+
+  out->startThread();
+
+  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+    out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+  }
+
+  return out;
+}
+
+std::shared_ptr<ChassisControllerIntegrated> ChassisControllerBuilder::buildCCI() {
+  // The integrated controllers run on the motors the odometry sensors come from, so like
+  // OkapiLib's, a ChassisControllerIntegrated on an X-drive only drives its top motors
+  return std::make_shared<ChassisControllerIntegrated>(
+    chassisControllerTimeUtilFactory.create(),
+    makeChassisModel(),
+    std::make_unique<AsyncPosIntegratedController>(xDriveMotors.topLeft,
+                                                   gearset,
+                                                   static_cast<std::int32_t>(maxVelocity),
+                                                   closedLoopControllerTimeUtilFactory.create(),
+                                                   controllerLogger),
+    std::make_unique<AsyncPosIntegratedController>(xDriveMotors.topRight,
+                                                   gearset,
+                                                   static_cast<std::int32_t>(maxVelocity),
+                                                   closedLoopControllerTimeUtilFactory.create(),
+                                                   controllerLogger),
+    gearset,
+    driveScales,
+    controllerLogger);
+}
+
+std::shared_ptr<ChassisModel> ChassisControllerBuilder::makeChassisModel() {
+  return makeXDriveModel();
+}
+
+std::shared_ptr<XDriveModel> ChassisControllerBuilder::makeXDriveModel() {
+  return std::make_shared<XDriveModel>(xDriveMotors.topLeft,
+                                       xDriveMotors.topRight,
+                                       xDriveMotors.bottomRight,
+                                       xDriveMotors.bottomLeft,
+                                       leftSensor,
+                                       rightSensor,
+                                       maxVelocity,
+                                       maxVoltage);
+}
+} // namespace okapi
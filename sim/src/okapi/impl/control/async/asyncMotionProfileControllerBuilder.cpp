@@ -0,0 +1,41 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/control/async/asyncMotionProfileControllerBuilder.hpp"
+#include <stdexcept>
+
+// Motion profiles are generated by Pathfinder, which is only built for the brain, so the host
+// build accepts a builder's settings but cannot build the controller.
+
+namespace okapi {
+AsyncMotionProfileControllerBuilder::AsyncMotionProfileControllerBuilder(
+  const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger) {
+}
+
+AsyncMotionProfileControllerBuilder &AsyncMotionProfileControllerBuilder::withOutput(
+  const std::shared_ptr<ChassisController> &icontroller) {
+  hasModel = true;
+  model = icontroller->getModel();
+  scales = icontroller->getChassisScales();
+  pair = icontroller->getGearsetRatioPair();
+  return *this;
+}
+
+AsyncMotionProfileControllerBuilder &
+AsyncMotionProfileControllerBuilder::withLimits(const PathfinderLimits &ilimits) {
+  hasLimits = true;
+  limits = ilimits;
+  return *this;
+}
+
+std::shared_ptr<AsyncMotionProfileController>
+AsyncMotionProfileControllerBuilder::buildMotionProfileController() {
+  std::string msg = "AsyncMotionProfileControllerBuilder: Motion profiles are not available in "
+                    "the host build.";
+  LOG_ERROR(msg);
+  throw std::runtime_error(msg);
+}
+} // namespace okapi
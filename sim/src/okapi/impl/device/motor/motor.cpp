@@ -0,0 +1,233 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/motor/motor.hpp"
+#include "okapi/impl/device/rotarysensor/integratedEncoder.hpp"
+#include <cerrno>
+#include <cstdlib>
+
+namespace okapi {
+namespace {
+pros::motor_gearset_e_t toPros(const AbstractMotor::gearset igearset) {
+  switch (igearset) {
+  case AbstractMotor::gearset::red:
+    return pros::E_MOTOR_GEARSET_36;
+  case AbstractMotor::gearset::blue:
+    return pros::E_MOTOR_GEARSET_06;
+  case AbstractMotor::gearset::green:
+  default:
+    return pros::E_MOTOR_GEARSET_18;
+  }
+}
+} // namespace
+
+Motor::Motor(const std::int8_t iport)
+  : Motor(static_cast<std::uint8_t>(std::abs(iport)),
+          iport < 0,
+          AbstractMotor::gearset::green,
+          AbstractMotor::encoderUnits::counts) {
+}
+
+Motor::Motor(const std::uint8_t iport,
+             const bool ireverse,
+             const AbstractMotor::gearset igearset,
+             const AbstractMotor::encoderUnits iencoderUnits,
+             const std::shared_ptr<Logger> &logger)
+  : port(iport), reversed(ireverse ? -1 : 1) {
+  if (port < 1 || port > 21) {
+    LOG_ERROR("Motor: The port number (" + std::to_string(port) +
+              ") is outside the expected range of values [1, 21].");
+  }
+
+  setGearing(igearset);
+  setEncoderUnits(iencoderUnits);
+}
+
+std::int32_t Motor::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+  return pros::c::motor_move_absolute(port, iposition * reversed, ivelocity);
+}
+
+std::int32_t Motor::moveRelative(const double iposition, const std::int32_t ivelocity) {
+  return pros::c::motor_move_relative(port, iposition * reversed, ivelocity);
+}
+
+std::int32_t Motor::moveVelocity(const std::int16_t ivelocity) {
+  return pros::c::motor_move_velocity(port, ivelocity * reversed);
+}
+
+std::int32_t Motor::moveVoltage(const std::int16_t ivoltage) {
+  return pros::c::motor_move_voltage(port, ivoltage * reversed);
+}
+
+std::int32_t Motor::modifyProfiledVelocity(const std::int32_t ivelocity) {
+  return pros::c::motor_modify_profiled_velocity(port, ivelocity);
+}
+
+double Motor::getTargetPosition() {
+  return pros::c::motor_get_target_position(port) * reversed;
+}
+
+double Motor::getPosition() {
+  return pros::c::motor_get_position(port) * reversed;
+}
+
+std::int32_t Motor::tarePosition() {
+  return pros::c::motor_tare_position(port);
+}
+
+std::int32_t Motor::getTargetVelocity() {
+  return pros::c::motor_get_target_velocity(port) * reversed;
+}
+
+double Motor::getActualVelocity() {
+  return pros::c::motor_get_actual_velocity(port) * reversed;
+}
+
+std::int32_t Motor::getCurrentDraw() {
+  return pros::c::motor_get_current_draw(port);
+}
+
+std::int32_t Motor::getDirection() {
+  return pros::c::motor_get_direction(port) * reversed;
+}
+
+double Motor::getEfficiency() {
+  return pros::c::motor_get_efficiency(port);
+}
+
+std::int32_t Motor::isOverCurrent() {
+  return pros::c::motor_is_over_current(port);
+}
+
+std::int32_t Motor::isOverTemp() {
+  return pros::c::motor_is_over_temp(port);
+}
+
+std::int32_t Motor::isStopped() {
+  return pros::c::motor_is_stopped(port);
+}
+
+std::int32_t Motor::getZeroPositionFlag() {
+  return pros::c::motor_get_zero_position_flag(port);
+}
+
+uint32_t Motor::getFaults() {
+  return pros::c::motor_get_faults(port);
+}
+
+uint32_t Motor::getFlags() {
+  return pros::c::motor_get_flags(port);
+}
+
+std::int32_t Motor::getRawPosition(std::uint32_t *timestamp) {
+  return pros::c::motor_get_raw_position(port, timestamp);
+}
+
+double Motor::getPower() {
+  return pros::c::motor_get_power(port);
+}
+
+double Motor::getTemperature() {
+  return pros::c::motor_get_temperature(port);
+}
+
+double Motor::getTorque() {
+  return pros::c::motor_get_torque(port);
+}
+
+std::int32_t Motor::getVoltage() {
+  return pros::c::motor_get_voltage(port);
+}
+
+std::int32_t Motor::setBrakeMode(const AbstractMotor::brakeMode imode) {
+  return pros::c::motor_set_brake_mode(port, static_cast<pros::motor_brake_mode_e_t>(imode));
+}
+
+AbstractMotor::brakeMode Motor::getBrakeMode() {
+  return static_cast<brakeMode>(pros::c::motor_get_brake_mode(port));
+}
+
+std::int32_t Motor::setCurrentLimit(const std::int32_t ilimit) {
+  return pros::c::motor_set_current_limit(port, ilimit);
+}
+
+std::int32_t Motor::getCurrentLimit() {
+  return pros::c::motor_get_current_limit(port);
+}
+
+std::int32_t Motor::setEncoderUnits(const AbstractMotor::encoderUnits iunits) {
+  return pros::c::motor_set_encoder_units(port,
+                                          static_cast<pros::motor_encoder_units_e_t>(iunits));
+}
+
+AbstractMotor::encoderUnits Motor::getEncoderUnits() {
+  return static_cast<encoderUnits>(pros::c::motor_get_encoder_units(port));
+}
+
+std::int32_t Motor::setGearing(const AbstractMotor::gearset igearset) {
+  return pros::c::motor_set_gearing(port, toPros(igearset));
+}
+
+AbstractMotor::gearset Motor::getGearing() {
+  switch (pros::c::motor_get_gearing(port)) {
+  case pros::E_MOTOR_GEARSET_36:
+    return gearset::red;
+  case pros::E_MOTOR_GEARSET_18:
+    return gearset::green;
+  case pros::E_MOTOR_GEARSET_06:
+    return gearset::blue;
+  default:
+    return gearset::invalid;
+  }
+}
+
+std::int32_t Motor::setReversed(const bool ireverse) {
+  reversed = ireverse ? -1 : 1;
+  return 1;
+}
+
+std::int32_t Motor::setVoltageLimit(const std::int32_t ilimit) {
+  return pros::c::motor_set_voltage_limit(port, ilimit);
+}
+
+// The simulated motors follow their targets exactly and have no internal PID to tune
+std::int32_t Motor::setPosPID(double, double, double, double) {
+  errno = ENOSYS;
+  return PROS_ERR;
+}
+
+std::int32_t
+Motor::setPosPIDFull(double, double, double, double, double, double, double, double) {
+  errno = ENOSYS;
+  return PROS_ERR;
+}
+
+std::int32_t Motor::setVelPID(double, double, double, double) {
+  errno = ENOSYS;
+  return PROS_ERR;
+}
+
+std::int32_t
+Motor::setVelPIDFull(double, double, double, double, double, double, double, double) {
+  errno = ENOSYS;
+  return PROS_ERR;
+}
+
+std::shared_ptr<ContinuousRotarySensor> Motor::getEncoder() {
+  return std::make_shared<IntegratedEncoder>(*this);
+}
+
+void Motor::controllerSet(const double ivalue) {
+  moveVelocity(static_cast<std::int16_t>(ivalue * static_cast<int>(getGearing())));
+}
+
+std::uint8_t Motor::getPort() const {
+  return port;
+}
+
+bool Motor::isReversed() const {
+  return reversed < 0;
+}
+} // namespace okapi
@@ -0,0 +1,58 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/process.hpp"
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+namespace sim {
+bool runProcess(const std::vector<std::string> &iargv, std::string &ooutput, const int istdin) {
+  ooutput.clear();
+  if (iargv.empty()) {
+    return false;
+  }
+
+  std::vector<char *> argv;
+  for (const auto &a : iargv) {
+    argv.push_back(const_cast<char *>(a.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  int pipeFds[2];
+  if (pipe(pipeFds) != 0) {
+    return false;
+  }
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  if (istdin >= 0) {
+    posix_spawn_file_actions_adddup2(&actions, istdin, STDIN_FILENO);
+  }
+  posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+  posix_spawn_file_actions_addclose(&actions, pipeFds[0]);
+  posix_spawn_file_actions_addclose(&actions, pipeFds[1]);
+  posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+  pid_t pid;
+  const int spawned = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  close(pipeFds[1]);
+
+  char buffer[4096];
+  ssize_t count;
+  while ((count = read(pipeFds[0], buffer, sizeof(buffer))) > 0) {
+    ooutput.append(buffer, static_cast<std::size_t>(count));
+  }
+  close(pipeFds[0]);
+
+  int status = 0;
+  return spawned == 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+         WEXITSTATUS(status) == 0;
+}
+} // namespace sim
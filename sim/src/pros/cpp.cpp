@@ -0,0 +1,404 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "pros/gps.hpp"
+#include "pros/imu.hpp"
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+#include "pros/serial.hpp"
+
+/**
+ * The C++ classes are thin wrappers over the C API, as in PROS.
+ */
+namespace pros {
+Task::Task(task_fn_t function,
+           void *parameters,
+           std::uint32_t prio,
+           std::uint16_t stack_depth,
+           const char *name)
+  : task(c::task_create(function, parameters, prio, stack_depth, name)) {
+}
+
+Task::Task(task_fn_t function, void *parameters, const char *name)
+  : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {
+}
+
+Task::Task(task_t task) : task(task) {
+}
+
+Task Task::current() {
+  return Task(c::task_get_current());
+}
+
+Task &Task::operator=(const task_t in) {
+  task = in;
+  return *this;
+}
+
+void Task::remove() {
+  c::task_delete(task);
+}
+
+std::uint32_t Task::get_priority(void) {
+  return c::task_get_priority(task);
+}
+
+void Task::set_priority(std::uint32_t prio) {
+  c::task_set_priority(task, prio);
+}
+
+std::uint32_t Task::get_state(void) {
+  return c::task_get_state(task);
+}
+
+void Task::suspend(void) {
+  c::task_suspend(task);
+}
+
+void Task::resume(void) {
+  c::task_resume(task);
+}
+
+const char *Task::get_name(void) {
+  return c::task_get_name(task);
+}
+
+std::uint32_t Task::notify(void) {
+  return c::task_notify(task);
+}
+
+std::uint32_t
+Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t *prev_value) {
+  return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+  return c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear(void) {
+  return c::task_notify_clear(task);
+}
+
+void Task::delay(const std::uint32_t milliseconds) {
+  c::task_delay(milliseconds);
+}
+
+void Task::delay_until(std::uint32_t *const prev_time, const std::uint32_t delta) {
+  c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count(void) {
+  return c::task_get_count();
+}
+
+Mutex::Mutex(void) : mutex(c::mutex_create(), c::mutex_delete) {
+}
+
+bool Mutex::take(std::uint32_t timeout) {
+  return c::mutex_take(mutex.get(), timeout);
+}
+
+bool Mutex::give(void) {
+  return c::mutex_give(mutex.get());
+}
+
+Controller::Controller(controller_id_e_t id) : _id(id) {
+}
+
+std::int32_t Controller::is_connected(void) {
+  return c::controller_is_connected(_id);
+}
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) {
+  return c::controller_get_analog(_id, channel);
+}
+
+std::int32_t Controller::get_battery_capacity(void) {
+  return c::controller_get_battery_capacity(_id);
+}
+
+std::int32_t Controller::get_battery_level(void) {
+  return c::controller_get_battery_level(_id);
+}
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) {
+  return c::controller_get_digital(_id, button);
+}
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+  return c::controller_get_digital_new_press(_id, button);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char *str) {
+  return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string &str) {
+  return c::controller_set_text(_id, line, col, str.c_str());
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) {
+  return c::controller_clear_line(_id, line);
+}
+
+std::int32_t Controller::rumble(const char *rumble_pattern) {
+  return c::controller_rumble(_id, rumble_pattern);
+}
+
+std::int32_t Controller::clear(void) {
+  return c::controller_clear(_id);
+}
+
+namespace battery {
+double get_capacity(void) {
+  return c::battery_get_capacity();
+}
+
+int32_t get_current(void) {
+  return c::battery_get_current();
+}
+
+double get_temperature(void) {
+  return c::battery_get_temperature();
+}
+
+int32_t get_voltage(void) {
+  return c::battery_get_voltage();
+}
+} // namespace battery
+
+namespace competition {
+std::uint8_t get_status(void) {
+  return c::competition_get_status();
+}
+
+std::uint8_t is_autonomous(void) {
+  return (c::competition_get_status() & COMPETITION_AUTONOMOUS) != 0;
+}
+
+std::uint8_t is_connected(void) {
+  return (c::competition_get_status() & COMPETITION_CONNECTED) != 0;
+}
+
+std::uint8_t is_disabled(void) {
+  return (c::competition_get_status() & COMPETITION_DISABLED) != 0;
+}
+} // namespace competition
+
+namespace usd {
+std::int32_t is_installed(void) {
+  return c::usd_is_installed();
+}
+} // namespace usd
+
+std::int32_t Gps::initialize_full(double xInitial,
+                                  double yInitial,
+                                  double headingInitial,
+                                  double xOffset,
+                                  double yOffset) const {
+  return c::gps_initialize_full(_port, xInitial, yInitial, headingInitial, xOffset, yOffset);
+}
+
+std::int32_t Gps::set_offset(double xOffset, double yOffset) const {
+  return c::gps_set_offset(_port, xOffset, yOffset);
+}
+
+std::int32_t Gps::get_offset(double *xOffset, double *yOffset) const {
+  return c::gps_get_offset(_port, xOffset, yOffset);
+}
+
+std::int32_t Gps::set_position(double xInitial, double yInitial, double headingInitial) const {
+  return c::gps_set_position(_port, xInitial, yInitial, headingInitial);
+}
+
+std::int32_t Gps::set_data_rate(std::uint32_t rate) const {
+  return c::gps_set_data_rate(_port, rate);
+}
+
+double Gps::get_error() const {
+  return c::gps_get_error(_port);
+}
+
+c::gps_status_s_t Gps::get_status() const {
+  return c::gps_get_status(_port);
+}
+
+double Gps::get_heading() const {
+  return c::gps_get_heading(_port);
+}
+
+double Gps::get_heading_raw() const {
+  return c::gps_get_heading_raw(_port);
+}
+
+double Gps::get_rotation() const {
+  return c::gps_get_rotation(_port);
+}
+
+std::int32_t Gps::set_rotation(double target) const {
+  return c::gps_set_rotation(_port, target);
+}
+
+std::int32_t Gps::tare_rotation() const {
+  return c::gps_tare_rotation(_port);
+}
+
+c::gps_gyro_s_t Gps::get_gyro_rate() const {
+  return c::gps_get_gyro_rate(_port);
+}
+
+c::gps_accel_s_t Gps::get_accel() const {
+  return c::gps_get_accel(_port);
+}
+
+std::int32_t Imu::reset() const {
+  return c::imu_reset(_port);
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t rate) const {
+  return c::imu_set_data_rate(_port, rate);
+}
+
+double Imu::get_rotation() const {
+  return c::imu_get_rotation(_port);
+}
+
+double Imu::get_heading() const {
+  return c::imu_get_heading(_port);
+}
+
+c::quaternion_s_t Imu::get_quaternion() const {
+  return c::imu_get_quaternion(_port);
+}
+
+c::euler_s_t Imu::get_euler() const {
+  return c::imu_get_euler(_port);
+}
+
+double Imu::get_pitch() const {
+  return c::imu_get_pitch(_port);
+}
+
+double Imu::get_roll() const {
+  return c::imu_get_roll(_port);
+}
+
+double Imu::get_yaw() const {
+  return c::imu_get_yaw(_port);
+}
+
+c::imu_gyro_s_t Imu::get_gyro_rate() const {
+  return c::imu_get_gyro_rate(_port);
+}
+
+std::int32_t Imu::tare_rotation() const {
+  return c::imu_tare_rotation(_port);
+}
+
+std::int32_t Imu::tare_heading() const {
+  return c::imu_tare_heading(_port);
+}
+
+std::int32_t Imu::tare_pitch() const {
+  return c::imu_tare_pitch(_port);
+}
+
+std::int32_t Imu::tare_yaw() const {
+  return c::imu_tare_yaw(_port);
+}
+
+std::int32_t Imu::tare_roll() const {
+  return c::imu_tare_roll(_port);
+}
+
+std::int32_t Imu::tare() const {
+  return c::imu_tare(_port);
+}
+
+std::int32_t Imu::tare_euler() const {
+  return c::imu_tare_euler(_port);
+}
+
+std::int32_t Imu::set_heading(const double target) const {
+  return c::imu_set_heading(_port, target);
+}
+
+std::int32_t Imu::set_rotation(const double target) const {
+  return c::imu_set_rotation(_port, target);
+}
+
+std::int32_t Imu::set_yaw(const double target) const {
+  return c::imu_set_yaw(_port, target);
+}
+
+std::int32_t Imu::set_pitch(const double target) const {
+  return c::imu_set_pitch(_port, target);
+}
+
+std::int32_t Imu::set_roll(const double target) const {
+  return c::imu_set_roll(_port, target);
+}
+
+std::int32_t Imu::set_euler(const c::euler_s_t target) const {
+  return c::imu_set_euler(_port, target);
+}
+
+c::imu_accel_s_t Imu::get_accel() const {
+  return c::imu_get_accel(_port);
+}
+
+c::imu_status_e_t Imu::get_status() const {
+  return c::imu_get_status(_port);
+}
+
+bool Imu::is_calibrating() const {
+  return get_status() & c::E_IMU_STATUS_CALIBRATING;
+}
+Serial::Serial(const std::uint8_t port, const std::int32_t baudrate) : _port(port) {
+  c::serial_enable(port);
+  c::serial_set_baudrate(port, baudrate);
+}
+
+Serial::Serial(const std::uint8_t port) : _port(port) {
+  c::serial_enable(port);
+}
+
+std::int32_t Serial::set_baudrate(const std::int32_t baudrate) const {
+  return c::serial_set_baudrate(_port, baudrate);
+}
+
+std::int32_t Serial::flush() const {
+  return c::serial_flush(_port);
+}
+
+std::int32_t Serial::get_read_avail() const {
+  return c::serial_get_read_avail(_port);
+}
+
+std::int32_t Serial::get_write_free() const {
+  return c::serial_get_write_free(_port);
+}
+
+std::int32_t Serial::peek_byte() const {
+  return c::serial_peek_byte(_port);
+}
+
+std::int32_t Serial::read_byte() const {
+  return c::serial_read_byte(_port);
+}
+
+std::int32_t Serial::read(std::uint8_t *buffer, const std::int32_t length) const {
+  return c::serial_read(_port, buffer, length);
+}
+
+std::int32_t Serial::write_byte(const std::uint8_t buffer) const {
+  return c::serial_write_byte(_port, buffer);
+}
+
+std::int32_t Serial::write(std::uint8_t *buffer, const std::int32_t length) const {
+  return c::serial_write(_port, buffer, length);
+}
+} // namespace pros
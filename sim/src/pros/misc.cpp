@@ -0,0 +1,123 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "pros/misc.h"
+#include "sim/simulator.hpp"
+#include <cerrno>
+
+namespace {
+bool validId(const pros::controller_id_e_t iid) {
+  if (iid != pros::E_CONTROLLER_MASTER && iid != pros::E_CONTROLLER_PARTNER) {
+    errno = EINVAL;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Calls ifn with the controller. Only the master controller is connected.
+ */
+template <typename F> std::int32_t controller(const pros::controller_id_e_t iid, F &&ifn) {
+  if (!validId(iid)) {
+    return PROS_ERR;
+  }
+
+  auto &simulator = sim::Simulator::get();
+  std::lock_guard<std::mutex> lock(simulator.getMutex());
+  return iid == pros::E_CONTROLLER_MASTER ? ifn(simulator.controller(iid)) : 0;
+}
+
+std::size_t buttonIndex(const pros::controller_digital_e_t ibutton) {
+  return static_cast<std::size_t>(ibutton - pros::E_CONTROLLER_DIGITAL_L1);
+}
+} // namespace
+
+namespace pros {
+namespace c {
+uint8_t competition_get_status(void) {
+  // The simulator behaves like a field controller which has already enabled the chosen mode
+  return sim::Simulator::get().getConfig().mode == sim::Config::Mode::autonomous
+           ? COMPETITION_AUTONOMOUS | COMPETITION_CONNECTED
+           : COMPETITION_CONNECTED;
+}
+
+int32_t controller_is_connected(controller_id_e_t id) {
+  return controller(id, [](sim::ControllerDevice &) { return 1; });
+}
+
+int32_t controller_get_analog(controller_id_e_t id, controller_analog_e_t channel) {
+  return controller(id, [&](sim::ControllerDevice &controller) {
+    return controller.analog[channel];
+  });
+}
+
+int32_t controller_get_battery_capacity(controller_id_e_t id) {
+  return controller(id, [](sim::ControllerDevice &) { return 100; });
+}
+
+int32_t controller_get_battery_level(controller_id_e_t id) {
+  return controller(id, [](sim::ControllerDevice &) { return 100; });
+}
+
+int32_t controller_get_digital(controller_id_e_t id, controller_digital_e_t button) {
+  return controller(id, [&](sim::ControllerDevice &controller) {
+    const bool pressed = controller.digital[buttonIndex(button)];
+    if (!pressed) {
+      controller.reported[buttonIndex(button)] = false;
+    }
+    return pressed ? 1 : 0;
+  });
+}
+
+int32_t controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button) {
+  return controller(id, [&](sim::ControllerDevice &controller) {
+    const std::size_t index = buttonIndex(button);
+    const bool newPress = controller.digital[index] && !controller.reported[index];
+    controller.reported[index] = controller.digital[index];
+    return newPress ? 1 : 0;
+  });
+}
+
+int32_t controller_print(controller_id_e_t id, uint8_t, uint8_t, const char *, ...) {
+  return validId(id) ? 1 : PROS_ERR;
+}
+
+int32_t controller_set_text(controller_id_e_t id, uint8_t, uint8_t, const char *) {
+  return validId(id) ? 1 : PROS_ERR;
+}
+
+int32_t controller_clear_line(controller_id_e_t id, uint8_t) {
+  return validId(id) ? 1 : PROS_ERR;
+}
+
+int32_t controller_clear(controller_id_e_t id) {
+  return validId(id) ? 1 : PROS_ERR;
+}
+
+int32_t controller_rumble(controller_id_e_t id, const char *) {
+  return validId(id) ? 1 : PROS_ERR;
+}
+
+int32_t battery_get_voltage(void) {
+  return static_cast<int32_t>(sim::Simulator::get().getConfig().batteryVoltage * 1000);
+}
+
+int32_t battery_get_current(void) {
+  return 0;
+}
+
+double battery_get_temperature(void) {
+  return 25;
+}
+
+double battery_get_capacity(void) {
+  return 100;
+}
+
+int32_t usd_is_installed(void) {
+  return 0;
+}
+} // namespace c
+} // namespace pros
@@ -0,0 +1,273 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "pros/motors.h"
+#include "sim/simulator.hpp"
+#include <cerrno>
+#include <cmath>
+
+namespace {
+// PROS_ERR_F is a float, but every reading is a double
+constexpr double errorF = PROS_ERR_F;
+
+/**
+ * Validates the port, locks the devices, and calls ifn with the motor. Returns ierror (and sets
+ * errno) if the port is out of range.
+ */
+template <typename T, typename F> T access(const std::uint8_t iport, const T ierror, F &&ifn) {
+  if (iport < 1 || iport > sim::numPorts) {
+    errno = ENXIO;
+    return ierror;
+  }
+
+  auto &simulator = sim::Simulator::get();
+  std::lock_guard<std::mutex> lock(simulator.getMutex());
+  return ifn(simulator.motor(iport));
+}
+
+double logicalAngle(const sim::MotorDevice &imotor) {
+  return imotor.reversed ? -imotor.angle : imotor.angle;
+}
+
+double logicalTorque(const sim::MotorDevice &imotor) {
+  return imotor.reversed ? -imotor.torque : imotor.torque;
+}
+
+std::int32_t setVoltage(sim::MotorDevice &imotor, const double imillivolts) {
+  imotor.mode = sim::MotorDevice::Mode::voltage;
+  imotor.command = std::fmax(-12000.0, std::fmin(12000.0, imillivolts));
+  return 1;
+}
+} // namespace
+
+namespace pros {
+namespace c {
+int32_t motor_move(uint8_t port, int32_t voltage) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    return setVoltage(motor, voltage * 12000.0 / 127.0);
+  });
+}
+
+int32_t motor_move_absolute(uint8_t port, const double position, const int32_t velocity) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.mode = sim::MotorDevice::Mode::position;
+    motor.targetPosition = position;
+    motor.command = velocity;
+    return 1;
+  });
+}
+
+int32_t motor_move_relative(uint8_t port, const double position, const int32_t velocity) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.mode = sim::MotorDevice::Mode::position;
+    motor.targetPosition += position;
+    motor.command = velocity;
+    return 1;
+  });
+}
+
+int32_t motor_move_velocity(uint8_t port, const int32_t velocity) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.mode = sim::MotorDevice::Mode::velocity;
+    motor.command = velocity;
+    return 1;
+  });
+}
+
+int32_t motor_move_voltage(uint8_t port, const int32_t voltage) {
+  return access(
+    port, PROS_ERR, [&](sim::MotorDevice &motor) { return setVoltage(motor, voltage); });
+}
+
+int32_t motor_modify_profiled_velocity(uint8_t port, const int32_t velocity) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    if (motor.mode == sim::MotorDevice::Mode::position) {
+      motor.command = velocity;
+    }
+    return 1;
+  });
+}
+
+double motor_get_target_position(uint8_t port) {
+  return access(port, errorF, [&](sim::MotorDevice &motor) { return motor.targetPosition; });
+}
+
+int32_t motor_get_target_velocity(uint8_t port) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    return motor.mode == sim::MotorDevice::Mode::voltage ? 0
+                                                         : static_cast<int32_t>(motor.command);
+  });
+}
+
+double motor_get_actual_velocity(uint8_t port) {
+  return access(port, errorF, [&](sim::MotorDevice &motor) { return motor.rpm(); });
+}
+
+int32_t motor_get_current_draw(uint8_t port) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    return static_cast<int32_t>(std::lround(motor.current() * 1000));
+  });
+}
+
+int32_t motor_get_direction(uint8_t port) {
+  return access(
+    port, PROS_ERR, [&](sim::MotorDevice &motor) { return motor.rpm() < 0 ? -1 : 1; });
+}
+
+double motor_get_efficiency(uint8_t port) {
+  return access(port, errorF, [&](sim::MotorDevice &motor) {
+    const double input = std::abs(motor.voltage) * motor.current();
+    const double output = motor.torque * motor.velocity;
+    return input > 0 ? std::fmax(0.0, std::fmin(100.0, 100 * output / input)) : 0.0;
+  });
+}
+
+int32_t motor_is_over_current(uint8_t port) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    return motor.current() * 1000 > motor.currentLimit ? 1 : 0;
+  });
+}
+
+int32_t motor_is_over_temp(uint8_t port) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &) { return 0; });
+}
+
+int32_t motor_is_stopped(uint8_t port) {
+  return access(
+    port, PROS_ERR, [&](sim::MotorDevice &motor) { return std::abs(motor.rpm()) < 1 ? 1 : 0; });
+}
+
+int32_t motor_get_zero_position_flag(uint8_t port) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &) { return 0; });
+}
+
+uint32_t motor_get_faults(uint8_t port) {
+  return access(port, static_cast<uint32_t>(PROS_ERR), [&](sim::MotorDevice &) { return 0u; });
+}
+
+uint32_t motor_get_flags(uint8_t port) {
+  return access(port, static_cast<uint32_t>(PROS_ERR), [&](sim::MotorDevice &) { return 0u; });
+}
+
+int32_t motor_get_raw_position(uint8_t port, uint32_t *const timestamp) {
+  if (timestamp) {
+    *timestamp = static_cast<uint32_t>(sim::Simulator::get().getClock().now() / 1000);
+  }
+
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    auto counts = motor;
+    counts.units = E_MOTOR_ENCODER_COUNTS;
+    return static_cast<int32_t>(std::lround(counts.toUnits(logicalAngle(motor))));
+  });
+}
+
+double motor_get_position(uint8_t port) {
+  return access(port, errorF, [&](sim::MotorDevice &motor) { return motor.position(); });
+}
+
+double motor_get_power(uint8_t port) {
+  return access(port, errorF, [&](sim::MotorDevice &motor) {
+    return std::abs(motor.voltage) * motor.current();
+  });
+}
+
+double motor_get_temperature(uint8_t port) {
+  return access(port, errorF, [&](sim::MotorDevice &) { return 25.0; });
+}
+
+double motor_get_torque(uint8_t port) {
+  return access(port, errorF, [&](sim::MotorDevice &motor) { return logicalTorque(motor); });
+}
+
+int32_t motor_get_voltage(uint8_t port) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    return static_cast<int32_t>(std::lround((motor.reversed ? -1 : 1) * motor.voltage * 1000));
+  });
+}
+
+int32_t motor_set_zero_position(uint8_t port, const double position) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.zero += position / motor.toUnits(1.0);
+    return 1;
+  });
+}
+
+int32_t motor_tare_position(uint8_t port) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.zero = logicalAngle(motor);
+    return 1;
+  });
+}
+
+int32_t motor_set_brake_mode(uint8_t port, const motor_brake_mode_e_t mode) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.brakeMode = mode;
+    return 1;
+  });
+}
+
+int32_t motor_set_current_limit(uint8_t port, const int32_t limit) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.currentLimit = limit;
+    return 1;
+  });
+}
+
+int32_t motor_set_encoder_units(uint8_t port, const motor_encoder_units_e_t units) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.units = units;
+    return 1;
+  });
+}
+
+int32_t motor_set_gearing(uint8_t port, const motor_gearset_e_t gearset) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.gearset = gearset;
+    return 1;
+  });
+}
+
+int32_t motor_set_reversed(uint8_t port, const bool reverse) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.reversed = reverse;
+    return 1;
+  });
+}
+
+int32_t motor_set_voltage_limit(uint8_t port, const int32_t limit) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) {
+    motor.voltageLimit = limit;
+    return 1;
+  });
+}
+
+motor_brake_mode_e_t motor_get_brake_mode(uint8_t port) {
+  return access(
+    port, E_MOTOR_BRAKE_INVALID, [&](sim::MotorDevice &motor) { return motor.brakeMode; });
+}
+
+int32_t motor_get_current_limit(uint8_t port) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) { return motor.currentLimit; });
+}
+
+motor_encoder_units_e_t motor_get_encoder_units(uint8_t port) {
+  return access(
+    port, E_MOTOR_ENCODER_INVALID, [&](sim::MotorDevice &motor) { return motor.units; });
+}
+
+motor_gearset_e_t motor_get_gearing(uint8_t port) {
+  return access(
+    port, E_MOTOR_GEARSET_INVALID, [&](sim::MotorDevice &motor) { return motor.gearset; });
+}
+
+int32_t motor_is_reversed(uint8_t port) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) { return motor.reversed ? 1 : 0; });
+}
+
+int32_t motor_get_voltage_limit(uint8_t port) {
+  return access(port, PROS_ERR, [&](sim::MotorDevice &motor) { return motor.voltageLimit; });
+}
+} // namespace c
+} // namespace pros
@@ -0,0 +1,472 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "pros/apix.h"
+#include "pros/rtos.h"
+#include "sim/simulator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <ctime>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Tasks are host threads which take turns through sim::Clock, so exactly one runs at a time and
+ * each runs until it blocks, like a cooperative scheduler in simulated time. Priorities are
+ * recorded but do not preempt; tasks which wake at the same time run in the order they went to
+ * sleep. Anything that blocks with a timeout (mutexes, semaphores, notifications) polls once per
+ * simulated millisecond, which keeps every wake-up on the clock.
+ *
+ * A host thread cannot be killed, so a deleted task is marked deleted immediately and unwinds
+ * (by exception) the next time it blocks, without running any more user code.
+ */
+namespace {
+struct TaskDeleted {};
+
+struct TaskRecord;
+
+struct DeletionNotice {
+  TaskRecord *task;
+  std::uint32_t value;
+  pros::notify_action_e_t action;
+};
+
+struct TaskRecord {
+  std::string name;
+  std::uint32_t priority;
+  std::atomic<pros::task_state_e_t> state{pros::E_TASK_STATE_READY};
+  std::atomic<bool> deleteRequested{false};
+  bool suspended{false};
+  std::uint32_t notifyValue{0};
+  bool notifyPending{false};
+  std::vector<DeletionNotice> deletionNotices;
+
+  // Host CPU accounting, for sim::getTaskStats()
+  std::uint64_t cpuTime{0};
+  std::uint64_t runs{0};
+  std::uint64_t resumedAt{0};
+};
+
+struct MutexRecord {
+  TaskRecord *owner{nullptr};
+  std::uint32_t depth{0};
+};
+
+struct SemRecord {
+  std::uint32_t count;
+  std::uint32_t maxCount;
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<TaskRecord>> tasks;
+thread_local TaskRecord *currentTask = nullptr;
+
+sim::Clock &simClock() {
+  return sim::Simulator::get().getClock();
+}
+
+/**
+ * @return The CPU time the calling thread has used, in nanoseconds.
+ */
+std::uint64_t threadCpuTime() {
+  timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return time.tv_sec * 1000000000ull + time.tv_nsec;
+}
+
+TaskRecord *registerTask(const char *iname, const std::uint32_t ipriority) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  tasks.push_back(std::make_unique<TaskRecord>());
+  auto task = tasks.back().get();
+  task->name = iname ? std::string(iname).substr(0, TASK_NAME_MAX_LEN) : "";
+  task->priority = ipriority;
+  return task;
+}
+
+/**
+ * Returns the current task, registering the calling thread (and making it a participant in the
+ * clock) the first time it touches the RTOS. This covers the main thread and any thread which
+ * calls into PROS during static initialization.
+ */
+TaskRecord *current() {
+  if (!currentTask) {
+    currentTask = registerTask("main", TASK_PRIORITY_DEFAULT);
+    currentTask->state = pros::E_TASK_STATE_RUNNING;
+    currentTask->resumedAt = threadCpuTime();
+    simClock().attach();
+  }
+
+  return currentTask;
+}
+
+TaskRecord *resolve(const pros::task_t itask) {
+  return itask ? static_cast<TaskRecord *>(itask) : current();
+}
+
+std::uint32_t notify(TaskRecord *itask,
+                     const std::uint32_t ivalue,
+                     const pros::notify_action_e_t iaction,
+                     std::uint32_t *const oprevValue) {
+  if (oprevValue) {
+    *oprevValue = itask->notifyValue;
+  }
+
+  switch (iaction) {
+  case pros::E_NOTIFY_ACTION_BITS:
+    itask->notifyValue |= ivalue;
+    break;
+  case pros::E_NOTIFY_ACTION_INCR:
+    itask->notifyValue++;
+    break;
+  case pros::E_NOTIFY_ACTION_OWRITE:
+    itask->notifyValue = ivalue;
+    break;
+  case pros::E_NOTIFY_ACTION_NO_OWRITE:
+    if (itask->notifyPending) {
+      return 0;
+    }
+    itask->notifyValue = ivalue;
+    break;
+  default:
+    break;
+  }
+
+  itask->notifyPending = true;
+  return 1;
+}
+
+void markDeleted(TaskRecord *itask) {
+  if (itask->state.exchange(pros::E_TASK_STATE_DELETED) == pros::E_TASK_STATE_DELETED) {
+    return;
+  }
+
+  for (const auto &notice : itask->deletionNotices) {
+    notify(notice.task, notice.value, notice.action, nullptr);
+  }
+  itask->deletionNotices.clear();
+}
+
+/**
+ * Sleeps the current task until iwakeTime (in microseconds). This is the only place a task
+ * blocks, so it is also where deletion and suspension take effect. Waking up counts as a run of
+ * the task unless it is only polling (icountRun is false); the CPU time counts either way.
+ */
+void sleepUntil(const std::uint64_t iwakeTime, const bool icountRun = true) {
+  auto task = current();
+  if (task->deleteRequested) {
+    throw TaskDeleted();
+  }
+
+  task->cpuTime += threadCpuTime() - task->resumedAt;
+  task->state = pros::E_TASK_STATE_BLOCKED;
+  simClock().sleepUntil(iwakeTime);
+  while (task->suspended && !task->deleteRequested) {
+    simClock().sleepUntil(simClock().now() + 1000);
+  }
+
+  if (task->deleteRequested) {
+    throw TaskDeleted();
+  }
+  task->state = pros::E_TASK_STATE_RUNNING;
+  task->runs += icountRun ? 1 : 0;
+  task->resumedAt = threadCpuTime();
+}
+
+/**
+ * Polls itryTake once per simulated millisecond until it succeeds or itimeout milliseconds pass.
+ */
+template <typename F> bool pollUntil(F &&itryTake, const std::uint32_t itimeout) {
+  const std::uint64_t deadline =
+    itimeout == TIMEOUT_MAX ? UINT64_MAX : simClock().now() + itimeout * 1000ull;
+
+  while (!itryTake()) {
+    const std::uint64_t now = simClock().now();
+    if (now >= deadline) {
+      return false;
+    }
+    sleepUntil(std::min(deadline, now + 1000), false);
+  }
+
+  return true;
+}
+} // namespace
+
+namespace pros {
+namespace c {
+uint32_t millis(void) {
+  return static_cast<uint32_t>(simClock().now() / 1000);
+}
+
+uint64_t micros(void) {
+  return simClock().now();
+}
+
+task_t task_create(task_fn_t function,
+                   void *const parameters,
+                   uint32_t prio,
+                   const uint16_t,
+                   const char *const name) {
+  // The creator must already be a participant, or the new task could run ahead of it
+  current();
+
+  auto task = registerTask(name, prio);
+  std::promise<void> attached;
+  std::thread([task, function, parameters, &attached]() {
+    currentTask = task;
+    simClock().attach();
+    attached.set_value();
+
+    try {
+      sleepUntil(simClock().now());
+      function(parameters);
+    } catch (const TaskDeleted &) {
+    }
+
+    markDeleted(task);
+    simClock().detach();
+  }).detach();
+  attached.get_future().wait();
+
+  return task;
+}
+
+void task_delete(task_t task) {
+  auto record = resolve(task);
+  record->deleteRequested = true;
+  markDeleted(record);
+
+  if (record == current()) {
+    throw TaskDeleted();
+  }
+}
+
+void task_delay(const uint32_t milliseconds) {
+  sleepUntil(simClock().now() + milliseconds * 1000ull);
+}
+
+void delay(const uint32_t milliseconds) {
+  task_delay(milliseconds);
+}
+
+void task_delay_until(uint32_t *const prev_time, const uint32_t delta) {
+  *prev_time += delta;
+  sleepUntil(*prev_time * 1000ull);
+}
+
+uint32_t task_get_priority(task_t task) {
+  return resolve(task)->priority;
+}
+
+void task_set_priority(task_t task, uint32_t prio) {
+  resolve(task)->priority = prio;
+}
+
+task_state_e_t task_get_state(task_t task) {
+  auto record = resolve(task);
+  if (record->suspended && record->state != E_TASK_STATE_DELETED) {
+    return E_TASK_STATE_SUSPENDED;
+  }
+  return record == current() ? E_TASK_STATE_RUNNING : record->state.load();
+}
+
+void task_suspend(task_t task) {
+  auto record = resolve(task);
+  record->suspended = true;
+  if (record == current()) {
+    sleepUntil(simClock().now());
+  }
+}
+
+void task_resume(task_t task) {
+  resolve(task)->suspended = false;
+}
+
+uint32_t task_get_count(void) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  return static_cast<uint32_t>(
+    std::count_if(tasks.begin(), tasks.end(), [](const std::unique_ptr<TaskRecord> &task) {
+      return task->state != E_TASK_STATE_DELETED;
+    }));
+}
+
+char *task_get_name(task_t task) {
+  return &resolve(task)->name[0];
+}
+
+task_t task_get_by_name(const char *name) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  for (const auto &task : tasks) {
+    if (task->state != E_TASK_STATE_DELETED && task->name == name) {
+      return task.get();
+    }
+  }
+  return nullptr;
+}
+
+task_t task_get_current() {
+  return current();
+}
+
+uint32_t task_notify(task_t task) {
+  return notify(resolve(task), 0, E_NOTIFY_ACTION_INCR, nullptr);
+}
+
+uint32_t task_notify_ext(task_t task,
+                         uint32_t value,
+                         notify_action_e_t action,
+                         uint32_t *prev_value) {
+  return notify(resolve(task), value, action, prev_value);
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+  auto task = current();
+  pollUntil([&]() { return task->notifyValue != 0; }, timeout);
+
+  const std::uint32_t value = task->notifyValue;
+  if (value != 0) {
+    task->notifyValue = clear_on_exit ? 0 : value - 1;
+  }
+  task->notifyPending = false;
+  return value;
+}
+
+bool task_notify_clear(task_t task) {
+  auto record = resolve(task);
+  const bool wasPending = record->notifyPending;
+  record->notifyPending = false;
+  return wasPending;
+}
+
+bool task_abort_delay(task_t) {
+  return false;
+}
+
+void task_notify_when_deleting(task_t target_task,
+                               task_t task_to_notify,
+                               uint32_t value,
+                               notify_action_e_t notify_action) {
+  auto target = resolve(target_task);
+  auto toNotify = resolve(task_to_notify);
+  if (target->state == E_TASK_STATE_DELETED) {
+    notify(toNotify, value, notify_action, nullptr);
+  } else {
+    target->deletionNotices.push_back({toNotify, value, notify_action});
+  }
+}
+
+mutex_t mutex_create(void) {
+  return new MutexRecord();
+}
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) {
+  auto record = static_cast<MutexRecord *>(mutex);
+  return pollUntil(
+    [&]() {
+      if (record->owner) {
+        return false;
+      }
+      record->owner = current();
+      record->depth = 1;
+      return true;
+    },
+    timeout);
+}
+
+bool mutex_give(mutex_t mutex) {
+  auto record = static_cast<MutexRecord *>(mutex);
+  if (record->owner != current()) {
+    return false;
+  }
+
+  if (--record->depth == 0) {
+    record->owner = nullptr;
+  }
+  return true;
+}
+
+void mutex_delete(mutex_t mutex) {
+  delete static_cast<MutexRecord *>(mutex);
+}
+
+mutex_t mutex_recursive_create(void) {
+  return new MutexRecord();
+}
+
+bool mutex_recursive_take(mutex_t mutex, uint32_t timeout) {
+  auto record = static_cast<MutexRecord *>(mutex);
+  return pollUntil(
+    [&]() {
+      if (record->owner && record->owner != current()) {
+        return false;
+      }
+      record->owner = current();
+      record->depth++;
+      return true;
+    },
+    timeout);
+}
+
+bool mutex_recursive_give(mutex_t mutex) {
+  return mutex_give(mutex);
+}
+
+task_t mutex_get_owner(mutex_t mutex) {
+  return static_cast<MutexRecord *>(mutex)->owner;
+}
+
+sem_t sem_create(uint32_t max_count, uint32_t init_count) {
+  return new SemRecord{std::min(init_count, max_count), max_count};
+}
+
+void sem_delete(sem_t sem) {
+  delete static_cast<SemRecord *>(sem);
+}
+
+sem_t sem_binary_create(void) {
+  return sem_create(1, 0);
+}
+
+bool sem_wait(sem_t sem, uint32_t timeout) {
+  auto record = static_cast<SemRecord *>(sem);
+  return pollUntil(
+    [&]() {
+      if (record->count == 0) {
+        return false;
+      }
+      record->count--;
+      return true;
+    },
+    timeout);
+}
+
+bool sem_post(sem_t sem) {
+  auto record = static_cast<SemRecord *>(sem);
+  if (record->count >= record->maxCount) {
+    return false;
+  }
+  record->count++;
+  return true;
+}
+
+uint32_t sem_get_count(sem_t sem) {
+  return static_cast<SemRecord *>(sem)->count;
+}
+} // namespace c
+} // namespace pros
+
+namespace sim {
+std::vector<TaskStats> getTaskStats() {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  std::vector<TaskStats> stats;
+  for (const auto &task : tasks) {
+    stats.push_back({task->name, task->cpuTime, task->runs});
+  }
+  return stats;
+}
+} // namespace sim
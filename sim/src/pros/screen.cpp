@@ -0,0 +1,80 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "pros/screen.h"
+#include "sim/simulator.hpp"
+#include <cstdarg>
+#include <cstdio>
+
+/**
+ * The simulated screen only keeps text, one string per line. Text printed at a coordinate lands
+ * on the line that coordinate falls in.
+ */
+namespace {
+// Height of a line of medium text, in pixels
+constexpr std::int16_t lineHeight = 20;
+
+std::uint32_t pen = 0x00FFFFFF;
+std::uint32_t eraser = 0x00000000;
+
+void print(const std::int16_t iline, const char *ifmt, va_list iargs) {
+  char buffer[256];
+  std::vsnprintf(buffer, sizeof(buffer), ifmt, iargs);
+  sim::Simulator::get().setScreenLine(iline, buffer);
+}
+} // namespace
+
+namespace pros {
+namespace c {
+void screen_set_pen(uint32_t color) {
+  pen = color;
+}
+
+void screen_set_eraser(uint32_t color) {
+  eraser = color;
+}
+
+uint32_t screen_get_pen(void) {
+  return pen;
+}
+
+uint32_t screen_get_eraser(void) {
+  return eraser;
+}
+
+void screen_erase(void) {
+  auto &simulator = sim::Simulator::get();
+  for (const auto &line : simulator.getScreen()) {
+    simulator.setScreenLine(line.first, "");
+  }
+}
+
+void screen_print(text_format_e_t, const int16_t line, const char *text, ...) {
+  va_list args;
+  va_start(args, text);
+  print(line, text, args);
+  va_end(args);
+}
+
+void screen_print_at(text_format_e_t, const int16_t, const int16_t y, const char *text, ...) {
+  va_list args;
+  va_start(args, text);
+  print(y / lineHeight, text, args);
+  va_end(args);
+}
+
+void screen_vprintf(text_format_e_t, const int16_t line, const char *text, va_list args) {
+  print(line, text, args);
+}
+
+void screen_vprintf_at(text_format_e_t,
+                       const int16_t,
+                       const int16_t y,
+                       const char *text,
+                       va_list args) {
+  print(y / lineHeight, text, args);
+}
+} // namespace c
+} // namespace pros
@@ -0,0 +1,405 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "pros/adi.h"
+#include "pros/ext_adi.h"
+#include "pros/gps.h"
+#include "pros/imu.h"
+#include "sim/simulator.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+
+namespace {
+constexpr double pi = 3.14159265358979323846;
+
+// PROS_ERR_F is a float, but every reading is a double
+constexpr double errorF = PROS_ERR_F;
+
+double wrapDegrees(double iangle, const double imin) {
+  iangle = std::fmod(iangle - imin, 360.0);
+  return (iangle < 0 ? iangle + 360.0 : iangle) + imin;
+}
+
+/**
+ * Validates that iport is where the simulated device of that kind is plugged in, locks the
+ * devices, and calls ifn. Returns ierror (and sets errno) otherwise.
+ */
+template <typename T, typename F>
+T access(const std::uint8_t iport, const std::uint8_t idevicePort, const T ierror, F &&ifn) {
+  if (iport < 1 || iport > sim::numPorts) {
+    errno = ENXIO;
+    return ierror;
+  }
+
+  if (iport != idevicePort) {
+    errno = ENODEV;
+    return ierror;
+  }
+
+  auto &simulator = sim::Simulator::get();
+  std::lock_guard<std::mutex> lock(simulator.getMutex());
+  return ifn();
+}
+
+template <typename T, typename F> T gps(const std::uint8_t iport, const T ierror, F &&ifn) {
+  auto &simulator = sim::Simulator::get();
+  return access(
+    iport, simulator.getConfig().gpsPort, ierror, [&]() { return ifn(simulator.gps()); });
+}
+
+/**
+ * Like gps(), but also fails with EAGAIN while the IMU is calibrating.
+ */
+template <typename T, typename F> T imu(const std::uint8_t iport, const T ierror, F &&ifn) {
+  auto &simulator = sim::Simulator::get();
+  const std::uint64_t now = simulator.getClock().now();
+  return access(iport, simulator.getConfig().imuPort, ierror, [&]() -> T {
+    auto &imu = simulator.imu();
+    if (now < imu.calibratedTime) {
+      errno = EAGAIN;
+      return ierror;
+    }
+    return ifn(imu);
+  });
+}
+
+double imuRotation(const sim::ImuDevice &iimu) {
+  return iimu.rotation + iimu.rotationOffset;
+}
+
+double imuHeading(const sim::ImuDevice &iimu) {
+  return wrapDegrees(iimu.rotation + iimu.headingOffset, 0.0);
+}
+
+std::uint8_t adiPort(const std::uint8_t iport) {
+  if (iport >= 'a' && iport <= 'h') {
+    return iport - 'a' + 1;
+  }
+  if (iport >= 'A' && iport <= 'H') {
+    return iport - 'A' + 1;
+  }
+  return iport;
+}
+
+std::int32_t encoderInit(const std::uint8_t ismartPort,
+                         const std::uint8_t itop,
+                         const bool ireverse) {
+  const auto top = adiPort(itop);
+  if (top < 1 || top > 8) {
+    errno = ENXIO;
+    return PROS_ERR;
+  }
+
+  auto &simulator = sim::Simulator::get();
+  std::lock_guard<std::mutex> lock(simulator.getMutex());
+
+  sim::EncoderDevice encoder;
+  encoder.reversed = ireverse;
+  const auto &wheels = simulator.getConfig().trackingWheels;
+  for (std::size_t i = 0; i < wheels.size(); i++) {
+    if (wheels[i].topPort == top) {
+      encoder.wheel = static_cast<int>(i);
+    }
+  }
+
+  const std::int32_t handle = (ismartPort << 8) | top;
+  simulator.encoders()[handle] = encoder;
+  return handle;
+}
+
+template <typename F> std::int32_t encoder(const std::int32_t ihandle, F &&ifn) {
+  auto &simulator = sim::Simulator::get();
+  std::lock_guard<std::mutex> lock(simulator.getMutex());
+  const auto it = simulator.encoders().find(ihandle);
+  if (it == simulator.encoders().end()) {
+    errno = EADDRINUSE;
+    return PROS_ERR;
+  }
+  return ifn(it->second);
+}
+} // namespace
+
+namespace pros {
+namespace c {
+int32_t gps_initialize_full(uint8_t port,
+                            double xInitial,
+                            double yInitial,
+                            double headingInitial,
+                            double xOffset,
+                            double yOffset) {
+  if (gps_set_offset(port, xOffset, yOffset) == PROS_ERR) {
+    return PROS_ERR;
+  }
+  return gps_set_position(port, xInitial, yInitial, headingInitial);
+}
+
+int32_t gps_set_offset(uint8_t port, double xOffset, double yOffset) {
+  return gps(port, PROS_ERR, [&](sim::GpsDevice &gps) {
+    gps.xOffset = xOffset;
+    gps.yOffset = yOffset;
+    return 1;
+  });
+}
+
+int32_t gps_get_offset(uint8_t port, double *xOffset, double *yOffset) {
+  return gps(port, PROS_ERR, [&](sim::GpsDevice &gps) {
+    *xOffset = gps.xOffset;
+    *yOffset = gps.yOffset;
+    return 1;
+  });
+}
+
+int32_t gps_set_position(uint8_t port, double, double, double) {
+  // The simulated GPS always sees the field strip, so its initial guess never matters
+  return gps(port, PROS_ERR, [&](sim::GpsDevice &) { return 1; });
+}
+
+int32_t gps_set_data_rate(uint8_t port, uint32_t rate) {
+  return gps(port, PROS_ERR, [&](sim::GpsDevice &gps) {
+    gps.dataRate = std::max<uint32_t>(rate, 5);
+    return 1;
+  });
+}
+
+double gps_get_error(uint8_t port) {
+  auto &simulator = sim::Simulator::get();
+  return gps(port, errorF, [&](sim::GpsDevice &) {
+    return simulator.getConfig().gpsPositionNoise;
+  });
+}
+
+gps_status_s_t gps_get_status(uint8_t port) {
+  const gps_status_s_t error{PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+  return gps(port, error, [&](sim::GpsDevice &gps) { return gps.latest; });
+}
+
+double gps_get_heading(uint8_t port) {
+  return gps(port, errorF, [&](sim::GpsDevice &gps) {
+    return wrapDegrees(gps.latestRotation, 0.0);
+  });
+}
+
+double gps_get_heading_raw(uint8_t port) {
+  return gps_get_heading(port);
+}
+
+double gps_get_rotation(uint8_t port) {
+  return gps(port, errorF, [&](sim::GpsDevice &gps) {
+    return gps.latestRotation - gps.rotationOffset;
+  });
+}
+
+int32_t gps_set_rotation(uint8_t port, double target) {
+  return gps(port, PROS_ERR, [&](sim::GpsDevice &gps) {
+    gps.rotationOffset = gps.latestRotation - target;
+    return 1;
+  });
+}
+
+int32_t gps_tare_rotation(uint8_t port) {
+  return gps_set_rotation(port, 0);
+}
+
+gps_gyro_s_t gps_get_gyro_rate(uint8_t port) {
+  auto &simulator = sim::Simulator::get();
+  const gps_gyro_s_t error{PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+  return gps(port, error, [&](sim::GpsDevice &) {
+    return gps_gyro_s_t{0, 0, simulator.imu().rate};
+  });
+}
+
+gps_accel_s_t gps_get_accel(uint8_t port) {
+  const gps_accel_s_t error{PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+  return gps(port, error, [&](sim::GpsDevice &) { return gps_accel_s_t{0, 0, 0}; });
+}
+
+int32_t imu_reset(uint8_t port) {
+  auto &simulator = sim::Simulator::get();
+  const std::uint64_t now = simulator.getClock().now();
+  return access(port, simulator.getConfig().imuPort, PROS_ERR, [&]() {
+    auto &imu = simulator.imu();
+    if (now < imu.calibratedTime) {
+      errno = EAGAIN;
+      return PROS_ERR;
+    }
+
+    imu.rotation = 0;
+    imu.rotationOffset = 0;
+    imu.headingOffset = 0;
+    imu.calibratedTime = now + simulator.getConfig().imuCalibrationTime * 1000ull;
+    return 1;
+  });
+}
+
+int32_t imu_set_data_rate(uint8_t port, uint32_t) {
+  return imu(port, PROS_ERR, [&](sim::ImuDevice &) { return 1; });
+}
+
+double imu_get_rotation(uint8_t port) {
+  return imu(port, errorF, [&](sim::ImuDevice &imu) { return imuRotation(imu); });
+}
+
+double imu_get_heading(uint8_t port) {
+  return imu(port, errorF, [&](sim::ImuDevice &imu) { return imuHeading(imu); });
+}
+
+quaternion_s_t imu_get_quaternion(uint8_t port) {
+  const quaternion_s_t error{PROS_ERR_F, PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+  return imu(port, error, [&](sim::ImuDevice &imu) {
+    // Headings are clockwise, so the rotation about +z is the negative heading
+    const double halfAngle = -imuHeading(imu) * pi / 360;
+    return quaternion_s_t{0, 0, std::sin(halfAngle), std::cos(halfAngle)};
+  });
+}
+
+euler_s_t imu_get_euler(uint8_t port) {
+  const euler_s_t error{PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+  return imu(port, error, [&](sim::ImuDevice &imu) {
+    return euler_s_t{0, 0, wrapDegrees(imuHeading(imu), -180.0)};
+  });
+}
+
+double imu_get_pitch(uint8_t port) {
+  return imu(port, errorF, [&](sim::ImuDevice &) { return 0.0; });
+}
+
+double imu_get_roll(uint8_t port) {
+  return imu(port, errorF, [&](sim::ImuDevice &) { return 0.0; });
+}
+
+double imu_get_yaw(uint8_t port) {
+  return imu(port, errorF, [&](sim::ImuDevice &imu) {
+    return wrapDegrees(imuHeading(imu), -180.0);
+  });
+}
+
+imu_gyro_s_t imu_get_gyro_rate(uint8_t port) {
+  const imu_gyro_s_t error{PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+  return imu(port, error, [&](sim::ImuDevice &imu) { return imu_gyro_s_t{0, 0, imu.rate}; });
+}
+
+imu_accel_s_t imu_get_accel(uint8_t port) {
+  const imu_accel_s_t error{PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+  return imu(port, error, [&](sim::ImuDevice &) { return imu_accel_s_t{0, 0, 0}; });
+}
+
+imu_status_e_t imu_get_status(uint8_t port) {
+  auto &simulator = sim::Simulator::get();
+  const std::uint64_t now = simulator.getClock().now();
+  return access(port, simulator.getConfig().imuPort, E_IMU_STATUS_ERROR, [&]() {
+    return now < simulator.imu().calibratedTime ? E_IMU_STATUS_CALIBRATING
+                                                : static_cast<imu_status_e_t>(0);
+  });
+}
+
+int32_t imu_tare_heading(uint8_t port) {
+  return imu_set_heading(port, 0);
+}
+
+int32_t imu_tare_rotation(uint8_t port) {
+  return imu_set_rotation(port, 0);
+}
+
+int32_t imu_tare_pitch(uint8_t port) {
+  return imu(port, PROS_ERR, [&](sim::ImuDevice &) { return 1; });
+}
+
+int32_t imu_tare_roll(uint8_t port) {
+  return imu(port, PROS_ERR, [&](sim::ImuDevice &) { return 1; });
+}
+
+int32_t imu_tare_yaw(uint8_t port) {
+  return imu_set_heading(port, 0);
+}
+
+int32_t imu_tare_euler(uint8_t port) {
+  return imu_set_heading(port, 0);
+}
+
+int32_t imu_tare(uint8_t port) {
+  if (imu_tare_heading(port) == PROS_ERR) {
+    return PROS_ERR;
+  }
+  return imu_tare_rotation(port);
+}
+
+int32_t imu_set_euler(uint8_t port, euler_s_t target) {
+  return imu_set_yaw(port, target.yaw);
+}
+
+int32_t imu_set_rotation(uint8_t port, double target) {
+  return imu(port, PROS_ERR, [&](sim::ImuDevice &imu) {
+    imu.rotationOffset = target - imu.rotation;
+    return 1;
+  });
+}
+
+int32_t imu_set_heading(uint8_t port, double target) {
+  return imu(port, PROS_ERR, [&](sim::ImuDevice &imu) {
+    imu.headingOffset = target - imu.rotation;
+    return 1;
+  });
+}
+
+int32_t imu_set_pitch(uint8_t port, double) {
+  return imu(port, PROS_ERR, [&](sim::ImuDevice &) { return 1; });
+}
+
+int32_t imu_set_roll(uint8_t port, double) {
+  return imu(port, PROS_ERR, [&](sim::ImuDevice &) { return 1; });
+}
+
+int32_t imu_set_yaw(uint8_t port, double target) {
+  return imu_set_heading(port, target);
+}
+
+adi_encoder_t adi_encoder_init(uint8_t port_top, uint8_t, bool reverse) {
+  return encoderInit(INTERNAL_ADI_PORT, port_top, reverse);
+}
+
+int32_t adi_encoder_get(adi_encoder_t enc) {
+  return encoder(enc, [](sim::EncoderDevice &encoder) {
+    const double ticks = encoder.ticks - encoder.zero;
+    return static_cast<int32_t>(std::lround(encoder.reversed ? -ticks : ticks));
+  });
+}
+
+int32_t adi_encoder_reset(adi_encoder_t enc) {
+  return encoder(enc, [](sim::EncoderDevice &encoder) {
+    encoder.zero = encoder.ticks;
+    return 1;
+  });
+}
+
+int32_t adi_encoder_shutdown(adi_encoder_t enc) {
+  auto &simulator = sim::Simulator::get();
+  std::lock_guard<std::mutex> lock(simulator.getMutex());
+  simulator.encoders().erase(enc);
+  return 1;
+}
+
+ext_adi_encoder_t
+ext_adi_encoder_init(uint8_t smart_port, uint8_t adi_port_top, uint8_t, bool reverse) {
+  if (smart_port < 1 || smart_port > INTERNAL_ADI_PORT) {
+    errno = ENXIO;
+    return PROS_ERR;
+  }
+  return encoderInit(smart_port, adi_port_top, reverse);
+}
+
+int32_t ext_adi_encoder_get(ext_adi_encoder_t enc) {
+  return adi_encoder_get(enc);
+}
+
+int32_t ext_adi_encoder_reset(ext_adi_encoder_t enc) {
+  return adi_encoder_reset(enc);
+}
+
+int32_t ext_adi_encoder_shutdown(ext_adi_encoder_t enc) {
+  return adi_encoder_shutdown(enc);
+}
+} // namespace c
+} // namespace pros
@@ -0,0 +1,68 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "pros/serial.h"
+#include "sim/simulator.hpp"
+#include <algorithm>
+#include <cerrno>
+
+namespace {
+// Nothing is plugged into a generic serial port in the simulator, so writes are discarded and
+// there is never anything to read. The write FIFO is always empty.
+constexpr std::int32_t writeFifoSize = 1024;
+
+bool validPort(const std::uint8_t iport) {
+  if (iport < 1 || iport > sim::numPorts) {
+    errno = ENXIO;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+namespace pros::c {
+int32_t serial_enable(const uint8_t port) {
+  return validPort(port) ? 1 : PROS_ERR;
+}
+
+int32_t serial_set_baudrate(const uint8_t port, int32_t) {
+  return validPort(port) ? 1 : PROS_ERR;
+}
+
+int32_t serial_flush(const uint8_t port) {
+  return validPort(port) ? 1 : PROS_ERR;
+}
+
+int32_t serial_get_read_avail(const uint8_t port) {
+  return validPort(port) ? 0 : PROS_ERR;
+}
+
+int32_t serial_get_write_free(const uint8_t port) {
+  return validPort(port) ? writeFifoSize : PROS_ERR;
+}
+
+int32_t serial_peek_byte(const uint8_t port) {
+  return validPort(port) ? -1 : PROS_ERR;
+}
+
+int32_t serial_read_byte(const uint8_t port) {
+  return validPort(port) ? -1 : PROS_ERR;
+}
+
+int32_t serial_read(const uint8_t port, uint8_t *, int32_t) {
+  return validPort(port) ? 0 : PROS_ERR;
+}
+
+int32_t serial_write_byte(const uint8_t port, uint8_t) {
+  return validPort(port) ? 1 : PROS_ERR;
+}
+
+int32_t serial_write(const uint8_t port, uint8_t *, const int32_t length) {
+  if (!validPort(port)) {
+    return PROS_ERR;
+  }
+  return std::min(length, writeFifoSize);
+}
+} // namespace pros::c
@@ -0,0 +1,82 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/benchmark.hpp"
+#include <cstdio>
+
+namespace sim {
+namespace {
+constexpr double inch = 0.0254;
+
+std::string number(const double ivalue, const char *iformat = "%.4f") {
+  if (ivalue < 0) {
+    return "null";
+  }
+
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), iformat, ivalue);
+  return buffer;
+}
+} // namespace
+
+const std::vector<Scenario> &getScenarios() {
+  static const std::vector<Scenario> scenarios = [] {
+    std::vector<Scenario> list;
+
+    list.push_back({"point-to-point", {0, 0, 0}, {{36 * inch, 36 * inch, 45}}});
+
+    // The route opcontrol() drives
+    list.push_back({"route",
+                    {0, 0, 0},
+                    {{36 * inch, 36 * inch, 45},
+                     {-36 * inch, 36 * inch, -45},
+                     {-24 * inch, 0, -90},
+                     {-36 * inch, -36 * inch, -135},
+                     {36 * inch, -36 * inch, 135}}});
+
+    // Just short of 180 degrees, so the short way is across the +-180 wrap
+    list.push_back({"turn-wrap-cw", {0, 0, 100}, {{0, 0, -85}}});
+    list.push_back({"turn-wrap-ccw", {0, 0, -100}, {{0, 0, 85}}});
+
+    list.push_back({"strafe", {0, 0, 0}, {{36 * inch, 0, 0}}});
+
+    // Knocked sideways at about half speed while driving forward
+    Scenario push{"push-recovery", {0, 0, 0}, {{0, 48 * inch, 0}}};
+    push.pushTime = 700;
+    push.pushX = 3.0;
+    list.push_back(push);
+
+    return list;
+  }();
+
+  return scenarios;
+}
+
+const Scenario *findScenario(const std::string &iname) {
+  for (const auto &scenario : getScenarios()) {
+    if (scenario.name == iname) {
+      return &scenario;
+    }
+  }
+  return nullptr;
+}
+
+const std::vector<std::string> &getControllers() {
+  static const std::vector<std::string> controllers{"goTo", "chassisPid"};
+  return controllers;
+}
+
+std::string Metrics::toJson(const std::string &iscenario, const std::string &icontroller) const {
+  return "{\"scenario\":\"" + iscenario + "\",\"controller\":\"" + icontroller +
+         "\",\"completed\":" + (completed ? "true" : "false") + ",\"time\":" + number(time) +
+         ",\"settleTime\":" + number(settleTime) + ",\"overshoot\":" + number(overshoot) +
+         ",\"headingOvershoot\":" + number(headingOvershoot, "%.2f") +
+         ",\"pathLengthRatio\":" + number(pathLengthRatio) +
+         ",\"peakCurrent\":" + number(peakCurrent, "%.3f") +
+         ",\"cpuPerTick\":" + number(cpuPerTick, "%.2f") +
+         ",\"positionError\":" + number(positionError) +
+         ",\"headingError\":" + number(headingError, "%.2f") + "}";
+}
+} // namespace sim
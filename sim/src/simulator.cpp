@@ -0,0 +1,298 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/simulator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <future>
+#include <thread>
+
+namespace sim {
+namespace {
+constexpr double pi = 3.14159265358979323846;
+constexpr double radToDeg = 180.0 / pi;
+
+// Time constant of a motor which is not part of the drive, spinning with no load
+constexpr double freeSpinTimeConstant = 0.05;
+
+// Current the motor draws at stall, at which it produces its stall torque
+constexpr double stallCurrent = 2.5;
+
+// Voltage lost in a motor's driver, so a fully charged battery gives exactly 12 V
+constexpr double driverDrop = 0.8;
+
+double wrapDegrees(double iangle, const double imin) {
+  iangle = std::fmod(iangle - imin, 360.0);
+  return (iangle < 0 ? iangle + 360.0 : iangle) + imin;
+}
+} // namespace
+
+XDrivePhysics::MotorCurve MotorDevice::curve() const {
+  switch (gearset) {
+  case pros::E_MOTOR_GEARSET_36:
+    return {2.1, 100 * 2 * pi / 60};
+  case pros::E_MOTOR_GEARSET_06:
+    return {0.35, 600 * 2 * pi / 60};
+  default:
+    return {1.05, 200 * 2 * pi / 60};
+  }
+}
+
+double MotorDevice::toUnits(const double iradians) const {
+  switch (units) {
+  case pros::E_MOTOR_ENCODER_ROTATIONS:
+    return iradians / (2 * pi);
+  case pros::E_MOTOR_ENCODER_COUNTS: {
+    const double ticksPerRev = gearset == pros::E_MOTOR_GEARSET_36   ? 1800
+                               : gearset == pros::E_MOTOR_GEARSET_06 ? 300
+                                                                     : 900;
+    return iradians / (2 * pi) * ticksPerRev;
+  }
+  default:
+    return iradians * radToDeg;
+  }
+}
+
+double MotorDevice::position() const {
+  return toUnits((reversed ? -angle : angle) - zero);
+}
+
+double MotorDevice::rpm() const {
+  return (reversed ? -velocity : velocity) * 60 / (2 * pi);
+}
+
+double MotorDevice::computeVoltage() const {
+  const double freeRpm = curve().freeSpeed * 60 / (2 * pi);
+
+  double volts = 0;
+  if (mode == Mode::voltage) {
+    volts = command / 1000.0;
+  } else {
+    double targetRpm = command;
+    if (mode == Mode::position) {
+      // Slow down proportionally over the last quarter turn, like the motor's profiled move
+      const double errorDegrees = (targetPosition - position()) / toUnits(pi / 180);
+      targetRpm = std::clamp(errorDegrees * freeRpm / 90, -std::abs(command), std::abs(command));
+    }
+
+    // Feedforward on the target speed plus proportional feedback on the speed error
+    volts = 12.0 * targetRpm / freeRpm + 24.0 * (targetRpm - rpm()) / freeRpm;
+  }
+
+  const double limit = std::min(12.0, voltageLimit / 1000.0);
+  volts = std::clamp(volts, -limit, limit);
+  return reversed ? -volts : volts;
+}
+
+bool MotorDevice::isCoasting() const {
+  // Brake and hold both short the windings, which the torque curve models at zero volts
+  return mode == Mode::voltage && command == 0 && brakeMode == pros::E_MOTOR_BRAKE_COAST;
+}
+
+double MotorDevice::current() const {
+  return stallCurrent * std::abs(torque) / curve().stallTorque;
+}
+
+Simulator &Simulator::get() {
+  // Never destroyed, so user globals may use the simulator during static destruction too
+  static Simulator *instance = new Simulator();
+  return *instance;
+}
+
+Simulator::Simulator() {
+  configure(Config());
+}
+
+void Simulator::configure(const Config &iconfig) {
+  std::lock_guard<std::mutex> lock(mutex);
+  config = iconfig;
+  random.seed(config.seed);
+  gpsDevice.dataRate = config.gpsDataRate;
+}
+
+void Simulator::start() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    physics = std::make_unique<XDrivePhysics>(config);
+    imuDevice.calibratedTime = clock.now();
+    gpsDevice.latest = {
+      config.startX, config.startY, 0, 0, wrapDegrees(config.startHeading, -180.0)};
+    gpsDevice.latestRotation = config.startHeading;
+  }
+
+  clock.attach();
+
+  std::promise<void> attached;
+  std::thread([this, &attached]() {
+    clock.attach();
+    attached.set_value();
+    loop();
+  }).detach();
+  attached.get_future().wait();
+}
+
+const Config &Simulator::getConfig() const {
+  return config;
+}
+
+Clock &Simulator::getClock() {
+  return clock;
+}
+
+const XDrivePhysics *Simulator::getPhysics() const {
+  return physics.get();
+}
+
+std::mutex &Simulator::getMutex() {
+  return mutex;
+}
+
+MotorDevice &Simulator::motor(const std::uint8_t iport) {
+  return motors[std::clamp<std::uint8_t>(iport, 1, numPorts) - 1];
+}
+
+GpsDevice &Simulator::gps() {
+  return gpsDevice;
+}
+
+ImuDevice &Simulator::imu() {
+  return imuDevice;
+}
+
+ControllerDevice &Simulator::controller(const pros::controller_id_e_t iid) {
+  return controllers[iid == pros::E_CONTROLLER_PARTNER ? 1 : 0];
+}
+
+std::map<std::int32_t, EncoderDevice> &Simulator::encoders() {
+  return encoderDevices;
+}
+
+void Simulator::setScreenLine(const std::int16_t iline, const std::string &itext) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &line = screen[iline];
+  if (config.echoScreen && line != itext) {
+    std::printf("[%9.3f] screen %2d: %s\n", clock.now() / 1e6, iline, itext.c_str());
+  }
+  line = itext;
+}
+
+std::map<std::int16_t, std::string> Simulator::getScreen() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return screen;
+}
+
+void Simulator::setStepObserver(
+  std::function<void(std::uint64_t, XDrivePhysics &)> iobserver) {
+  std::lock_guard<std::mutex> lock(mutex);
+  stepObserver = std::move(iobserver);
+}
+
+void Simulator::loop() {
+  const std::uint64_t period = config.physicsPeriodUs;
+  const double dt = period / 1e6;
+  std::uint64_t nextTime = clock.now();
+
+  while (true) {
+    nextTime += period;
+    clock.sleepUntil(nextTime);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stepMotors(dt);
+    stepSensors(dt);
+    if (stepObserver) {
+      stepObserver(clock.now(), *physics);
+    }
+  }
+}
+
+void Simulator::stepMotors(const double idt) {
+  const double supply = std::clamp(config.batteryVoltage - driverDrop, 0.0, 12.0);
+  const auto applied = [&](const MotorDevice &imotor) {
+    return std::clamp(imotor.computeVoltage(), -supply, supply);
+  };
+
+  std::array<double, 4> voltages;
+  std::array<XDrivePhysics::MotorCurve, 4> curves;
+  std::array<bool, 4> coasting;
+  for (int i = 0; i < 4; i++) {
+    const auto &drive = motor(config.drivePorts[i]);
+    voltages[i] = applied(drive);
+    curves[i] = drive.curve();
+    coasting[i] = drive.isCoasting();
+  }
+
+  physics->step(idt, voltages, curves, coasting);
+
+  for (std::uint8_t port = 1; port <= numPorts; port++) {
+    auto &device = motor(port);
+    const auto wheel = std::find(config.drivePorts.begin(), config.drivePorts.end(), port);
+
+    if (wheel != config.drivePorts.end()) {
+      const int i = static_cast<int>(wheel - config.drivePorts.begin());
+      device.voltage = voltages[i];
+      device.angle = physics->getWheelAngle(i);
+      device.velocity = physics->getWheelVelocity(i);
+      device.torque = physics->getWheelTorque(i);
+    } else {
+      // Anything else spins freely toward the speed its voltage would hold with no load
+      const auto curve = device.curve();
+      device.voltage = device.isCoasting() ? 0.0 : applied(device);
+      const double target = device.voltage / 12.0 * curve.freeSpeed;
+      device.velocity += (target - device.velocity) * std::min(1.0, idt / freeSpinTimeConstant);
+      device.angle += device.velocity * idt;
+      device.torque =
+        curve.stallTorque * (device.voltage / 12.0 - device.velocity / curve.freeSpeed);
+    }
+  }
+}
+
+void Simulator::stepSensors(const double idt) {
+  const std::uint64_t now = clock.now();
+  const auto &pose = physics->getPose();
+
+  // VEX headings are clockwise from +y; the model's theta is counterclockwise from +x
+  const double heading = 90.0 - pose.theta * radToDeg;
+  const double omegaCw = -physics->getAngularVelocity() * radToDeg;
+
+  // The GPS reports the robot center (its offset is already accounted for), some time after it
+  // sampled it
+  if (now >= gpsDevice.nextSampleTime) {
+    std::normal_distribution<double> positionNoise(0.0, config.gpsPositionNoise);
+    std::normal_distribution<double> headingNoise(0.0, config.gpsHeadingNoise);
+
+    GpsDevice::Sample sample;
+    sample.deliverTime = now + config.gpsLatency * 1000ull;
+    sample.rotation = heading + headingNoise(random);
+    sample.status.x = pose.x + positionNoise(random);
+    sample.status.y = pose.y + positionNoise(random);
+    sample.status.pitch = 0;
+    sample.status.roll = 0;
+    sample.status.yaw = wrapDegrees(sample.rotation, -180.0);
+    gpsDevice.pending.push_back(sample);
+    gpsDevice.nextSampleTime = now + std::max<std::uint32_t>(gpsDevice.dataRate, 5) * 1000ull;
+  }
+
+  while (!gpsDevice.pending.empty() && gpsDevice.pending.front().deliverTime <= now) {
+    gpsDevice.latest = gpsDevice.pending.front().status;
+    gpsDevice.latestRotation = gpsDevice.pending.front().rotation;
+    gpsDevice.pending.pop_front();
+  }
+
+  imuDevice.rate = omegaCw;
+  imuDevice.rotation += (omegaCw + config.imuDriftPerSecond) * idt;
+
+  for (auto &entry : encoderDevices) {
+    auto &encoder = entry.second;
+    if (encoder.wheel < 0) {
+      continue;
+    }
+
+    const auto &wheel = config.trackingWheels[encoder.wheel];
+    const double speed = physics->getPointSpeed(wheel.x, wheel.y, wheel.heading / radToDeg);
+    encoder.ticks += speed / wheel.radius * radToDeg * idt;
+  }
+}
+} // namespace sim
@@ -0,0 +1,122 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/xDrivePhysics.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+namespace {
+constexpr double pi = 3.14159265358979323846;
+constexpr double gravity = 9.81;
+
+double coulomb(const double ivelocity,
+               const double ifriction,
+               const double idt,
+               const double imass) {
+  // Never let friction reverse the motion within one step
+  const double maxImpulse = std::abs(ivelocity) * imass / idt;
+  return -std::copysign(std::min(ifriction, maxImpulse), ivelocity);
+}
+} // namespace
+
+XDrivePhysics::XDrivePhysics(const Config &iconfig) : config(iconfig) {
+  const double a = config.halfTrack;
+  const double d = std::sqrt(0.5);
+
+  // The right side motors are mounted mirrored, so their physical forward spins the wheel backward
+  wheelPositions = {{{a, a}, {a, -a}, {-a, -a}, {-a, a}}};
+  wheelDirections = {{{d, -d}, {-d, -d}, {-d, d}, {d, d}}};
+
+  pose.x = config.startX;
+  pose.y = config.startY;
+  pose.theta = (90.0 - config.startHeading) * pi / 180.0;
+}
+
+void XDrivePhysics::step(const double idt,
+                         const std::array<double, 4> &ivoltages,
+                         const std::array<MotorCurve, 4> &icurves,
+                         const std::array<bool, 4> &icoasting) {
+  const double maxWheelForce = config.wheelTraction * config.mass * gravity / 4;
+  const double inertia = config.mass * (2 * config.halfTrack) * (2 * config.halfTrack) / 6;
+
+  double fx = 0;
+  double fy = 0;
+  double torque = 0;
+  for (int i = 0; i < 4; i++) {
+    const auto &r = wheelPositions[i];
+    const auto &e = wheelDirections[i];
+
+    // Speed of the contact point along the drive direction; the wheel rolls without slipping
+    const double contactX = vx - omega * r[1];
+    const double contactY = vy + omega * r[0];
+    wheelVelocities[i] = (contactX * e[0] + contactY * e[1]) / config.wheelRadius;
+
+    const auto &curve = icurves[i];
+    wheelTorques[i] = icoasting[i] ? 0.0
+                                   : curve.stallTorque * (ivoltages[i] / 12.0 -
+                                                          wheelVelocities[i] / curve.freeSpeed);
+
+    const double force =
+      std::clamp(wheelTorques[i] / config.wheelRadius, -maxWheelForce, maxWheelForce);
+    fx += force * e[0];
+    fy += force * e[1];
+    torque += r[0] * force * e[1] - r[1] * force * e[0];
+  }
+
+  fx += -config.linearDamping * vx + coulomb(vx, config.linearFriction, idt, config.mass);
+  fy += -config.linearDamping * vy + coulomb(vy, config.linearFriction, idt, config.mass);
+  torque += -config.angularDamping * omega + coulomb(omega, config.angularFriction, idt, inertia);
+
+  vx += fx / config.mass * idt;
+  vy += fy / config.mass * idt;
+  omega += torque / inertia * idt;
+
+  // Integrate the pose with the new velocity, rotated into the field frame
+  const double c = std::cos(pose.theta);
+  const double s = std::sin(pose.theta);
+  pose.x += (vx * c - vy * s) * idt;
+  pose.y += (vx * s + vy * c) * idt;
+  pose.theta += omega * idt;
+
+  for (int i = 0; i < 4; i++) {
+    wheelAngles[i] += wheelVelocities[i] * idt;
+  }
+}
+
+const XDrivePhysics::Pose &XDrivePhysics::getPose() const {
+  return pose;
+}
+
+double XDrivePhysics::getAngularVelocity() const {
+  return omega;
+}
+
+double XDrivePhysics::getWheelAngle(const int iwheel) const {
+  return wheelAngles[iwheel];
+}
+
+double XDrivePhysics::getWheelVelocity(const int iwheel) const {
+  return wheelVelocities[iwheel];
+}
+
+double XDrivePhysics::getWheelTorque(const int iwheel) const {
+  return wheelTorques[iwheel];
+}
+
+double XDrivePhysics::getPointSpeed(const double ix, const double iy, const double iheading) const {
+  const double pointX = vx - omega * iy;
+  const double pointY = vy + omega * ix;
+  return pointX * std::cos(iheading) + pointY * std::sin(iheading);
+}
+
+void XDrivePhysics::applyImpulse(const double ix, const double iy) {
+  // Rotate into the robot frame
+  const double c = std::cos(pose.theta);
+  const double s = std::sin(pose.theta);
+  vx += (ix * c + iy * s) / config.mass;
+  vy += (iy * c - ix * s) / config.mass;
+}
+} // namespace sim
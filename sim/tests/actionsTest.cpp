@@ -0,0 +1,181 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/chassisController.hpp"
+#include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/async/asyncWrapper.hpp"
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/routine/action.hpp"
+#include "okapi/api/util/virtualClock.hpp"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace {
+using namespace okapi;
+
+/**
+ * A position controller which settles as soon as it has a target.
+ */
+class FakeLift : public AsyncPositionController<double, double> {
+  public:
+  void setTarget(const double itarget) override {
+    target = itarget;
+    hasTarget = true;
+  }
+
+  double getTarget() override {
+    return target;
+  }
+
+  double getProcessValue() const override {
+    return target;
+  }
+
+  double getError() const override {
+    return 0;
+  }
+
+  bool isSettled() override {
+    return hasTarget;
+  }
+
+  void reset() override {
+  }
+
+  void flipDisable() override {
+  }
+
+  void flipDisable(bool) override {
+  }
+
+  bool isDisabled() const override {
+    return false;
+  }
+
+  void waitUntilSettled() override {
+  }
+
+  void tarePosition() override {
+  }
+
+  void setMaxVelocity(std::int32_t) override {
+  }
+
+  void controllerSet(double) override {
+  }
+
+  double target{0};
+  bool hasTarget{false};
+};
+
+// The example in the Actions documentation, with a ChassisController for the drive and a derived
+// controller type for the lift. Only instantiated, to check that it compiles.
+template <typename Drive, typename Lift>
+auto documentedRoutine(Drive &drive, Lift &lift)
+  -> decltype(Actions::parallel(Actions::settled(drive), Actions::moveTo(lift, 600))) {
+  return Actions::parallel(Actions::settled(drive), Actions::moveTo(lift, 600));
+}
+
+static_assert(
+  std::is_same_v<decltype(documentedRoutine(std::declval<std::shared_ptr<ChassisController> &>(),
+                                            std::declval<std::shared_ptr<FakeLift> &>())),
+                 ActionPtr>,
+  "Actions::settled and Actions::moveTo should take any controller pointer.");
+
+int failures = 0;
+
+void check(const bool icondition, const std::string &idescription) {
+  if (!icondition) {
+    std::printf("FAIL: %s\n", idescription.c_str());
+    failures++;
+  }
+}
+
+void factoriesTakeAnyControllerPointer() {
+  auto lift = std::make_shared<FakeLift>();
+  std::shared_ptr<AsyncPositionController<double, double>> base = lift;
+
+  auto waitBase = Actions::settled(base);
+  check(waitBase->tick(0_ms) == Action::Status::running, "settled waits for the controller");
+
+  auto routine = Actions::sequence(Actions::moveTo(lift, 600), std::move(waitBase));
+  check(routine->tick(0_ms) == Action::Status::running,
+        "moveTo does not trust a settled report in the tick it sets the target");
+  check(lift->target == 600, "moveTo sets the target");
+  check(routine->tick(10_ms) == Action::Status::running, "nor 10 ms later");
+  check(routine->tick(20_ms) == Action::Status::done, "but does 20 ms later");
+}
+
+/**
+ * A mechanism whose position moves at a speed proportional to the controller output.
+ */
+class Plant : public ControllerInput<double>, public ControllerOutput<double> {
+  public:
+  double controllerGet() override {
+    return position;
+  }
+
+  void controllerSet(const double ivalue) override {
+    position += ivalue * 10;
+  }
+
+  double position{0};
+};
+
+/**
+ * Moves a real AsyncWrapper twice in a row, ticking the routine every 10 ms on a VirtualClock.
+ * The second move starts while the controller still reports that the first one is settled.
+ */
+void moveToWaitsForTheNewTarget() {
+  VirtualClock clock;
+  auto plant = std::make_shared<Plant>();
+  clock.expectThreads(1);
+  auto lift = std::make_shared<AsyncWrapper<double, double>>(
+    plant,
+    plant,
+    std::make_shared<IterativePosPIDController>(IterativePosPIDController::Gains{0.02, 0, 0, 0},
+                                                clock.createTimeUtil(2, 1, 50_ms)),
+    clock.createTimeUtil().getRateSupplier());
+  lift->startThread();
+  clock.runFor(0_ms);
+
+  double firstEnd = 0;
+  auto routine = Actions::sequence(Actions::moveTo(lift, 100),
+                                   Actions::call([&] { firstEnd = plant->position; }),
+                                   Actions::moveTo(lift, 300));
+
+  auto rate = clock.createRate();
+  while (routine->tick(clock.now()) == Action::Status::running && clock.now() < 10_s) {
+    rate->delayUntil(10_ms);
+  }
+
+  check(routine->isDone(), "the moves finish");
+  check(std::abs(firstEnd - 100) <= 2,
+        "the first move ends at its target, got " + std::to_string(firstEnd));
+  check(std::abs(plant->position - 300) <= 2,
+        "the second move ends at its target, got " + std::to_string(plant->position));
+
+  clock.detachCurrentThread();
+}
+} // namespace
+
+/**
+ * Checks that the Actions factories accept the controller pointers users have, and that moveTo
+ * sets the target and waits for the controller to settle at it.
+ *
+ *   make -C sim test
+ */
+int main() {
+  factoriesTakeAnyControllerPointer();
+  moveToWaitsForTheNewTarget();
+
+  if (failures == 0) {
+    std::printf("actionsTest: passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
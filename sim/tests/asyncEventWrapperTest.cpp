@@ -0,0 +1,149 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncEventWrapper.hpp"
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+#include "pros/rtos.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+using namespace okapi;
+
+int failures = 0;
+
+void check(const bool icondition, const std::string &idescription) {
+  if (!icondition) {
+    std::printf("FAIL: %s\n", idescription.c_str());
+    failures++;
+  }
+}
+
+CrossplatformEvent event;
+int value = 0;
+
+struct Waiter {
+  int until;
+  bool done;
+};
+
+void waitForValue(void *iwaiter) {
+  auto waiter = static_cast<Waiter *>(iwaiter);
+  event.wait([&] { return value >= waiter->until; });
+  waiter->done = true;
+}
+
+/**
+ * Two tasks wait on one event for different conditions. The first to wake finds its condition
+ * still false and waits again, which must not use up the second one's wakeup.
+ */
+void everyWaiterWakes() {
+  Waiter second{2, false};
+  Waiter first{1, false};
+
+  // The task waiting for 2 waits first, so it is the first to wake
+  pros::c::task_create(waitForValue, &second, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "2");
+  pros::c::delay(5);
+  pros::c::task_create(waitForValue, &first, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "1");
+  pros::c::delay(5);
+
+  value = 1;
+  event.notifyAll();
+  pros::c::delay(10);
+  check(first.done, "a notifyAll() wakes the task waiting for 1");
+  check(!second.done, "the task waiting for 2 waits on");
+
+  value = 2;
+  event.notifyAll();
+  pros::c::delay(10);
+  check(second.done, "the next notifyAll() wakes the task waiting for 2");
+
+  // Lets the tasks finish even when the checks failed
+  for (int i = 0; i < 10 && !(first.done && second.done); i++) {
+    event.notifyAll();
+    pros::c::delay(10);
+  }
+}
+
+/**
+ * A mechanism whose position moves at a speed proportional to the controller output.
+ */
+class Plant : public ControllerInput<double>, public ControllerOutput<double> {
+  public:
+  double controllerGet() override {
+    return position;
+  }
+
+  void controllerSet(const double ivalue) override {
+    position += ivalue * 10;
+  }
+
+  double position{0};
+};
+
+/**
+ * A PID controller which counts its steps and how often it is asked whether it settled.
+ */
+class CountingPID : public IterativePosPIDController {
+  public:
+  CountingPID() : IterativePosPIDController({0.01, 0, 0, 0}, TimeUtilFactory::createDefault()) {
+  }
+
+  double step(const double inewReading) override {
+    steps++;
+    return IterativePosPIDController::step(inewReading);
+  }
+
+  bool isSettled() override {
+    settledChecks++;
+    return IterativePosPIDController::isSettled();
+  }
+
+  std::size_t steps{0};
+  std::size_t settledChecks{0};
+};
+
+/**
+ * Asking the wrapper whether it settled, however often, does not ask the controller, whose
+ * SettledUtil must only see one error per step.
+ */
+void askingDoesNotAdvanceTheController() {
+  auto plant = std::make_shared<Plant>();
+  auto pid = std::make_shared<CountingPID>();
+  AsyncEventWrapper<double, double> controller(
+    plant, plant, pid, TimeUtilFactory::createDefault().getRateSupplier());
+  controller.startThread();
+  controller.setTarget(100);
+
+  for (int i = 0; i < 200; i++) {
+    controller.isSettled();
+    pros::c::delay(1);
+  }
+
+  check(pid->steps > 0, "the controller ran");
+  check(pid->settledChecks == pid->steps,
+        "the controller is asked once per step, asked " + std::to_string(pid->settledChecks) +
+          " times in " + std::to_string(pid->steps) + " steps");
+}
+} // namespace
+
+/**
+ * Checks that AsyncEventWrapper's event wakes every task waiting on it, and that asking whether
+ * the wrapper settled leaves its controller alone. Runs on the simulated RTOS, so the events'
+ * PROS implementation is the one tested.
+ *
+ *   make -C sim test
+ */
+int main() {
+  everyWaiterWakes();
+  askingDoesNotAdvanceTheController();
+
+  if (failures == 0) {
+    std::printf("asyncEventWrapperTest: passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/asyncLogSink.hpp"
+#include "okapi/api/util/asyncLogger.hpp"
+#include "okapi/impl/util/microTimer.hpp"
+#include "okapi/impl/util/rate.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+#include "pros/rtos.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+namespace {
+using namespace okapi;
+
+int failures = 0;
+
+void check(const bool icondition, const std::string &idescription) {
+  if (!icondition) {
+    std::printf("FAIL: %s\n", idescription.c_str());
+    failures++;
+  }
+}
+
+std::size_t count(const std::string &itext, const std::string &iword) {
+  std::size_t out = 0;
+  for (auto pos = itext.find(iword); pos != std::string::npos; pos = itext.find(iword, pos + 1)) {
+    out++;
+  }
+  return out;
+}
+
+/**
+ * A sink writing text to memory, so what it wrote can be read back after each drain().
+ */
+struct MemorySink {
+  explicit MemorySink(const std::size_t iringCapacity,
+                      std::unique_ptr<AbstractTimer> itimer = std::make_unique<MicroTimer>(),
+                      const AsyncLogSink::Mode imode = AsyncLogSink::Mode::text)
+    : sink(std::make_shared<AsyncLogSink>(std::move(itimer),
+                                          std::make_unique<Rate>(),
+                                          open_memstream(&buffer, &size),
+                                          iringCapacity,
+                                          20_ms,
+                                          imode)) {
+  }
+
+  ~MemorySink() {
+    sink.reset();
+    std::free(buffer);
+  }
+
+  std::string drain() {
+    sink->drain();
+    const std::string out(buffer, size);
+    const std::string text = out.substr(read);
+    read = out.size();
+    return text;
+  }
+
+  char *buffer{nullptr};
+  std::size_t size{0};
+  std::size_t read{0};
+  std::shared_ptr<AsyncLogSink> sink;
+};
+
+bool appendText(AsyncLogSink &isink, const std::string &itext) {
+  return isink.append(0, 0, itext.data(), itext.size());
+}
+
+/**
+ * A task logs more in one go than its ring holds before the drain runs. The ring keeps the
+ * first messages in order, drops the rest whole, and is usable again once drained.
+ */
+void burstOverflowsOneRing() {
+  MemorySink memory(8);
+  auto &sink = *memory.sink;
+
+  std::size_t accepted = 0;
+  for (int i = 0; i < 20; i++) {
+    accepted += appendText(sink, "line " + std::to_string(i) + "\n");
+  }
+  check(accepted == 8, "a ring of 8 accepts 8 messages, accepted " + std::to_string(accepted));
+  check(sink.getDropped() == 12, "the other 12 are dropped");
+
+  const std::string out = memory.drain();
+  check(out.rfind("line 0\nline 1\nline 2\nline 3\nline 4\nline 5\nline 6\nline 7\n", 0) == 0,
+        "the first 8 messages are written in order: " + out);
+  check(out.find("line 8\n") == std::string::npos, "dropped messages are not written");
+  check(count(out, "AsyncLogSink: Dropped 12 messages") == 1, "the drop is reported once");
+
+  check(appendText(sink, "after\n"), "the ring takes messages again after a drain");
+  const std::string next = memory.drain();
+  check(next == "after\n", "a drop is not reported twice: " + next);
+}
+
+/**
+ * A message longer than one record either fits whole or is dropped whole.
+ */
+void longMessageIsDroppedWhole() {
+  MemorySink memory(4);
+  auto &sink = *memory.sink;
+
+  check(appendText(sink, "short\n"), "one record fits");
+  check(appendText(sink, "short\n"), "two records fit");
+
+  // Three records, with two free
+  const std::string longLine(LogRecord::payloadSize * 2 + 10, 'x');
+  check(!appendText(sink, longLine + "\n"), "a message longer than the space left is dropped");
+  check(appendText(sink, "short\n"), "the space it did not use is still free");
+
+  const std::string out = memory.drain();
+  check(out.find('x') == std::string::npos, "no part of the dropped message is written");
+  check(count(out, "short\n") == 3, "the messages around it are written");
+
+  check(appendText(sink, longLine + "\n"), "it fits once the ring is drained");
+  check(memory.drain() == longLine + "\n", "and is written in one piece");
+}
+
+std::shared_ptr<AsyncLogSink> taskSink;
+
+void appendFromTask(void *) {
+  appendText(*taskSink, "task\n");
+}
+
+/**
+ * Every task past maxTasks has no ring of its own. Its messages are dropped and reported under a
+ * task of their own.
+ */
+void tasksPastMaxTasksAreCounted() {
+  MemorySink memory(4);
+  taskSink = memory.sink;
+
+  for (std::size_t i = 0; i < AsyncLogSink::maxTasks + 2; i++) {
+    pros::c::task_create(appendFromTask,
+                         nullptr,
+                         TASK_PRIORITY_DEFAULT,
+                         TASK_STACK_DEPTH_DEFAULT,
+                         ("Logger " + std::to_string(i)).c_str());
+  }
+  pros::c::delay(10);
+
+  check(memory.sink->getDropped() == 2, "the two tasks without a ring are counted");
+  const std::string out = memory.drain();
+  check(count(out, "task\n") == AsyncLogSink::maxTasks, "every task with a ring is written");
+  check(count(out, "(no ring) WARN: AsyncLogSink: Dropped 2 messages") == 1,
+        "the drops are reported as from no ring: " + out);
+
+  taskSink.reset();
+}
+
+std::shared_ptr<AsyncLogger> burstLogger;
+
+void logBurst(void *) {
+  // `logger` is what the LOG_* macros log to
+  const std::shared_ptr<Logger> logger = burstLogger;
+  for (int i = 0; i < 100; i++) {
+    LOG_INFO("burst " + std::to_string(i));
+  }
+  pros::c::delay(50);
+  LOG_INFO_S("after the burst");
+}
+
+/**
+ * A burst through an AsyncLogger with the drain task running. The drain runs at the lowest
+ * priority, so it only catches up once the burst is over.
+ */
+void burstThroughLoggerWithDrainTask() {
+  MemorySink memory(16);
+  memory.sink->startThread();
+  burstLogger = std::make_shared<AsyncLogger>(
+    TimeUtilFactory::createDefault(), memory.sink, Logger::LogLevel::info);
+
+  pros::c::task_create(logBurst, nullptr, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Burst");
+  pros::c::delay(100);
+
+  const std::string out = memory.drain();
+  check(count(out, "(Burst) INFO: burst") == 16, "the ring's worth of the burst is written");
+  check(out.find("INFO: burst 15\n") != std::string::npos &&
+          out.find("INFO: burst 16\n") == std::string::npos,
+        "the first messages of the burst are the ones kept");
+  check(count(out, "(Burst) WARN: AsyncLogSink: Dropped 84 messages") == 1,
+        "the rest are reported as dropped: " + out);
+  check(out.find("INFO: after the burst\n") != std::string::npos,
+        "messages after the burst are written");
+
+  burstLogger.reset();
+}
+
+/**
+ * The time the sink in microsecondsAreKept() sees, moved on by hand.
+ */
+double now = 0; // ms
+
+class ManualTimer : public AbstractTimer {
+  public:
+  ManualTimer() : AbstractTimer(now * millisecond) {
+  }
+
+  QTime millis() const override {
+    return now * millisecond;
+  }
+};
+
+/**
+ * Records are stamped in microseconds, to the resolution of the sink's timer.
+ */
+void microsecondsAreKept() {
+  // What a MicroTimer reads 3991 us after startup, which comes back from seconds a hair short
+  now = 3991 / 1000.0;
+  MemorySink memory(4, std::make_unique<ManualTimer>(), AsyncLogSink::Mode::binary);
+  appendText(*memory.sink, "stamped\n");
+  const std::string out = memory.drain();
+
+  // The magic and version, then the task's name, then the message
+  const std::size_t task = sizeof(AsyncLogSink::binaryMagic);
+  const std::size_t message = task + 3 + (out.size() > task + 2 ? out[task + 2] : 0);
+  std::uint32_t time = 0;
+  if (out.size() >= message + 6 && out[message] == 'M') {
+    std::memcpy(&time, out.data() + message + 2, sizeof(time));
+  }
+  check(time == 3991, "a message at 3991 us is stamped 3991 us, got " + std::to_string(time));
+}
+
+/**
+ * A LOG_*_F statement on a Logger which is not an AsyncLogger is formatted where it is logged,
+ * into a buffer on the stack which cuts long messages short.
+ */
+void formattedForAPlainLogger() {
+  char *buffer = nullptr;
+  std::size_t size = 0;
+  {
+    // `logger` is what the LOG_* macros log to
+    const auto logger = std::make_shared<Logger>(TimeUtilFactory::createDefault().getTimer(),
+                                                 open_memstream(&buffer, &size),
+                                                 Logger::LogLevel::info);
+    LOG_INFO_F("value %d is %s", 3, "ok");
+    LOG_INFO_F("%400d", 7);
+  }
+
+  // The Logger closed the stream, so the buffer holds everything it wrote
+  const std::string out(buffer, size);
+  std::free(buffer);
+  check(out.find("INFO: value 3 is ok\n") != std::string::npos, "the message is formatted: " + out);
+
+  const auto start = out.find("INFO:  ");
+  const auto end = out.find('\n', start);
+  check(start != std::string::npos && end - (start + 6) == AsyncLogger::maxTextSize - 1 &&
+          out[end - 1] == ' ',
+        "a long message is cut to maxTextSize: " + out);
+}
+} // namespace
+
+/**
+ * Overflows AsyncLogSink's rings in the ways a burst of logging can: one task logging more than
+ * its ring holds, a message too long for the space left, and more tasks than there are rings.
+ * Runs on the simulated RTOS, so when each task runs is the same every time.
+ *
+ *   make -C sim test
+ */
+int main() {
+  burstOverflowsOneRing();
+  longMessageIsDroppedWhole();
+  tasksPastMaxTasksAreCounted();
+  burstThroughLoggerWithDrainTask();
+  formattedForAPlainLogger();
+  microsecondsAreKept();
+
+  if (failures == 0) {
+    std::printf("asyncLogSinkTest: passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/executorStepped.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+#include "pros/rtos.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+using namespace okapi;
+
+int failures = 0;
+
+void check(const bool icondition, const std::string &idescription) {
+  if (!icondition) {
+    std::printf("FAIL: %s\n", idescription.c_str());
+    failures++;
+  }
+}
+
+/**
+ * What ran in each tick, one letter per step.
+ */
+std::string order;
+
+/**
+ * A mechanism whose position moves at a speed proportional to the controller output, which
+ * writes iname to order each time it is read.
+ */
+class Plant : public ControllerInput<double>, public ControllerOutput<double> {
+  public:
+  explicit Plant(const char iname) : name(iname) {
+  }
+
+  double controllerGet() override {
+    order += name;
+    reads++;
+    return position;
+  }
+
+  void controllerSet(const double ivalue) override {
+    position += ivalue * 10;
+  }
+
+  char name;
+  std::size_t reads{0};
+  double position{0};
+};
+
+/**
+ * Two stock position controllers on one executor, at 10 ms and 30 ms, between a sensor read and
+ * a motor write step. Each tick runs the stages in order and the controllers in the order they
+ * were started, and each controller runs every sample time.
+ */
+void controllersRunInOrderAtTheirPeriods() {
+  const TimeUtil timeUtil = TimeUtilFactory::createDefault();
+  ControlExecutor executor(timeUtil, 10_ms);
+
+  // Added out of stage order, to check the stages are run in order anyway
+  executor.add(ControlExecutor::Stage::motorWrite, [] { order += 'w'; });
+  executor.add(ControlExecutor::Stage::sensorRead, [] { order += 's'; });
+
+  auto fastPlant = std::make_shared<Plant>('a');
+  auto slowPlant = std::make_shared<Plant>('b');
+  auto fast =
+    std::make_shared<ExecutorPosPIDController>(fastPlant, fastPlant, timeUtil, 0.01, 0, 0);
+  auto slow =
+    std::make_shared<ExecutorPosPIDController>(slowPlant, slowPlant, timeUtil, 0.01, 0, 0);
+  slow->setSampleTime(30_ms);
+  fast->startOn(executor);
+  slow->startOn(executor);
+  // Already on the executor, so this must not start a second loop
+  slow->startThread();
+
+  fast->setTarget(100);
+  slow->setTarget(100);
+  // Ticked by hand, a period of simulated time apart, so the test decides where each tick ends
+  order.clear();
+  for (int i = 0; i < 6; i++) {
+    executor.tick();
+    order += '|';
+    pros::c::delay(10);
+  }
+
+  check(order == "sabw|saw|saw|sabw|saw|saw|",
+        "the stages and controllers run in order at their periods, got " + order);
+  check(fastPlant->reads == 6 && slowPlant->reads == 2, "each controller ran at its own period");
+  check(fastPlant->position > 0, "the controller running every tick wrote an output");
+
+  // Removed from the executor when destroyed
+  fast.reset();
+  order.clear();
+  executor.tick();
+  check(order == "sbw", "a destroyed controller's step is removed, got " + order);
+  // Its first step only starts its sample timer, and the second can land a hair short of 30 ms
+  check(slowPlant->position > 0, "the controller running every third tick wrote an output");
+}
+} // namespace
+
+/**
+ * Checks that a ControlExecutor runs the stock AsyncWrapper controllers with its other steps, in
+ * order and at each controller's sample time. Runs on the simulated RTOS, so the controllers see
+ * the time pass between ticks.
+ *
+ *   make -C sim test
+ */
+int main() {
+  controllersRunInOrderAtTheirPeriods();
+
+  if (failures == 0) {
+    std::printf("controlExecutorTest: passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/poseSettledUtil.hpp"
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+using namespace okapi;
+
+int failures = 0;
+
+void check(const bool icondition, const std::string &idescription) {
+  if (!icondition) {
+    std::printf("FAIL: %s\n", idescription.c_str());
+    failures++;
+  }
+}
+
+/**
+ * The time the PoseSettledUtil sees, moved on by hand.
+ */
+double now = 0; // ms
+
+class ManualTimer : public AbstractTimer {
+  public:
+  ManualTimer() : AbstractTimer(now * millisecond) {
+  }
+
+  QTime millis() const override {
+    return now * millisecond;
+  }
+};
+
+/**
+ * Feeds the same pose every iperiod ms for 1 s.
+ *
+ * @return Whether it was settled at the end.
+ */
+bool holdStill(PoseSettledUtil &iutil, const double iperiod) {
+  const OdomState target{0_m, 0_m, 0_deg};
+  bool settled = false;
+  for (double end = now + 1000; now < end; now += iperiod) {
+    settled = iutil.isSettled(target, target);
+  }
+  return settled;
+}
+
+void settlesWhenTheLoopIsSlowerThanTheWindow() {
+  now = 0;
+  PoseSettledUtil util(std::make_unique<ManualTimer>());
+  check(holdStill(util, 200), "a pose updated every 200 ms settles with a 100 ms window");
+  check(util.getStatus().speed == 0_mps, "its speed is measured between the last two poses");
+}
+
+void movingSlowlyDoesNotSettle() {
+  now = 0;
+  // Close enough the whole time, so only the speed keeps it from settling
+  PoseSettledUtil util(std::make_unique<ManualTimer>(), 10_in, 2_deg, 2_in / second);
+  const OdomState target{0_m, 0_m, 0_deg};
+
+  // 4 in/s across the target
+  bool settled = false;
+  for (int i = 0; i < 50; i++, now += 20) {
+    settled = util.isSettled({i * 0.08_in - 2_in, 0_m, 0_deg}, target) || settled;
+  }
+  check(!settled, "a pose moving at 4 in/s never settles");
+  check(util.getStatus().speed > 2_in / second, "its speed is measured over the window");
+}
+
+void firstPoseIsNotStill() {
+  now = 0;
+  PoseSettledUtil util(std::make_unique<ManualTimer>(), 1_in, 2_deg, 2_in / second);
+  const OdomState target{0_m, 0_m, 0_deg};
+  util.isSettled(target, target);
+  check(!util.getStatus().isSpeedSettled, "one pose is not enough to measure speed");
+}
+} // namespace
+
+/**
+ * Checks how PoseSettledUtil measures speed from the poses it is given.
+ *
+ *   make -C sim test
+ */
+int main() {
+  settlesWhenTheLoopIsSlowerThanTheWindow();
+  movingSlowlyDoesNotSettle();
+  firstPoseIsNotStill();
+
+  if (failures == 0) {
+    std::printf("poseSettledUtilTest: passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
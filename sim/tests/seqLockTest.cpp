@@ -0,0 +1,149 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/seqLock.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+using namespace okapi;
+
+int failures = 0;
+
+void check(const bool icondition, const std::string &idescription) {
+  if (!icondition) {
+    std::printf("FAIL: %s\n", idescription.c_str());
+    failures++;
+  }
+}
+
+/**
+ * A value big enough that copying it takes a while, with every word derived from the store's
+ * number, so a copy mixing two stores is caught.
+ */
+struct Snapshot {
+  std::uint64_t number;
+  std::array<std::uint64_t, 1023> words;
+};
+
+Snapshot makeSnapshot(const std::uint64_t inumber) {
+  Snapshot out{};
+  out.number = inumber;
+  for (std::size_t i = 0; i < out.words.size(); i++) {
+    out.words[i] = inumber * 0x9e3779b97f4a7c15ull + i;
+  }
+  return out;
+}
+
+bool isWhole(const Snapshot &isnapshot) {
+  for (std::size_t i = 0; i < isnapshot.words.size(); i++) {
+    if (isnapshot.words[i] != isnapshot.number * 0x9e3779b97f4a7c15ull + i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct ReaderStats {
+  std::size_t reads{0};
+  std::size_t torn{0};
+  std::size_t wrongVersion{0};
+  std::size_t wentBack{0};
+  std::size_t lapped{0};
+};
+
+/**
+ * One writer stores as fast as it can while several readers load as fast as they can, so the
+ * writer keeps finishing stores, and often laps readers, in the middle of their copies. Every
+ * value read must be one the writer stored whole, with its own version, and no reader may see the
+ * values go back in time.
+ *
+ * Whether a broken lock is caught depends on the readers being interrupted mid-copy, so it is
+ * caught more reliably the more cores the host has. Even on one core, loosening load()'s retry
+ * check makes this fail on most runs.
+ */
+void manyReadersNeverSeeTornValues() {
+  constexpr std::size_t numReaders = 4;
+  constexpr auto duration = std::chrono::milliseconds(1000);
+
+  SeqLock<Snapshot> lock(makeSnapshot(0));
+  std::atomic_bool running{true};
+  std::vector<ReaderStats> stats(numReaders);
+
+  std::vector<std::thread> readers;
+  for (std::size_t r = 0; r < numReaders; r++) {
+    readers.emplace_back([&, r]() {
+      ReaderStats &out = stats[r];
+      std::uint64_t last = 0;
+      while (running.load(std::memory_order_relaxed)) {
+        const std::uint32_t before = lock.getVersion();
+        std::uint32_t version;
+        const Snapshot snapshot = lock.load(version);
+        const std::uint32_t after = lock.getVersion();
+
+        out.reads++;
+        out.torn += !isWhole(snapshot);
+        out.wrongVersion += version != static_cast<std::uint32_t>(snapshot.number);
+        out.wentBack += snapshot.number < last;
+        // The writer finished at least two stores while this load ran
+        out.lapped += after - before >= 2;
+        last = snapshot.number;
+      }
+    });
+  }
+
+  std::uint64_t stores = 0;
+  const auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+    lock.store(makeSnapshot(++stores));
+  }
+  running = false;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  ReaderStats total;
+  for (const auto &reader : stats) {
+    total.reads += reader.reads;
+    total.torn += reader.torn;
+    total.wrongVersion += reader.wrongVersion;
+    total.wentBack += reader.wentBack;
+    total.lapped += reader.lapped;
+  }
+
+  std::printf("seqLockTest: %llu stores, %zu reads, %zu lapped by the writer\n",
+              static_cast<unsigned long long>(stores),
+              total.reads,
+              total.lapped);
+  check(total.reads > 0, "the readers ran");
+  check(total.torn == 0, std::to_string(total.torn) + " reads mixed two stores");
+  check(total.wrongVersion == 0,
+        std::to_string(total.wrongVersion) + " reads returned another store's version");
+  check(total.wentBack == 0, std::to_string(total.wentBack) + " reads went back in time");
+  check(lock.getVersion() == static_cast<std::uint32_t>(stores), "every store is counted");
+  check(isWhole(lock.load()) && lock.load().number == stores, "the last store is kept");
+}
+} // namespace
+
+/**
+ * Hammers SeqLock with one writer and several readers on real host threads and checks that no
+ * reader ever sees a torn value.
+ *
+ *   make -C sim test
+ */
+int main() {
+  manyReadersNeverSeeTornValues();
+
+  if (failures == 0) {
+    std::printf("seqLockTest: passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/process.hpp"
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+int failures = 0;
+
+void check(const bool icondition, const std::string &idescription) {
+  if (!icondition) {
+    std::printf("FAIL: %s\n", idescription.c_str());
+    failures++;
+  }
+}
+
+/**
+ * @return The `result` line the simulator printed, or an empty string if it did not run.
+ */
+std::string runResult(const std::vector<std::string> &iargv) {
+  std::string output;
+  if (!sim::runProcess(iargv, output)) {
+    return "";
+  }
+
+  std::istringstream lines(output);
+  for (std::string line; std::getline(lines, line);) {
+    if (line.rfind("result ", 0) == 0) {
+      return line;
+    }
+  }
+  return "";
+}
+
+/**
+ * Runs the simulator twice with iargs and checks that it finished the same way both times. The
+ * rest of the output has host timings in it, so only the result line is compared.
+ */
+std::string checkRepeatable(const std::string &isim, const std::vector<std::string> &iargs) {
+  std::vector<std::string> argv{isim};
+  argv.insert(argv.end(), iargs.begin(), iargs.end());
+
+  const std::string first = runResult(argv);
+  const std::string second = runResult(argv);
+  check(!first.empty(), iargs.front() + " runs and prints a result");
+  check(first == second, iargs.front() + " is repeatable: '" + first + "' then '" + second + "'");
+  return first;
+}
+} // namespace
+
+/**
+ * Runs gpstest-sim on the project's opcontrol() and on a benchmark scenario, and checks that each
+ * runs to the end and does exactly the same thing when run again.
+ *
+ *   make -C sim test
+ *
+ * or, after `make -C sim`:
+ *
+ *   sim/build/tests/simSmokeTest --sim=sim/build/gpstest-sim
+ */
+int main(int argc, char **argv) {
+  std::string sim = "./gpstest-sim";
+  for (int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    if (arg.rfind("--sim=", 0) == 0) {
+      sim = arg.substr(6);
+    }
+  }
+
+  checkRepeatable(sim, {"--mode=opcontrol", "--duration=2000", "--gps-noise=0.01"});
+
+  const std::string scenario = checkRepeatable(
+    sim, {"--scenario=point-to-point", "--controller=chassisPid", "--duration=10000"});
+  check(scenario.find("completed=1") != std::string::npos,
+        "the chassisPid scenario finishes: '" + scenario + "'");
+
+  if (failures == 0) {
+    std::printf("simSmokeTest: passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
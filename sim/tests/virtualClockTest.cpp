@@ -0,0 +1,158 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncWrapper.hpp"
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/util/virtualClock.hpp"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+using namespace okapi;
+
+int failures = 0;
+
+void check(const bool icondition, const std::string &idescription) {
+  if (!icondition) {
+    std::printf("FAIL: %s\n", idescription.c_str());
+    failures++;
+  }
+}
+
+/**
+ * A mechanism whose position moves at a speed proportional to the controller output.
+ */
+class Plant : public ControllerInput<double>, public ControllerOutput<double> {
+  public:
+  double controllerGet() override {
+    return position;
+  }
+
+  void controllerSet(const double ivalue) override {
+    position += ivalue * 10;
+  }
+
+  double position{0};
+};
+
+/**
+ * A PID controller which counts its steps.
+ */
+class CountingPID : public IterativePosPIDController {
+  public:
+  explicit CountingPID(const TimeUtil &itimeUtil)
+    : IterativePosPIDController({0.01, 0, 0, 0}, itimeUtil) {
+  }
+
+  double step(const double inewReading) override {
+    steps++;
+    return IterativePosPIDController::step(inewReading);
+  }
+
+  std::atomic<std::size_t> steps{0};
+};
+
+struct Run {
+  std::size_t steps;
+  double position;
+};
+
+/**
+ * Runs an AsyncWrapper, whose thread the clock does not start, for 2 simulated seconds the way
+ * the VirtualClock documentation does.
+ */
+Run runAsyncWrapper() {
+  VirtualClock clock;
+  auto plant = std::make_shared<Plant>();
+  auto pid = std::make_shared<CountingPID>(clock.createTimeUtil());
+
+  clock.expectThreads(1);
+  AsyncWrapper<double, double> controller(
+    plant, plant, pid, clock.createTimeUtil().getRateSupplier());
+  controller.startThread();
+  clock.runFor(0_ms);
+
+  controller.setTarget(100);
+  clock.runFor(2_s);
+  const Run run{pid->steps.load(), plant->position};
+
+  clock.detachCurrentThread();
+  return run;
+}
+
+void asyncWrapperStepsTheSameEveryRun() {
+  const Run first = runAsyncWrapper();
+  // The first step is at 0 ms, and the thread running runFor() wakes first at 2 s
+  check(first.steps == 200,
+        "an AsyncWrapper steps 200 times in 2 s, got " + std::to_string(first.steps));
+  check(first.position > 90, "the controller moved the plant");
+
+  for (int i = 0; i < 10; i++) {
+    const Run again = runAsyncWrapper();
+    if (again.steps != first.steps || again.position != first.position) {
+      check(false,
+            "run " + std::to_string(i + 2) + " took " + std::to_string(again.steps) +
+              " steps to " + std::to_string(again.position) + ", not " +
+              std::to_string(first.steps) + " to " + std::to_string(first.position));
+      break;
+    }
+  }
+}
+
+void startedThreadsRunInStep() {
+  VirtualClock clock;
+  auto rate10 = clock.createRate();
+  auto rate25 = clock.createRate();
+  std::atomic_bool running{true};
+  std::size_t steps10 = 0;
+  std::size_t steps25 = 0;
+  std::string order;
+
+  // Threads only run one at a time, so they can share these without locking
+  auto thread10 = clock.startThread([&]() {
+    while (running) {
+      steps10++;
+      order += 'a';
+      rate10->delayUntil(10_ms);
+    }
+  });
+  auto thread25 = clock.startThread([&]() {
+    while (running) {
+      steps25++;
+      order += 'b';
+      rate25->delayUntil(25_ms);
+    }
+  });
+
+  clock.runFor(100_ms);
+  check(steps10 == 10, "a 10 ms loop steps 10 times in 100 ms, got " + std::to_string(steps10));
+  check(steps25 == 4, "a 25 ms loop steps 4 times in 100 ms, got " + std::to_string(steps25));
+  // Ties go to whichever waited first
+  check(order == "abaabaabaaabaa", "the loops take turns in time order, got " + order);
+
+  running = false;
+  clock.detachCurrentThread();
+  thread10.join();
+  thread25.join();
+}
+} // namespace
+
+/**
+ * Checks that threads waiting on a VirtualClock take the same steps on every run, whether the
+ * clock started them or they were expected with expectThreads().
+ *
+ *   make -C sim test
+ */
+int main() {
+  asyncWrapperStepsTheSameEveryRun();
+  startedThreadsRunInStep();
+
+  if (failures == 0) {
+    std::printf("virtualClockTest: passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/benchmark.hpp"
+#include "sim/process.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+std::vector<std::string> split(const std::string &ilist) {
+  std::vector<std::string> items;
+  std::stringstream stream(ilist);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    items.push_back(item);
+  }
+  return items;
+}
+
+/**
+ * @return The raw value of ikey in a flat JSON object, or "-" if it is missing.
+ */
+std::string field(const std::string &ijson, const std::string &ikey) {
+  const auto key = ijson.find("\"" + ikey + "\":");
+  if (key == std::string::npos) {
+    return "-";
+  }
+
+  const auto start = key + ikey.size() + 3;
+  return ijson.substr(start, ijson.find_first_of(",}", start) - start);
+}
+} // namespace
+
+/**
+ * Runs every benchmark scenario (see sim/include/sim/benchmark.hpp) against every controller, one
+ * simulator process per run, and writes one line of JSON per run. Build the simulator first (see
+ * sim/include/sim/simulator.hpp), then:
+ *
+ *   g++ -std=gnu++17 -O2 -Iinclude -Isim/include sim/tools/benchmark.cpp sim/src/scenarios.cpp \
+ *       sim/src/process.cpp -pthread -o gpstest-benchmark
+ *   ./gpstest-benchmark --sim=./gpstest-sim --out=benchmark.jsonl
+ *
+ * --scenarios and --controllers take comma separated names to run a subset. Arguments after `--`
+ * are passed to every run. The output is in catalogue order and, with the default noise seed,
+ * the same on every run, so two outputs can be diffed to find regressions. A table is printed to
+ * stderr.
+ *
+ * Every controller is a reference the others are compared against, so exits with status 1 if any
+ * run crashed, or did not return and settle at the end of its scenario before --duration.
+ */
+int main(int argc, char **argv) {
+  std::string simulator;
+  std::string outPath;
+  std::size_t jobs = std::max(1u, std::thread::hardware_concurrency());
+  // The route takes chassisPid about 17 s
+  std::uint32_t duration = 30000;
+  std::vector<std::string> scenarios;
+  std::vector<std::string> controllers = sim::getControllers();
+  std::vector<std::string> extraArgs;
+
+  for (const auto &scenario : sim::getScenarios()) {
+    scenarios.push_back(scenario.name);
+  }
+
+  const std::map<std::string, std::function<void(const std::string &)>> flags{
+    {"sim", [&](const std::string &value) { simulator = value; }},
+    {"out", [&](const std::string &value) { outPath = value; }},
+    {"jobs", [&](const std::string &value) { jobs = std::max(1ul, std::stoul(value)); }},
+    {"duration", [&](const std::string &value) { duration = std::stoul(value); }},
+    {"scenarios", [&](const std::string &value) { scenarios = split(value); }},
+    {"controllers", [&](const std::string &value) { controllers = split(value); }}};
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      const std::string arg(argv[i]);
+      if (arg == "--") {
+        extraArgs.assign(argv + i + 1, argv + argc);
+        break;
+      }
+
+      const auto equals = arg.find('=');
+      const auto flag =
+        arg.compare(0, 2, "--") == 0 ? flags.find(arg.substr(2, equals - 2)) : flags.end();
+      if (equals == std::string::npos || flag == flags.end()) {
+        throw std::invalid_argument("Unknown argument " + arg);
+      }
+      flag->second(arg.substr(equals + 1));
+    }
+
+    if (simulator.empty()) {
+      throw std::invalid_argument("--sim is required");
+    }
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  struct Run {
+    std::string scenario;
+    std::string controller;
+    std::string json;
+  };
+
+  std::vector<Run> runs;
+  for (const auto &scenario : scenarios) {
+    for (const auto &controller : controllers) {
+      runs.push_back({scenario, controller, ""});
+    }
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::vector<std::thread> workers;
+  for (std::size_t i = 0; i < std::min(jobs, runs.size()); i++) {
+    workers.emplace_back([&]() {
+      for (std::size_t index = next++; index < runs.size(); index = next++) {
+        auto &run = runs[index];
+        std::vector<std::string> args{simulator,
+                                      "--scenario=" + run.scenario,
+                                      "--controller=" + run.controller,
+                                      "--duration=" + std::to_string(duration)};
+        args.insert(args.end(), extraArgs.begin(), extraArgs.end());
+
+        std::string output;
+        const bool exited = sim::runProcess(args, output);
+        const auto line = output.rfind("benchmark {");
+        if (exited && line != std::string::npos) {
+          const auto start = line + 10;
+          run.json = output.substr(start, output.find('\n', start) - start);
+        } else {
+          run.json = "{\"scenario\":\"" + run.scenario + "\",\"controller\":\"" +
+                     run.controller + "\",\"crashed\":true}";
+        }
+      }
+    });
+  }
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  std::FILE *out = outPath.empty() ? stdout : std::fopen(outPath.c_str(), "w");
+  if (!out) {
+    std::fprintf(stderr, "Could not open %s\n", outPath.c_str());
+    return 1;
+  }
+
+  bool crashed = false;
+  std::vector<const Run *> unsettled;
+  std::fprintf(stderr,
+               "%-16s %-14s %9s %9s %9s %7s %8s %9s\n",
+               "scenario",
+               "controller",
+               "settle s",
+               "over m",
+               "over deg",
+               "path",
+               "peak A",
+               "cpu us");
+  for (const auto &run : runs) {
+    std::fprintf(out, "%s\n", run.json.c_str());
+    crashed = crashed || field(run.json, "crashed") == "true";
+    // A controller which never returned did not see itself settle, even if the robot ended up
+    // close enough
+    if (field(run.json, "completed") == "false" || field(run.json, "settleTime") == "null") {
+      unsettled.push_back(&run);
+    }
+    std::fprintf(stderr,
+                 "%-16s %-14s %9s %9s %9s %7s %8s %9s\n",
+                 run.scenario.c_str(),
+                 run.controller.c_str(),
+                 field(run.json, "settleTime").c_str(),
+                 field(run.json, "overshoot").c_str(),
+                 field(run.json, "headingOvershoot").c_str(),
+                 field(run.json, "pathLengthRatio").c_str(),
+                 field(run.json, "peakCurrent").c_str(),
+                 field(run.json, "cpuPerTick").c_str());
+  }
+
+  if (out != stdout) {
+    std::fclose(out);
+  }
+
+  for (const auto run : unsettled) {
+    std::fprintf(stderr,
+                 "%s did not settle in %s\n",
+                 run->controller.c_str(),
+                 run->scenario.c_str());
+  }
+
+  return crashed || !unsettled.empty() ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+using namespace okapi;
+
+/**
+ * AverageFilter as OkapiLib wrote it, re-summing the whole window for every reading.
+ */
+template <std::size_t n> class ResumAverageFilter : public Filter {
+  public:
+  double filter(const double ireading) override {
+    data[index++] = ireading;
+    if (index >= n) {
+      index = 0;
+    }
+
+    output = 0;
+    for (const double sample : data) {
+      output += sample;
+    }
+    output /= static_cast<double>(n);
+    return output;
+  }
+
+  double getOutput() const override {
+    return output;
+  }
+
+  protected:
+  std::array<double, n> data{};
+  std::size_t index = 0;
+  double output = 0;
+};
+
+/**
+ * MedianFilter as OkapiLib wrote it, copying the window and selecting the lower median for every
+ * reading.
+ */
+template <std::size_t n> class SelectMedianFilter : public Filter {
+  public:
+  double filter(const double ireading) override {
+    data[index++] = ireading;
+    if (index >= n) {
+      index = 0;
+    }
+
+    std::array<double, n> copy = data;
+    std::nth_element(copy.begin(), copy.begin() + (n - 1) / 2, copy.end());
+    output = copy[(n - 1) / 2];
+    return output;
+  }
+
+  double getOutput() const override {
+    return output;
+  }
+
+  protected:
+  std::array<double, n> data{};
+  std::size_t index = 0;
+  double output = 0;
+};
+
+/**
+ * Encoder-like readings: a slow ramp with noise and the odd spike, the same on every run.
+ */
+std::vector<double> makeReadings(const std::size_t icount) {
+  std::vector<double> readings(icount);
+  std::uint32_t state = 12345;
+  for (std::size_t i = 0; i < icount; i++) {
+    state = state * 1664525u + 1013904223u;
+    const double noise = (state >> 8) / static_cast<double>(1u << 24) - 0.5;
+    readings[i] = 0.01 * static_cast<double>(i) + noise + (i % 97 == 0 ? 50 : 0);
+  }
+  return readings;
+}
+
+/**
+ * Runs ifilter over ireadings.
+ *
+ * @param ooutputs Set to its outputs.
+ * @return The time it took per reading (ns).
+ */
+double run(Filter &ifilter, const std::vector<double> &ireadings, std::vector<double> &ooutputs) {
+  ooutputs.resize(ireadings.size());
+
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < ireadings.size(); i++) {
+    ooutputs[i] = ifilter.filter(ireadings[i]);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() / ireadings.size();
+}
+
+/**
+ * Times ibefore and iafter and prints a row comparing them.
+ *
+ * @param itolerance How far apart their outputs may be, relative to the outputs' size.
+ * @return Whether their outputs matched.
+ */
+bool compare(const char *iname,
+             const std::size_t iwindow,
+             Filter &ibefore,
+             Filter &iafter,
+             const std::vector<double> &ireadings,
+             const double itolerance) {
+  std::vector<double> beforeOutputs;
+  std::vector<double> afterOutputs;
+  const double beforeTime = run(ibefore, ireadings, beforeOutputs);
+  const double afterTime = run(iafter, ireadings, afterOutputs);
+
+  bool matches = true;
+  for (std::size_t i = 0; i < ireadings.size(); i++) {
+    const double scale = std::max(1.0, std::abs(beforeOutputs[i]));
+    matches &= std::abs(afterOutputs[i] - beforeOutputs[i]) <= itolerance * scale;
+  }
+
+  std::printf("%-8s %6zu %14.1f %14.1f %9.1fx %s\n",
+              iname,
+              iwindow,
+              beforeTime,
+              afterTime,
+              beforeTime / afterTime,
+              matches ? "" : "MISMATCH");
+  return matches;
+}
+
+template <std::size_t n> bool benchmarkWindow(const std::vector<double> &ireadings) {
+  ResumAverageFilter<n> resumAverage;
+  AverageFilter<n> average;
+  SelectMedianFilter<n> selectMedian;
+  MedianFilter<n> median;
+
+  // The running sum is rounded differently from a fresh sum, so the averages only nearly match
+  const bool averageMatches = compare("average", n, resumAverage, average, ireadings, 1e-9);
+  const bool medianMatches = compare("median", n, selectMedian, median, ireadings, 0);
+  return averageMatches && medianMatches;
+}
+
+template <std::size_t... ns> bool benchmarkWindows(const std::vector<double> &ireadings) {
+  return (benchmarkWindow<ns>(ireadings) & ...);
+}
+} // namespace
+
+/**
+ * Times AverageFilter and MedianFilter for window sizes from 5 to 1024 against the versions
+ * OkapiLib shipped, which re-sum or copy and select the whole window for every reading, and
+ * checks that both give the same outputs.
+ *
+ *   make -C sim tools
+ *   sim/build/gpstest-filterbench --readings=200000
+ *
+ * Exits with status 1 if any output differs from the old version's.
+ */
+int main(int argc, char **argv) {
+  std::size_t readings = 200000;
+
+  const std::map<std::string, std::function<void(const std::string &)>> flags{
+    {"readings", [&](const std::string &value) { readings = std::stoul(value); }}};
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      const std::string arg(argv[i]);
+      const auto equals = arg.find('=');
+      const auto flag =
+        arg.compare(0, 2, "--") == 0 ? flags.find(arg.substr(2, equals - 2)) : flags.end();
+      if (equals == std::string::npos || flag == flags.end()) {
+        throw std::invalid_argument("Unknown argument " + arg);
+      }
+      flag->second(arg.substr(equals + 1));
+    }
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  const auto input = makeReadings(readings);
+
+  std::printf(
+    "%-8s %6s %14s %14s %10s\n", "filter", "window", "before (ns)", "after (ns)", "speedup");
+  const bool matches = benchmarkWindows<5, 8, 16, 32, 64, 128, 256, 512, 1024>(input);
+  return matches ? 0 : 1;
+}
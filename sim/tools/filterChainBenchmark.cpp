@@ -0,0 +1,158 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/composableFilter.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include "okapi/api/filter/staticFilterChain.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace {
+using namespace okapi;
+
+/**
+ * Encoder-like readings: a slow ramp with noise and the odd spike, the same on every run.
+ */
+std::vector<double> makeReadings(const std::size_t icount) {
+  std::vector<double> readings(icount);
+  std::uint32_t state = 12345;
+  for (std::size_t i = 0; i < icount; i++) {
+    state = state * 1664525u + 1013904223u;
+    const double noise = (state >> 8) / static_cast<double>(1u << 24) - 0.5;
+    readings[i] = 0.01 * static_cast<double>(i) + noise + (i % 97 == 0 ? 50 : 0);
+  }
+  return readings;
+}
+
+/**
+ * Runs ifilter over ireadings.
+ *
+ * @param ooutputs Set to its outputs.
+ * @return The time it took per reading (ns).
+ */
+template <typename F>
+double run(F &ifilter, const std::vector<double> &ireadings, std::vector<double> &ooutputs) {
+  ooutputs.resize(ireadings.size());
+
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < ireadings.size(); i++) {
+    ooutputs[i] = ifilter.filter(ireadings[i]);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() / ireadings.size();
+}
+
+/**
+ * Times the same stages as a ComposableFilter, a StaticFilterChain, and a StaticFilterChain
+ * behind a Filter reference, and prints a row comparing them.
+ *
+ * @return Whether all three gave the same outputs.
+ */
+template <typename... Filters>
+bool compare(const char *iname,
+             const std::vector<double> &ireadings,
+             const std::tuple<Filters...> &istages) {
+  ComposableFilter composable = std::apply(
+    [](const auto &...istage) {
+      return ComposableFilter({std::make_shared<std::decay_t<decltype(istage)>>(istage)...});
+    },
+    istages);
+  auto chain = std::make_from_tuple<StaticFilterChain<Filters...>>(istages);
+  auto adapter = std::make_from_tuple<StaticFilterChainAdapter<Filters...>>(istages);
+  Filter &adapterFilter = adapter;
+
+  std::vector<double> composableOutputs;
+  std::vector<double> chainOutputs;
+  std::vector<double> adapterOutputs;
+  const double composableTime = run(composable, ireadings, composableOutputs);
+  const double chainTime = run(chain, ireadings, chainOutputs);
+  const double adapterTime = run(adapterFilter, ireadings, adapterOutputs);
+
+  // The stages do the same arithmetic in the same order, so the outputs match exactly
+  const bool matches = chainOutputs == composableOutputs && adapterOutputs == composableOutputs;
+
+  std::printf("%-24s %12.1f %12.1f %9.1fx %12.1f %9.1fx %s\n",
+              iname,
+              composableTime,
+              chainTime,
+              composableTime / chainTime,
+              adapterTime,
+              composableTime / adapterTime,
+              matches ? "" : "MISMATCH");
+  return matches;
+}
+} // namespace
+
+/**
+ * Times filter chains built as a ComposableFilter, which calls each stage through a shared_ptr
+ * and the vtable, against the same stages in a StaticFilterChain, both called directly and
+ * through a StaticFilterChainAdapter, and checks that all three give the same outputs. EmaFilter
+ * is compiled in its own source file, like it is in OkapiLib, so the chains using it show what
+ * is left when a stage can not be inlined.
+ *
+ *   make -C sim tools
+ *   sim/build/gpstest-chainbench --readings=1000000
+ *
+ * Exits with status 1 if any outputs differ.
+ */
+int main(int argc, char **argv) {
+  std::size_t readings = 1000000;
+
+  const std::map<std::string, std::function<void(const std::string &)>> flags{
+    {"readings", [&](const std::string &value) { readings = std::stoul(value); }}};
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      const std::string arg(argv[i]);
+      const auto equals = arg.find('=');
+      const auto flag =
+        arg.compare(0, 2, "--") == 0 ? flags.find(arg.substr(2, equals - 2)) : flags.end();
+      if (equals == std::string::npos || flag == flags.end()) {
+        throw std::invalid_argument("Unknown argument " + arg);
+      }
+      flag->second(arg.substr(equals + 1));
+    }
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  const auto input = makeReadings(readings);
+
+  std::printf("%-24s %12s %12s %10s %12s %10s\n",
+              "stages (ns per reading)",
+              "composable",
+              "static",
+              "speedup",
+              "adapter",
+              "speedup");
+
+  bool matches = true;
+  matches &= compare("average 2, 4, 8",
+                     input,
+                     std::make_tuple(AverageFilter<2>(), AverageFilter<4>(), AverageFilter<8>()));
+  matches &=
+    compare("median 5, average 8", input, std::make_tuple(MedianFilter<5>(), AverageFilter<8>()));
+  matches &= compare(
+    "4 header-only stages",
+    input,
+    std::make_tuple(MedianFilter<3>(), AverageFilter<4>(), MedianFilter<5>(), AverageFilter<2>()));
+  matches &= compare("ema, median 5, average 8",
+                     input,
+                     std::make_tuple(EmaFilter(0.2), MedianFilter<5>(), AverageFilter<8>()));
+  return matches ? 0 : 1;
+}
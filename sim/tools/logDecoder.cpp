@@ -0,0 +1,196 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/asyncLogSink.hpp"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+using okapi::AsyncLogSink;
+
+const char *levelName(const std::uint8_t ilevel) {
+  switch (ilevel) {
+  case 4:
+    return "DEBUG";
+  case 3:
+    return "INFO";
+  case 2:
+    return "WARN";
+  default:
+    return "ERROR";
+  }
+}
+
+/**
+ * Reads little endian values out of the log, remembering if it ran out.
+ */
+class Reader {
+  public:
+  explicit Reader(const std::vector<std::uint8_t> &idata) : data(idata) {
+  }
+
+  template <typename T> T get() {
+    T value{};
+    if (pos + sizeof(T) > data.size()) {
+      pos = data.size() + 1;
+      return value;
+    }
+    std::memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+  }
+
+  std::string getString(const std::size_t ilength) {
+    if (pos + ilength > data.size()) {
+      pos = data.size() + 1;
+      return {};
+    }
+    std::string value(reinterpret_cast<const char *>(data.data() + pos), ilength);
+    pos += ilength;
+    return value;
+  }
+
+  bool atEnd() const {
+    return pos >= data.size();
+  }
+
+  bool overran() const {
+    return pos > data.size();
+  }
+
+  private:
+  const std::vector<std::uint8_t> &data;
+  std::size_t pos{0};
+};
+} // namespace
+
+/**
+ * Turns the output of an AsyncLogSink in binary mode back into the text the sink would have
+ * written in text mode. Log to a file on the SD card, for example
+ * fopen("/usd/log.bin", "wb"), copy it off, then:
+ *
+ *   g++ -std=gnu++17 -O2 -DTHREADS_STD -Iinclude sim/tools/logDecoder.cpp \
+ *       src/okapi/api/util/logFormat.cpp -pthread -o gpstest-logdecode
+ *   ./gpstest-logdecode log.bin > log.txt
+ *
+ * Reads stdin if no file is given. A log cut off in the middle of a frame, such as one from a
+ * brain which lost power, is decoded up to the cut.
+ */
+int main(int argc, char **argv) {
+  std::FILE *in = argc > 1 ? std::fopen(argv[1], "rb") : stdin;
+  if (!in) {
+    std::fprintf(stderr, "Could not open %s\n", argv[1]);
+    return 1;
+  }
+
+  std::vector<std::uint8_t> data;
+  std::uint8_t buffer[4096];
+  for (std::size_t read; (read = std::fread(buffer, 1, sizeof(buffer), in)) > 0;) {
+    data.insert(data.end(), buffer, buffer + read);
+  }
+  if (in != stdin) {
+    std::fclose(in);
+  }
+
+  Reader reader(data);
+  const std::size_t magicLength = sizeof(AsyncLogSink::binaryMagic) - 1;
+  if (reader.getString(magicLength) != AsyncLogSink::binaryMagic ||
+      reader.get<std::uint8_t>() != AsyncLogSink::binaryVersion) {
+    std::fprintf(stderr, "Not a binary log, or from another version of AsyncLogSink\n");
+    return 1;
+  }
+
+  struct Format {
+    std::string signature;
+    std::string format;
+  };
+
+  std::map<std::uint16_t, Format> formats;
+  std::array<std::string, 256> tasks;
+  tasks[AsyncLogSink::unownedTask] = "no ring";
+  std::string message;
+
+  while (!reader.atEnd()) {
+    const auto frame = static_cast<AsyncLogSink::Frame>(reader.get<std::uint8_t>());
+    switch (frame) {
+    case AsyncLogSink::Frame::format: {
+      const auto id = reader.get<std::uint16_t>();
+      auto &format = formats[id];
+      format.signature = reader.getString(reader.get<std::uint8_t>());
+      format.format = reader.getString(reader.get<std::uint16_t>());
+      break;
+    }
+
+    case AsyncLogSink::Frame::task: {
+      const auto task = reader.get<std::uint8_t>();
+      tasks[task] = reader.getString(reader.get<std::uint8_t>());
+      break;
+    }
+
+    case AsyncLogSink::Frame::message: {
+      const auto task = reader.get<std::uint8_t>();
+      const auto time = reader.get<std::uint32_t>();
+      const auto level = reader.get<std::uint8_t>();
+      const auto id = reader.get<std::uint16_t>();
+      const auto payload = reader.getString(reader.get<std::uint16_t>());
+      if (reader.overran()) {
+        break;
+      }
+
+      if (id == 0) {
+        // A line the Logger formatted, timestamp and newline included
+        std::fwrite(payload.data(), 1, payload.size(), stdout);
+        break;
+      }
+
+      message.clear();
+      const auto format = formats.find(id);
+      if (format != formats.end()) {
+        okapi::LogFormat::format(format->second.format.c_str(),
+                                 format->second.signature.c_str(),
+                                 reinterpret_cast<const std::uint8_t *>(payload.data()),
+                                 payload.size(),
+                                 message);
+      } else {
+        message = "<unknown format " + std::to_string(id) + ">";
+      }
+
+      std::printf("%ld (%s) %s: %s\n",
+                  static_cast<long>(time / 1000),
+                  tasks[task].c_str(),
+                  levelName(level),
+                  message.c_str());
+      break;
+    }
+
+    case AsyncLogSink::Frame::dropped: {
+      const auto task = reader.get<std::uint8_t>();
+      const auto time = reader.get<std::uint32_t>();
+      const auto count = reader.get<std::uint32_t>();
+      if (!reader.overran()) {
+        std::printf("%ld (%s) WARN: AsyncLogSink: Dropped %lu messages\n",
+                    static_cast<long>(time / 1000),
+                    tasks[task].c_str(),
+                    static_cast<unsigned long>(count));
+      }
+      break;
+    }
+
+    default:
+      std::fprintf(stderr, "Unknown frame %d, stopping\n", static_cast<int>(frame));
+      return 1;
+    }
+  }
+
+  if (reader.overran()) {
+    std::fprintf(stderr, "The log ends in the middle of a frame\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "sim/monteCarlo.hpp"
+#include <chrono>
+#include <functional>
+#include <map>
+#include <stdexcept>
+
+/**
+ * Command line front end for sim::MonteCarloRunner. Build the simulator first (see
+ * sim/include/sim/simulator.hpp), then:
+ *
+ *   g++ -std=gnu++17 -O2 -Isim/include sim/tools/monteCarlo.cpp sim/src/monteCarlo.cpp \
+ *       sim/src/process.cpp -pthread -o gpstest-montecarlo
+ *   ./gpstest-montecarlo --sim=./gpstest-sim --trials=2000 --mode=opcontrol -- --echo-screen=0
+ *
+ * Arguments after `--` are passed to every trial.
+ */
+int main(int argc, char **argv) {
+  sim::MonteCarloRunner::Options options;
+
+  const std::map<std::string, std::function<void(const std::string &)>> flags{
+    {"sim", [&](const std::string &value) { options.simulator = value; }},
+    {"trials", [&](const std::string &value) { options.trials = std::stoul(value); }},
+    {"jobs", [&](const std::string &value) { options.jobs = std::stoul(value); }},
+    {"seed", [&](const std::string &value) { options.seed = std::stoul(value); }},
+    {"mode", [&](const std::string &value) { options.mode = value; }},
+    {"duration", [&](const std::string &value) { options.duration = std::stoul(value); }},
+    {"start-x", [&](const std::string &value) { options.startX = std::stod(value); }},
+    {"start-y", [&](const std::string &value) { options.startY = std::stod(value); }},
+    {"start-heading", [&](const std::string &value) { options.startHeading = std::stod(value); }},
+    {"target-x", [&](const std::string &value) { options.targetX = std::stod(value); }},
+    {"target-y", [&](const std::string &value) { options.targetY = std::stod(value); }},
+    {"target-heading",
+     [&](const std::string &value) { options.targetHeading = std::stod(value); }},
+    {"position-tolerance",
+     [&](const std::string &value) { options.positionTolerance = std::stod(value); }},
+    {"heading-tolerance",
+     [&](const std::string &value) { options.headingTolerance = std::stod(value); }}};
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      const std::string arg(argv[i]);
+      if (arg == "--") {
+        options.extraArgs.assign(argv + i + 1, argv + argc);
+        break;
+      }
+
+      const auto equals = arg.find('=');
+      const auto flag =
+        arg.compare(0, 2, "--") == 0 ? flags.find(arg.substr(2, equals - 2)) : flags.end();
+      if (equals == std::string::npos || flag == flags.end()) {
+        throw std::invalid_argument("Unknown argument " + arg);
+      }
+      flag->second(arg.substr(equals + 1));
+    }
+
+    const sim::MonteCarloRunner runner(options);
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = runner.run();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    runner.printReport(results, stdout);
+    std::printf("\nElapsed: %.1f s\n", elapsed.count());
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,219 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncEventWrapper.hpp"
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+using namespace okapi;
+using Clock = std::chrono::steady_clock;
+
+class StdTimer : public AbstractTimer {
+  public:
+  StdTimer() : AbstractTimer(now()) {
+  }
+
+  QTime millis() const override {
+    return now();
+  }
+
+  static QTime now() {
+    return std::chrono::duration<double, std::milli>(Clock::now().time_since_epoch()).count() *
+           millisecond;
+  }
+};
+
+class StdRate : public AbstractRate {
+  public:
+  void delay(const QFrequency ihz) override {
+    delayUntil(1 / ihz);
+  }
+
+  void delayUntil(const QTime itime) override {
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double, std::milli>(itime.convert(millisecond)));
+    lastTime = std::max(lastTime + period, Clock::now() - period);
+    std::this_thread::sleep_until(lastTime);
+  }
+
+  void delayUntil(const uint32_t ims) override {
+    delayUntil(ims * millisecond);
+  }
+
+  protected:
+  Clock::time_point lastTime{Clock::now()};
+};
+
+TimeUtil stdTimeUtil() {
+  return TimeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<StdTimer>(); }),
+    Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<StdRate>(); }),
+    Supplier<std::unique_ptr<SettledUtil>>(
+      []() { return std::make_unique<SettledUtil>(std::make_unique<StdTimer>()); }));
+}
+
+/**
+ * A mechanism whose position moves at a speed proportional to the controller output.
+ */
+class Plant : public ControllerInput<double>, public ControllerOutput<double> {
+  public:
+  double controllerGet() override {
+    return position;
+  }
+
+  void controllerSet(const double ivalue) override {
+    position += ivalue * 10;
+  }
+
+  double position{0};
+};
+
+/**
+ * A PID controller which is settled from the step whose reading is within tolerance of the target,
+ * and records when that step ran and how often the waiting task checked.
+ */
+class TimedPID : public IterativePosPIDController {
+  public:
+  TimedPID() : IterativePosPIDController({0.01, 0, 0, 0}, stdTimeUtil()) {
+  }
+
+  double step(const double inewReading) override {
+    const double out = IterativePosPIDController::step(inewReading);
+    const bool atTarget = std::abs(getTarget() - inewReading) <= tolerance;
+    if (atTarget && !settled.load(std::memory_order_relaxed)) {
+      settledAt.store(Clock::now(), std::memory_order_relaxed);
+      settled.store(true, std::memory_order_release);
+    }
+    return out;
+  }
+
+  bool isSettled() override {
+    if (std::this_thread::get_id() == waiter) {
+      waiterChecks++;
+    }
+    return settled.load(std::memory_order_acquire);
+  }
+
+  static constexpr double tolerance = 1;
+
+  std::atomic_bool settled{false};
+  std::atomic<Clock::time_point> settledAt{};
+  std::thread::id waiter{std::this_thread::get_id()};
+  std::size_t waiterChecks{0};
+};
+
+struct Stats {
+  double totalLatency{0}; // ms
+  double maxLatency{0};   // ms
+  double totalChecks{0};
+  double totalCpu{0}; // us
+};
+
+std::uint64_t threadCpuTime() {
+  timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return time.tv_sec * 1000000000ull + time.tv_nsec;
+}
+
+/**
+ * Moves the plant to itarget and times the return of waitUntilSettled().
+ */
+template <typename Wrapper> void runTrial(const double itarget, Stats &ostats) {
+  auto plant = std::make_shared<Plant>();
+  auto pid = std::make_shared<TimedPID>();
+  Wrapper wrapper(plant, plant, pid, stdTimeUtil().getRateSupplier());
+  wrapper.setTarget(itarget);
+  wrapper.startThread();
+
+  const std::uint64_t cpuStart = threadCpuTime();
+  wrapper.waitUntilSettled();
+  const auto returnedAt = Clock::now();
+  const std::uint64_t cpu = threadCpuTime() - cpuStart;
+
+  const double latency =
+    std::chrono::duration<double, std::milli>(returnedAt - pid->settledAt.load()).count();
+  ostats.totalLatency += latency;
+  ostats.maxLatency = std::max(ostats.maxLatency, latency);
+  ostats.totalChecks += pid->waiterChecks;
+  ostats.totalCpu += cpu / 1e3;
+}
+
+void printRow(const char *iname, const Stats &istats, const std::size_t itrials) {
+  std::printf("%-28s %10.3f %10.3f %16.1f %16.1f\n",
+              iname,
+              istats.totalLatency / itrials,
+              istats.maxLatency,
+              istats.totalChecks / itrials,
+              istats.totalCpu / itrials);
+}
+} // namespace
+
+/**
+ * Compares how quickly and how cheaply a task waiting in waitUntilSettled() learns that the
+ * controller settled, between AsyncWrapper, which polls isSettled() every 10 ms, and
+ * AsyncEventWrapper, which the controller task wakes on the step it settles. Each trial moves a
+ * simulated mechanism with a PID controller on real host threads and measures, from that step:
+ *
+ *   latency: how long until waitUntilSettled() returns (ms)
+ *   checks: how many times the waiting task checked isSettled()
+ *   CPU: the waiting task's CPU time for the whole wait (us)
+ *
+ *   make -C sim tools
+ *   sim/build/gpstest-settlewait --trials=20
+ */
+int main(int argc, char **argv) {
+  std::size_t trials = 20;
+
+  const std::map<std::string, std::function<void(const std::string &)>> flags{
+    {"trials", [&](const std::string &value) { trials = std::stoul(value); }}};
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      const std::string arg(argv[i]);
+      const auto equals = arg.find('=');
+      const auto flag =
+        arg.compare(0, 2, "--") == 0 ? flags.find(arg.substr(2, equals - 2)) : flags.end();
+      if (equals == std::string::npos || flag == flags.end()) {
+        throw std::invalid_argument("Unknown argument " + arg);
+      }
+      flag->second(arg.substr(equals + 1));
+    }
+
+    if (trials == 0) {
+      throw std::invalid_argument("--trials must be at least 1");
+    }
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  Stats polling;
+  Stats event;
+  for (std::size_t i = 0; i < trials; i++) {
+    // Both wrappers make the same moves
+    const double target = 100 + 10 * static_cast<double>(i);
+    runTrial<AsyncWrapper<double, double>>(target, polling);
+    runTrial<AsyncEventWrapper<double, double>>(target, event);
+  }
+
+  std::printf("%-28s %10s %10s %16s %16s\n",
+              "waitUntilSettled",
+              "mean (ms)",
+              "max (ms)",
+              "checks per wait",
+              "CPU per wait (us)");
+  printRow("polling (AsyncWrapper)", polling, trials);
+  printRow("event (AsyncEventWrapper)", event, trials);
+  return 0;
+}
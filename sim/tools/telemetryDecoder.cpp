@@ -0,0 +1,218 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/cobs.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+template <typename T> T get(const std::vector<std::uint8_t> &ipacket, const std::size_t ipos) {
+  T value;
+  std::memcpy(&value, ipacket.data() + ipos, sizeof(T));
+  return value;
+}
+
+/**
+ * Splits a byte stream on zero bytes.
+ */
+class FrameSplitter {
+  public:
+  template <typename F>
+  void push(const std::uint8_t *idata, const std::size_t isize, F &&ionFrame) {
+    for (std::size_t i = 0; i < isize; i++) {
+      if (idata[i] != 0) {
+        frame.push_back(idata[i]);
+      } else {
+        ionFrame(frame);
+        frame.clear();
+      }
+    }
+  }
+
+  private:
+  std::vector<std::uint8_t> frame;
+};
+
+class CsvWriter {
+  public:
+  explicit CsvWriter(std::FILE *iout) : out(iout) {
+  }
+
+  void addSignal(const std::uint8_t iid, const std::string &iname) {
+    if (columns.empty() || names.count(iid)) {
+      names[iid] = iname;
+    } else if (!warned) {
+      std::fprintf(stderr, "Signal %s was added after the first sample; it is left out\n",
+                   iname.c_str());
+      warned = true;
+    }
+  }
+
+  void sample(const double itime, const std::map<std::uint8_t, float> &ivalues) {
+    if (names.empty()) {
+      return; // Not decodable until the list of signals comes around again
+    }
+
+    if (columns.empty()) {
+      std::fprintf(out, "time");
+      for (const auto &name : names) {
+        columns.push_back(name.first);
+        std::fprintf(out, ",%s", name.second.c_str());
+      }
+      std::fprintf(out, "\n");
+    }
+
+    std::fprintf(out, "%.6f", itime);
+    for (const auto id : columns) {
+      const auto value = ivalues.find(id);
+      if (value != ivalues.end()) {
+        std::fprintf(out, ",%.7g", value->second);
+      } else {
+        std::fprintf(out, ",");
+      }
+    }
+    std::fprintf(out, "\n");
+    std::fflush(out);
+  }
+
+  private:
+  std::FILE *out;
+  std::map<std::uint8_t, std::string> names;
+  std::vector<std::uint8_t> columns;
+  bool warned{false};
+};
+} // namespace
+
+/**
+ * Decodes the stream written by okapi::Telemetry into CSV with a time column (seconds) and one
+ * column per signal. A signal which is decimated is blank in the rows it was not sent in.
+ *
+ *   g++ -std=gnu++17 -O2 -Iinclude sim/tools/telemetryDecoder.cpp src/okapi/api/util/cobs.cpp \
+ *       -o gpstest-telemetry
+ *   ./gpstest-telemetry /dev/ttyACM1 --out=run.csv
+ *
+ * Reads a file, a serial device (put in raw mode), or stdin if none is given, until it ends.
+ * Over the brain's USB port, only what was written to --stream (serr, unless given) is decoded;
+ * the other stream, where stdout's text goes, is skipped. Frames which fail their CRC, such as
+ * text printed on the same stream, are skipped and counted.
+ */
+int main(int argc, char **argv) {
+  std::string inPath;
+  std::string outPath;
+  std::string stream = "serr";
+  for (int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    if (arg.compare(0, 6, "--out=") == 0) {
+      outPath = arg.substr(6);
+    } else if (arg.compare(0, 9, "--stream=") == 0) {
+      stream = arg.substr(9);
+    } else {
+      inPath = arg;
+    }
+  }
+
+  if (stream.size() != 4) {
+    std::fprintf(stderr, "The stream must be a PROS stream name such as serr or sout\n");
+    return 1;
+  }
+
+  const int in = inPath.empty() ? STDIN_FILENO : open(inPath.c_str(), O_RDONLY | O_NOCTTY);
+  if (in < 0) {
+    std::fprintf(stderr, "Could not open %s: %s\n", inPath.c_str(), std::strerror(errno));
+    return 1;
+  }
+
+  termios settings;
+  if (tcgetattr(in, &settings) == 0) {
+    cfmakeraw(&settings);
+    tcsetattr(in, TCSANOW, &settings);
+  }
+
+  std::FILE *out = outPath.empty() ? stdout : std::fopen(outPath.c_str(), "w");
+  if (!out) {
+    std::fprintf(stderr, "Could not open %s\n", outPath.c_str());
+    return 1;
+  }
+
+  CsvWriter csv(out);
+  std::map<std::uint8_t, float> values;
+  std::size_t good = 0;
+  std::size_t bad = 0;
+
+  const auto handlePacket = [&](const std::vector<std::uint8_t> &ipacket) {
+    if (ipacket[0] == 'N' && ipacket.size() >= 5 && ipacket.size() == 5u + ipacket[4]) {
+      csv.addSignal(ipacket[1], std::string(ipacket.begin() + 5, ipacket.end()));
+    } else if (ipacket[0] == 'S' && ipacket.size() >= 6 &&
+               ipacket.size() == 6u + ipacket[5] * 5u) {
+      values.clear();
+      for (std::size_t entry = 6; entry < ipacket.size(); entry += 5) {
+        values[ipacket[entry]] = get<float>(ipacket, entry + 1);
+      }
+      csv.sample(get<std::uint32_t>(ipacket, 1) / 1e6, values);
+    } else {
+      return false;
+    }
+    return true;
+  };
+
+  // Over USB each write is wrapped in a frame of PROS's own, starting with the stream name, so
+  // frames which are not telemetry are unwrapped and, if they are from the stream, split again
+  FrameSplitter inner;
+  FrameSplitter outer;
+  std::vector<std::uint8_t> packet;
+  std::function<void(const std::vector<std::uint8_t> &, bool)> handleFrame;
+  handleFrame = [&](const std::vector<std::uint8_t> &iframe, const bool iunwrap) {
+    if (iframe.empty()) {
+      return;
+    }
+
+    if (!okapi::cobs::decode(iframe.data(), iframe.size(), packet)) {
+      bad++;
+      return;
+    }
+
+    if (packet.size() > 2 && okapi::cobs::crc16(packet.data(), packet.size() - 2) ==
+                               get<std::uint16_t>(packet, packet.size() - 2)) {
+      packet.resize(packet.size() - 2);
+      handlePacket(packet) ? good++ : bad++;
+    } else if (iunwrap && packet.size() >= 4 && std::memcmp(packet.data(), stream.data(), 4) == 0) {
+      const std::vector<std::uint8_t> wrapped(packet.begin() + 4, packet.end());
+      inner.push(wrapped.data(), wrapped.size(), [&](const std::vector<std::uint8_t> &iinner) {
+        handleFrame(iinner, false);
+      });
+    } else {
+      bad++;
+    }
+  };
+
+  std::uint8_t buffer[4096];
+  while (true) {
+    const ssize_t count = read(in, buffer, sizeof(buffer));
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      break;
+    }
+
+    outer.push(buffer,
+               static_cast<std::size_t>(count),
+               [&](const std::vector<std::uint8_t> &iframe) { handleFrame(iframe, true); });
+  }
+
+  if (out != stdout) {
+    std::fclose(out);
+  }
+  std::fprintf(stderr, "%zu packets decoded, %zu frames skipped\n", good, bad);
+  return 0;
+}
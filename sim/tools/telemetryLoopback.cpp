@@ -0,0 +1,284 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/cobs.hpp"
+#include "okapi/api/util/telemetry.hpp"
+#include "sim/process.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <map>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+using namespace okapi;
+
+int failures = 0;
+
+void check(const bool icondition, const std::string &idescription) {
+  if (!icondition) {
+    std::printf("FAIL: %s\n", idescription.c_str());
+    failures++;
+  }
+}
+
+/**
+ * The time the Telemetry sees, moved on by hand so every run sends the same packets.
+ */
+double now = 0; // ms
+
+class ManualTimer : public AbstractTimer {
+  public:
+  ManualTimer() : AbstractTimer(now * millisecond) {
+  }
+
+  QTime millis() const override {
+    return now * millisecond;
+  }
+};
+
+class NoRate : public AbstractRate {
+  public:
+  void delay(QFrequency) override {
+  }
+
+  void delayUntil(QTime) override {
+  }
+
+  void delayUntil(uint32_t) override {
+  }
+};
+
+TimeUtil manualTimeUtil() {
+  return TimeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<ManualTimer>(); }),
+    Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<NoRate>(); }),
+    Supplier<std::unique_ptr<SettledUtil>>([]() { return nullptr; }));
+}
+
+/**
+ * Writes all of isize bytes, waiting for the reader to make room for at most 5 s.
+ */
+void writeAll(const int ifd, const std::uint8_t *idata, std::size_t isize) {
+  while (isize > 0) {
+    const ssize_t count = write(ifd, idata, isize);
+    if (count > 0) {
+      idata += count;
+      isize -= static_cast<std::size_t>(count);
+    } else if (count < 0 && errno == EAGAIN) {
+      pollfd writable{ifd, POLLOUT, 0};
+      if (poll(&writable, 1, 5000) == 0) {
+        throw std::runtime_error("The decoder stopped reading");
+      }
+    } else if (count < 0 && errno != EINTR) {
+      throw std::runtime_error(std::string("Could not write to the pty: ") + std::strerror(errno));
+    }
+  }
+}
+
+/**
+ * Writes to the pty the way PROS writes a stream to the brain's USB port: each write becomes a
+ * COBS frame holding the stream's name followed by the bytes written.
+ */
+class ProsStream {
+  public:
+  ProsStream(const int ifd, const char *iname) : fd(ifd), name(iname) {
+  }
+
+  void write(const std::uint8_t *idata, const std::size_t isize) {
+    std::vector<std::uint8_t> wrapped(name.begin(), name.end());
+    wrapped.insert(wrapped.end(), idata, idata + isize);
+
+    std::vector<std::uint8_t> frame(cobs::maxEncodedSize(wrapped.size()) + 1);
+    const std::size_t size = cobs::encode(wrapped.data(), wrapped.size(), frame.data());
+    frame[size] = 0;
+    writeAll(fd, frame.data(), size + 1);
+  }
+
+  void print(const std::string &itext) {
+    write(reinterpret_cast<const std::uint8_t *>(itext.data()), itext.size());
+  }
+
+  protected:
+  int fd;
+  std::string name;
+};
+
+class ProsStreamOutput : public TelemetryOutput {
+  public:
+  explicit ProsStreamOutput(ProsStream &istream) : stream(istream) {
+  }
+
+  void write(const std::uint8_t *idata, const std::size_t isize) override {
+    stream.write(idata, isize);
+  }
+
+  protected:
+  ProsStream &stream;
+};
+
+std::vector<std::vector<std::string>> parseCsv(const std::string &itext) {
+  std::vector<std::vector<std::string>> rows;
+  std::istringstream lines(itext);
+  for (std::string line; std::getline(lines, line);) {
+    std::vector<std::string> row;
+    std::istringstream cells(line);
+    for (std::string cell; std::getline(cells, cell, ',');) {
+      row.push_back(cell);
+    }
+    // getline drops an empty last cell
+    if (!line.empty() && line.back() == ',') {
+      row.emplace_back();
+    }
+    rows.push_back(row);
+  }
+  return rows;
+}
+
+std::string format(const char *iformat, const double ivalue) {
+  char out[32];
+  std::snprintf(out, sizeof(out), iformat, ivalue);
+  return out;
+}
+} // namespace
+
+/**
+ * Sends telemetry through a pty to gpstest-telemetry, standing in for the brain on the other end
+ * of its USB port, and checks the CSV it writes. The Telemetry writes to serr, framed the way
+ * PROS frames it, while text like goToTiming's report is printed to sout and an error message to
+ * serr in between. Every sample must come out, and nothing else.
+ *
+ *   make -C sim test
+ *
+ * or, after `make -C sim tools`:
+ *
+ *   sim/build/gpstest-telemetry-loopback --decoder=sim/build/gpstest-telemetry
+ */
+int main(int argc, char **argv) {
+  std::string decoder = "./gpstest-telemetry";
+  std::size_t ticks = 300;
+
+  const std::map<std::string, std::function<void(const std::string &)>> flags{
+    {"decoder", [&](const std::string &value) { decoder = value; }},
+    {"ticks", [&](const std::string &value) { ticks = std::stoul(value); }}};
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      const std::string arg(argv[i]);
+      const auto equals = arg.find('=');
+      const auto flag =
+        arg.compare(0, 2, "--") == 0 ? flags.find(arg.substr(2, equals - 2)) : flags.end();
+      if (equals == std::string::npos || flag == flags.end()) {
+        throw std::invalid_argument("Unknown argument " + arg);
+      }
+      flag->second(arg.substr(equals + 1));
+    }
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  const int master = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    std::fprintf(stderr, "Could not open a pty: %s\n", std::strerror(errno));
+    return 1;
+  }
+  const std::string device = ptsname(master);
+  // The decoder only sees the hang up if it has no copy of the master
+  fcntl(master, F_SETFD, FD_CLOEXEC);
+
+  // The decoder gets the device as its stdin, so it is open on the decoder's side before anything
+  // is written, and is put in raw mode first so the line discipline changes none of it
+  const int deviceFd = open(device.c_str(), O_RDONLY | O_NOCTTY | O_CLOEXEC);
+  termios settings;
+  if (deviceFd < 0 || tcgetattr(deviceFd, &settings) != 0) {
+    std::fprintf(stderr, "Could not open %s: %s\n", device.c_str(), std::strerror(errno));
+    return 1;
+  }
+  cfmakeraw(&settings);
+  tcsetattr(deviceFd, TCSANOW, &settings);
+
+  std::string csv;
+  bool decoded = false;
+  std::thread decoderThread([&]() { decoded = sim::runProcess({decoder}, csv, deviceFd); });
+
+  ProsStream sout(master, "sout");
+  ProsStream serr(master, "serr");
+  Telemetry::Stats stats;
+  try {
+    Telemetry telemetry(manualTimeUtil(), std::make_unique<ProsStreamOutput>(serr));
+    const auto x = telemetry.addSignal("x");
+    const auto voltage = telemetry.addSignal("voltage", 5);
+
+    for (std::size_t i = 0; i < ticks; i++) {
+      now = 10 * static_cast<double>(i);
+      telemetry.set(x, static_cast<double>(i));
+      telemetry.set(voltage, 2 * static_cast<double>(i));
+      telemetry.tick();
+
+      if (i % 50 == 25) {
+        sout.print("goTo: 50 loops, period mean 20.01 ms\n");
+      }
+      if (i == 100) {
+        serr.print("Error: a message PROS printed to stderr\n");
+      }
+    }
+    stats = telemetry.getStats();
+
+    // Hanging up drops whatever the decoder has not read yet. What is written reaches the queue
+    // FIONREAD sees a little later, so wait until it has stayed empty for 200 ms.
+    int empty = 0;
+    for (int waited = 0; empty < 20 && waited < 5000; waited += 10) {
+      int queued = 0;
+      ioctl(deviceFd, FIONREAD, &queued);
+      empty = queued == 0 ? empty + 1 : 0;
+      usleep(10000);
+    }
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    failures++;
+  }
+  // The decoder reads until it is hung up on
+  close(master);
+  decoderThread.join();
+  close(deviceFd);
+
+  check(decoded, decoder + " runs on " + device);
+  check(stats.packetsDropped == 0, "no samples are dropped for the budget");
+
+  const auto rows = parseCsv(csv);
+  check(rows.size() == ticks + 1, "one row per sample after the header, got " +
+                                    std::to_string(rows.size()) + " lines:\n" + csv);
+  if (!rows.empty()) {
+    check(rows[0] == std::vector<std::string>{"time", "x", "voltage"},
+          "the header names the signals");
+  }
+  for (std::size_t i = 0; i + 1 < rows.size() && i < ticks; i++) {
+    const std::vector<std::string> expected{
+      format("%.6f", static_cast<double>(i) / 100),
+      format("%.7g", static_cast<double>(i)),
+      i % 5 == 0 ? format("%.7g", 2 * static_cast<double>(i)) : ""};
+    if (rows[i + 1] != expected) {
+      check(false, "sample " + std::to_string(i) + " comes out as sent");
+      break;
+    }
+  }
+
+  if (failures == 0) {
+    std::printf("telemetryLoopback: passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
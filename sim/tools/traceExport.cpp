@@ -0,0 +1,239 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/tracer.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+using okapi::Tracer;
+
+/**
+ * Reads little endian values out of the trace, remembering if it ran out.
+ */
+class Reader {
+  public:
+  explicit Reader(const std::vector<std::uint8_t> &idata) : data(idata) {
+  }
+
+  template <typename T> T get() {
+    T value{};
+    if (pos + sizeof(T) > data.size()) {
+      pos = data.size() + 1;
+      return value;
+    }
+    std::memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+  }
+
+  std::string getString(const std::size_t ilength) {
+    if (pos + ilength > data.size()) {
+      pos = data.size() + 1;
+      return {};
+    }
+    std::string value(reinterpret_cast<const char *>(data.data() + pos), ilength);
+    pos += ilength;
+    return value;
+  }
+
+  bool atEnd() const {
+    return pos >= data.size();
+  }
+
+  bool overran() const {
+    return pos > data.size();
+  }
+
+  private:
+  const std::vector<std::uint8_t> &data;
+  std::size_t pos{0};
+};
+
+std::string jsonString(const std::string &itext) {
+  std::string out = "\"";
+  for (const char c : itext) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  return out + "\"";
+}
+
+/**
+ * @return itime with the wraps of the 32 bit clock up to ilast, a task's previous event, added
+ * back.
+ */
+std::uint64_t unwrap(const std::uint64_t ilast, const std::uint32_t itime) {
+  const std::uint64_t out = (ilast & ~0xffffffffull) | itime;
+  return out < ilast ? out + (1ull << 32) : out;
+}
+} // namespace
+
+/**
+ * Turns the output of a Tracer in binary mode into Chrome trace-event JSON, which loads into
+ * chrome://tracing or https://ui.perfetto.dev with one track per task. Trace to a file on the SD
+ * card, for example fopen("/usd/trace.bin", "wb"), copy it off, then:
+ *
+ *   g++ -std=gnu++17 -O2 -DTHREADS_STD -Iinclude sim/tools/traceExport.cpp -o gpstest-trace
+ *   ./gpstest-trace trace.bin > trace.json
+ *
+ * Reads stdin if no file is given. A trace cut off in the middle of a frame, such as one from a
+ * brain which lost power, is converted up to the cut. Spans still open at the end are closed at
+ * the last event so they show up.
+ */
+int main(int argc, char **argv) {
+  std::FILE *in = argc > 1 ? std::fopen(argv[1], "rb") : stdin;
+  if (!in) {
+    std::fprintf(stderr, "Could not open %s\n", argv[1]);
+    return 1;
+  }
+
+  std::vector<std::uint8_t> data;
+  std::uint8_t buffer[4096];
+  for (std::size_t read; (read = std::fread(buffer, 1, sizeof(buffer), in)) > 0;) {
+    data.insert(data.end(), buffer, buffer + read);
+  }
+  if (in != stdin) {
+    std::fclose(in);
+  }
+
+  Reader reader(data);
+  const std::size_t magicLength = sizeof(Tracer::binaryMagic) - 1;
+  if (reader.getString(magicLength) != Tracer::binaryMagic ||
+      reader.get<std::uint8_t>() != Tracer::binaryVersion) {
+    std::fprintf(stderr, "Not a binary trace, or from another version of Tracer\n");
+    return 1;
+  }
+
+  struct Task {
+    std::string name;
+    std::uint64_t lastTime{0};
+    std::vector<std::string> open; // Names of the spans begun and not yet ended
+  };
+
+  std::map<std::uint16_t, std::string> names;
+  std::array<Task, 256> tasks;
+  std::uint64_t lastTime = 0;
+  std::size_t events = 0;
+  std::size_t dropped = 0;
+
+  std::printf("[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+              "\"args\":{\"name\":\"V5 Brain\"}}");
+
+  while (!reader.atEnd()) {
+    const auto frame = static_cast<Tracer::Frame>(reader.get<std::uint8_t>());
+    switch (frame) {
+    case Tracer::Frame::name: {
+      const auto id = reader.get<std::uint16_t>();
+      names[id] = reader.getString(reader.get<std::uint8_t>());
+      break;
+    }
+
+    case Tracer::Frame::task: {
+      const auto id = reader.get<std::uint8_t>();
+      tasks[id].name = reader.getString(reader.get<std::uint8_t>());
+      if (!reader.overran()) {
+        std::printf(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                    "\"args\":{\"name\":%s}}",
+                    id + 1u,
+                    jsonString(tasks[id].name).c_str());
+      }
+      break;
+    }
+
+    case Tracer::Frame::event: {
+      const auto id = reader.get<std::uint8_t>();
+      const auto time = reader.get<std::uint32_t>();
+      const auto phase = reader.get<char>();
+      const auto nameId = reader.get<std::uint16_t>();
+      if (reader.overran()) {
+        break;
+      }
+
+      auto &task = tasks[id];
+      task.lastTime = unwrap(task.lastTime, time);
+      lastTime = std::max(lastTime, task.lastTime);
+      const auto name = names.find(nameId);
+      const std::string text =
+        name != names.end() ? name->second : "<unknown name " + std::to_string(nameId) + ">";
+
+      if (phase == static_cast<char>(Tracer::Phase::begin)) {
+        task.open.push_back(text);
+      } else if (phase == static_cast<char>(Tracer::Phase::end) && !task.open.empty()) {
+        task.open.pop_back();
+      }
+
+      std::printf(",\n{\"name\":%s,\"ph\":\"%c\",%s\"ts\":%llu,\"pid\":1,\"tid\":%u}",
+                  jsonString(text).c_str(),
+                  phase,
+                  phase == static_cast<char>(Tracer::Phase::instant) ? "\"s\":\"t\"," : "",
+                  static_cast<unsigned long long>(task.lastTime),
+                  id + 1u);
+      events++;
+      break;
+    }
+
+    case Tracer::Frame::dropped: {
+      const auto id = reader.get<std::uint8_t>();
+      const auto time = reader.get<std::uint32_t>();
+      const auto count = reader.get<std::uint32_t>();
+      if (reader.overran()) {
+        break;
+      }
+
+      const bool owned = id != Tracer::unownedTask;
+      std::uint64_t ts = time;
+      if (owned) {
+        tasks[id].lastTime = unwrap(tasks[id].lastTime, time);
+        ts = tasks[id].lastTime;
+      }
+      std::printf(",\n{\"name\":\"Dropped %lu events\",\"ph\":\"i\",\"s\":\"%c\",\"ts\":%llu,"
+                  "\"pid\":1,\"tid\":%u}",
+                  static_cast<unsigned long>(count),
+                  owned ? 't' : 'p',
+                  static_cast<unsigned long long>(ts),
+                  owned ? id + 1u : 0u);
+      dropped += count;
+      break;
+    }
+
+    default:
+      std::fprintf(stderr, "Unknown frame %d, stopping\n", static_cast<int>(frame));
+      std::printf("\n]\n");
+      return 1;
+    }
+  }
+
+  for (std::size_t id = 0; id < tasks.size(); id++) {
+    auto &task = tasks[id];
+    while (!task.open.empty()) {
+      std::printf(",\n{\"name\":%s,\"ph\":\"E\",\"ts\":%llu,\"pid\":1,\"tid\":%u}",
+                  jsonString(task.open.back()).c_str(),
+                  static_cast<unsigned long long>(lastTime),
+                  static_cast<unsigned>(id + 1));
+      task.open.pop_back();
+    }
+  }
+  std::printf("\n]\n");
+
+  if (reader.overran()) {
+    std::fprintf(stderr, "The trace ends in the middle of a frame\n");
+  }
+  std::fprintf(stderr, "%zu events, %zu dropped\n", events, dropped);
+  return 0;
+}
@@ -15,6 +15,28 @@ auto xdrive = std::dynamic_pointer_cast<okapi::XDriveModel>(chassis->getModel())
 pros::Gps gpsPrimary(9, 0.0, 0.0254 * 4.0);
 // pros::Gps gpsSecondary(10, 0.0, 0.0, 180.0, 0.0, 0.0254 * 2.0);
 
+// Streams goTo()'s state over USB; decode it on a laptop with sim/tools/telemetryDecoder.cpp. It
+// has stderr to itself, so the text printed to stdout does not get in its way. PROS wraps each
+// write to stderr in a frame naming the stream, which the decoder unwraps. Set up in initialize(),
+// since /ser/serr is only ready to open once PROS is running.
+std::shared_ptr<okapi::Telemetry> telemetry;
+std::uint8_t xSignal, ySignal, yawSignal;
+std::uint8_t xPowSignal, yPowSignal, yawPowSignal;
+std::uint8_t distanceErrorSignal, angleErrorSignal, settledSignal;
+// Motor voltages change slowly enough to read every 5th time around goTo()'s loop, every 100 ms,
+// and telemetry samples every 10 ms, so they are sent every 10th sample
+constexpr int voltageDecimation = 5;
+std::uint8_t topLeftSignal, topRightSignal, bottomRightSignal, bottomLeftSignal;
+
+// Shows goTo()'s state on the brain screen; its own task redraws only the lines that changed
+auto dashboard = std::make_shared<okapi::Dashboard>(okapi::TimeUtilFactory::createDefault());
+const std::size_t xField = dashboard->addField("X Position"), yField = dashboard->addField("Y Position"), yawField = dashboard->addField("Yaw");
+const std::size_t distanceErrorField = dashboard->addField("Distance error"), angleErrorField = dashboard->addField("Angle error");
+okapi::SeqLock<okapi::PoseSettledUtil::Status> settleStatus;
+
+// How late goTo()'s loop runs; printed to the terminal after each move
+auto goToTiming = std::make_shared<okapi::LoopTiming>(std::make_unique<okapi::MicroTimer>(), "goTo");
+
 /**
  * A callback function for LLEMU's center button.
  *
@@ -28,7 +50,35 @@ pros::Gps gpsPrimary(9, 0.0, 0.0254 * 4.0);
  * All other competition modes are blocked by initialize; it is recommended
  * to keep execution time for this mode under a few seconds.
  */
-void initialize() {}
+void initialize()
+{
+	telemetry = std::make_shared<okapi::Telemetry>(okapi::TimeUtilFactory::createDefault(), std::make_unique<okapi::FileTelemetryOutput>(fopen("/ser/serr", "wb")));
+	xSignal = telemetry->addSignal("x");
+	ySignal = telemetry->addSignal("y");
+	yawSignal = telemetry->addSignal("yaw");
+	xPowSignal = telemetry->addSignal("xPow");
+	yPowSignal = telemetry->addSignal("yPow");
+	yawPowSignal = telemetry->addSignal("yawPow");
+	distanceErrorSignal = telemetry->addSignal("distanceError");
+	angleErrorSignal = telemetry->addSignal("angleError");
+	settledSignal = telemetry->addSignal("settled");
+	topLeftSignal = telemetry->addSignal("topLeftVoltage", 10);
+	topRightSignal = telemetry->addSignal("topRightVoltage", 10);
+	bottomRightSignal = telemetry->addSignal("bottomRightVoltage", 10);
+	bottomLeftSignal = telemetry->addSignal("bottomLeftVoltage", 10);
+	telemetry->startThread();
+
+	// Traces the tasks to the SD card, if there is one; convert with sim/tools/traceExport.cpp
+	if (FILE *traceFile = fopen("/usd/trace.bin", "wb"))
+	{
+		auto tracer = std::make_shared<okapi::Tracer>(std::make_unique<okapi::MicroTimer>(), std::make_unique<okapi::Rate>(), traceFile);
+		tracer->startThread();
+		okapi::Tracer::setDefault(tracer);
+	}
+
+	dashboard->addTextField("Settle", []() { return settleStatus.load().str(); });
+	dashboard->startThread();
+}
 
 /**
  * Runs while the robot is in the disabled state of Field Management System or
@@ -67,7 +117,8 @@ void goTo(okapi::Point ipoint, okapi::QAngle iangle, okapi::IterativePosPIDContr
 	// Create PID controllers using OkapiLib to be used in the do-while loop
 	auto xPID = okapi::IterativePosPIDController(idriveGains, okapi::TimeUtilFactory().withSettledUtilParams(0.08));
 	auto yPID = okapi::IterativePosPIDController(idriveGains, okapi::TimeUtilFactory().withSettledUtilParams(0.08));
-	auto yawPID = okapi::IterativePosPIDController(iturnGains, okapi::TimeUtilFactory().withSettledUtilParams(8.0));
+	// The yaw controller wraps its error so it always turns the short way across ±180 degrees
+	auto yawPID = okapi::IterativeAnglePIDController(iturnGains, okapi::TimeUtilFactory().withSettledUtilParams(8.0));
 
 	// Set the target for the PID controllers to the input parameters
 	xPID.setTarget(ipoint.x.convert(okapi::meter));
@@ -80,9 +131,19 @@ void goTo(okapi::Point ipoint, okapi::QAngle iangle, okapi::IterativePosPIDContr
 	yPID.setControllerSetTargetLimits(upperLimit, lowerLimit);
 	yawPID.setControllerSetTargetLimits(upperLimit, lowerLimit);
 
+	// Decide when the move is done from the whole pose instead of from each axis separately. The
+	// GPS position is noisy by about 5 mm, which over the default 100 ms window reads as more than
+	// 2 in/s even when the robot is still, so measure the speeds over 500 ms (25 loops)
+	const okapi::OdomState target{ipoint.x, ipoint.y, iangle};
+	auto settledUtil = okapi::PoseSettledUtil(okapi::TimeUtilFactory::createDefault().getTimer(), 0.08 * okapi::meter, 8_deg, 2_in / okapi::second, 10_deg / okapi::second, 250_ms, 500_ms);
+
 	// Declare variables to be used in the loop
 	pros::c::gps_status_s_t gpsData;
 	double xPow, yPow, yawPow, yawRadians;
+	bool settled;
+	int iteration = 0;
+	okapi::InstrumentedRate rate(std::make_unique<okapi::Rate>(), goToTiming);
+	goToTiming->begin();
 
 	do
 	{
@@ -90,7 +151,10 @@ void goTo(okapi::Point ipoint, okapi::QAngle iangle, okapi::IterativePosPIDContr
 		// Check if primary GPS can see
 		// if (gpsPrimary.get_error() < .01)
 		// Use primary GPS data
-		gpsData = gpsPrimary.get_status();
+		{
+			TRACE_SPAN("gps read");
+			gpsData = gpsPrimary.get_status();
+		}
 		// else
 		// {
 		// 	// Use secondary GPS data
@@ -102,33 +166,66 @@ void goTo(okapi::Point ipoint, okapi::QAngle iangle, okapi::IterativePosPIDContr
 		// 		gpsData.yaw = 180.0 - gpsData.yaw;
 		// }
 
-		xPow = xPID.step(gpsData.x);
-		yPow = yPID.step(gpsData.y);
-		yawPow = yawPID.step(gpsData.yaw);
+		{
+			TRACE_SPAN("PID step");
+			xPow = xPID.step(gpsData.x);
+			yPow = yPID.step(gpsData.y);
+			yawPow = yawPID.step(gpsData.yaw);
+		}
 
+		// Rotate the vectors of the x and y error to match the rotation of the robot on the field.
+		// The GPS yaw is clockwise from +y, so the robot's right is (cos, -sin) and its front
+		// (sin, cos) on the field. Both use the field powers, so keep x's until y is done.
 		yawRadians = okapi::degreeToRadian * gpsData.yaw;
-		xPow = xPow * std::cos(yawRadians) - yPow * std::sin(yawRadians);
-		yPow = xPow * std::sin(yawRadians) + yPow * std::cos(yawRadians);
+		const double fieldXPow = xPow;
+		xPow = fieldXPow * std::cos(yawRadians) - yPow * std::sin(yawRadians);
+		yPow = fieldXPow * std::sin(yawRadians) + yPow * std::cos(yawRadians);
 
-		// Rotate the vectors of the x and y error to match the rotation of the robot on the field and
 		// Make the chassis move based on error values
-		xdrive->xArcade(xPow, yPow, yawPow);
+		{
+			TRACE_SPAN("motor write");
+			xdrive->xArcade(xPow, yPow, yawPow);
+		}
+
+		settled = settledUtil.isSettled({gpsData.x * okapi::meter, gpsData.y * okapi::meter, gpsData.yaw * okapi::degree}, target);
+		const okapi::PoseSettledUtil::Status &status = settledUtil.getStatus();
+
+		// Telemetry only stores the values here; its own task sends them
+		telemetry->set(xSignal, gpsData.x);
+		telemetry->set(ySignal, gpsData.y);
+		telemetry->set(yawSignal, gpsData.yaw);
+		telemetry->set(xPowSignal, xPow);
+		telemetry->set(yPowSignal, yPow);
+		telemetry->set(yawPowSignal, yawPow);
+		telemetry->set(distanceErrorSignal, status.distanceError.convert(okapi::meter));
+		telemetry->set(angleErrorSignal, status.angleError.convert(okapi::degree));
+		telemetry->set(settledSignal, settled);
+		// Each voltage read asks the motor, so only read them as often as they are sent
+		if (iteration++ % voltageDecimation == 0)
+		{
+			telemetry->set(topLeftSignal, xdrive->getTopLeftMotor()->getVoltage());
+			telemetry->set(topRightSignal, xdrive->getTopRightMotor()->getVoltage());
+			telemetry->set(bottomRightSignal, xdrive->getBottomRightMotor()->getVoltage());
+			telemetry->set(bottomLeftSignal, xdrive->getBottomLeftMotor()->getVoltage());
+		}
 
-		// Printouts for debugging
-		pros::screen::print(TEXT_MEDIUM, 1, "X Position: %3f", gpsData.x);
-		pros::screen::print(TEXT_MEDIUM, 2, "Y Position: %3f", gpsData.y);
-		pros::screen::print(TEXT_MEDIUM, 3, "Yaw: %3f", gpsData.yaw);
-		pros::screen::print(TEXT_MEDIUM, 4, "xSettled: %d", xPID.isSettled());
-		pros::screen::print(TEXT_MEDIUM, 5, "ySettled: %d", yPID.isSettled());
-		pros::screen::print(TEXT_MEDIUM, 6, "yawSettled: %d", yawPID.isSettled());
+		// Printouts for debugging, drawn by the dashboard's task
+		dashboard->set(xField, gpsData.x);
+		dashboard->set(yField, gpsData.y);
+		dashboard->set(yawField, gpsData.yaw);
+		dashboard->set(distanceErrorField, status.distanceError.convert(okapi::meter));
+		dashboard->set(angleErrorField, status.angleError.convert(okapi::degree));
+		settleStatus.store(status);
 
-		pros::delay(20);
+		rate.delayUntil(20_ms);
 
 		// Check if chassis is settled to exit the loop
-	} while (!xPID.isSettled() || !yPID.isSettled() || !yawPID.isSettled());
+	} while (!settled);
 
 	// Stop chassis motion
 	xdrive->stop();
+	goToTiming->stop();
+	goToTiming->print(stdout);
 }
 
 /**
@@ -148,7 +245,7 @@ void opcontrol()
 {
 	gpsPrimary.get_status();
 	pros::delay(500);
-	const okapi::IterativePosPIDController::Gains driveGains = {-2.0, 0.0, -0.01}, turnGains = {1.0 / 90.0, 0.0, 0.001};
+	const okapi::IterativePosPIDController::Gains driveGains = {2.0, 0.0, 0.01}, turnGains = {1.0 / 90.0, 0.0, 0.001};
 
 	// goTo({36_in, 36_in}, 45_deg, driveGains, turnGains);
 	// goTo({-36_in, 36_in}, -45_deg, driveGains, turnGains);
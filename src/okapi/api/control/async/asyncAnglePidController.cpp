@@ -0,0 +1,57 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncAnglePidController.hpp"
+
+namespace okapi {
+AsyncAnglePIDController::AsyncAnglePIDController(
+  const std::shared_ptr<ControllerInput<double>> &iinput,
+  const std::shared_ptr<ControllerOutput<double>> &ioutput,
+  const TimeUtil &itimeUtil,
+  const IterativePosPIDController::Gains &igains,
+  std::unique_ptr<Filter> iderivativeFilter,
+  const std::shared_ptr<Logger> &ilogger)
+  : AsyncAnglePIDController(std::make_shared<OffsetableControllerInput>(iinput),
+                            ioutput,
+                            itimeUtil,
+                            igains,
+                            std::move(iderivativeFilter),
+                            ilogger) {
+}
+
+AsyncAnglePIDController::AsyncAnglePIDController(
+  const std::shared_ptr<OffsetableControllerInput> &iinput,
+  const std::shared_ptr<ControllerOutput<double>> &ioutput,
+  const TimeUtil &itimeUtil,
+  const IterativePosPIDController::Gains &igains,
+  std::unique_ptr<Filter> iderivativeFilter,
+  const std::shared_ptr<Logger> &ilogger)
+  : AsyncEventWrapper<double, double>(
+      iinput,
+      ioutput,
+      std::make_shared<IterativeAnglePIDController>(
+        igains, itimeUtil, std::move(iderivativeFilter), ilogger),
+      itimeUtil.getRateSupplier(),
+      1,
+      ilogger),
+    offsettableInput(iinput) {
+  internalController = std::static_pointer_cast<IterativeAnglePIDController>(controller);
+}
+
+void AsyncAnglePIDController::tarePosition() {
+  offsettableInput->tarePosition();
+}
+
+void AsyncAnglePIDController::setMaxVelocity(std::int32_t) {
+}
+
+void AsyncAnglePIDController::setGains(const IterativePosPIDController::Gains &igains) {
+  internalController->setGains(igains);
+}
+
+IterativePosPIDController::Gains AsyncAnglePIDController::getGains() const {
+  return internalController->getGains();
+}
+} // namespace okapi
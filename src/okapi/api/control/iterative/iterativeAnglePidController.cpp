@@ -0,0 +1,80 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/iterative/iterativeAnglePidController.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+
+namespace okapi {
+IterativeAnglePIDController::IterativeAnglePIDController(
+  const double ikP,
+  const double ikI,
+  const double ikD,
+  const double ikBias,
+  const TimeUtil &itimeUtil,
+  std::unique_ptr<Filter> iderivativeFilter,
+  std::shared_ptr<Logger> ilogger)
+  : IterativePosPIDController(
+      ikP, ikI, ikD, ikBias, itimeUtil, std::move(iderivativeFilter), std::move(ilogger)) {
+}
+
+IterativeAnglePIDController::IterativeAnglePIDController(
+  const Gains &igains,
+  const TimeUtil &itimeUtil,
+  std::unique_ptr<Filter> iderivativeFilter,
+  std::shared_ptr<Logger> ilogger)
+  : IterativePosPIDController(igains, itimeUtil, std::move(iderivativeFilter), std::move(ilogger)) {
+}
+
+double IterativeAnglePIDController::step(const double inewReading) {
+  // Unwrap the reading so the base controller only ever sees a continuous signal
+  if (hasReading) {
+    unwrappedReading +=
+      OdomMath::constrainAngle180((inewReading - lastRawReading) * degree).convert(degree);
+  } else {
+    unwrappedReading = inewReading;
+    hasReading = true;
+  }
+  lastRawReading = inewReading;
+
+  // Aim at the copy of the target nearest to the reading, which makes the error the shortest
+  // rotation. The copy only changes when the reading passes the point opposite the target, where
+  // the error flips sign anyway; shift the last error with it so it does not look like a 360
+  // degree step.
+  const double nearestTarget =
+    unwrappedReading +
+    OdomMath::constrainAngle180((angleTarget - unwrappedReading) * degree).convert(degree);
+  lastError += nearestTarget - target;
+  target = nearestTarget;
+
+  return IterativePosPIDController::step(unwrappedReading);
+}
+
+void IterativeAnglePIDController::setTarget(const double itarget) {
+  angleTarget = itarget;
+
+  const double reference = hasReading ? unwrappedReading : 0;
+  IterativePosPIDController::setTarget(
+    reference + OdomMath::constrainAngle180((itarget - reference) * degree).convert(degree));
+}
+
+double IterativeAnglePIDController::getTarget() {
+  return angleTarget;
+}
+
+double IterativeAnglePIDController::getTarget() const {
+  return angleTarget;
+}
+
+double IterativeAnglePIDController::getProcessValue() const {
+  return lastRawReading;
+}
+
+void IterativeAnglePIDController::reset() {
+  IterativePosPIDController::reset();
+  hasReading = false;
+  lastRawReading = 0;
+  unwrappedReading = 0;
+}
+} // namespace okapi
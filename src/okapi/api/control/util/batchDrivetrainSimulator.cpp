@@ -0,0 +1,337 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/batchDrivetrainSimulator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace okapi {
+namespace {
+constexpr double pi = 3.14159265358979323846;
+constexpr double gravity = 9.81;
+
+std::size_t channelsOf(const BatchDrivetrainSimulator::Drive idrive) {
+  switch (idrive) {
+  case BatchDrivetrainSimulator::Drive::skidSteer:
+    return 2;
+  case BatchDrivetrainSimulator::Drive::hDrive:
+    return 3;
+  default:
+    return 4;
+  }
+}
+
+/**
+ * Stall torque (N*m) of one V5 motor with the given cartridge, at its output shaft.
+ */
+double stallTorqueOf(const AbstractMotor::gearset igearset) {
+  switch (igearset) {
+  case AbstractMotor::gearset::red:
+    return 2.1;
+  case AbstractMotor::gearset::blue:
+    return 0.35;
+  default:
+    return 1.05;
+  }
+}
+
+/**
+ * The largest force opposing ivelocity which cannot reverse it within one step.
+ */
+double coulomb(const double ivelocity,
+               const double ifriction,
+               const double imass,
+               const double idt) {
+  return -std::copysign(std::min(ifriction, std::fabs(ivelocity) * imass / idt), ivelocity);
+}
+} // namespace
+
+BatchDrivetrainSimulator::BatchDrivetrainSimulator(const Drive idrive,
+                                                   const std::size_t icount,
+                                                   const Parameters &iparameters,
+                                                   const double itimestep)
+  : drive(idrive), count(icount), numChannels(channelsOf(idrive)) {
+  setTimestep(itimestep);
+
+  const double d = std::sqrt(0.5);
+  switch (drive) {
+  case Drive::skidSteer:
+    directionX = {1, 1};
+    directionY = {0, 0};
+    ganged = {1, 1};
+    offsetX = {0, 0};
+    offsetY = {-1, 1};
+    break;
+  case Drive::hDrive:
+    directionX = {1, 1, 0};
+    directionY = {0, 0, 1};
+    ganged = {1, 1, 0};
+    offsetX = {0, 0, 0};
+    offsetY = {-1, 1, 0};
+    break;
+  case Drive::xDrive:
+    // Each wheel rolls at 45 degrees, so forward plus strafe plus yaw mixes like xArcade
+    directionX = {d, d, d, d};
+    directionY = {d, -d, d, -d};
+    ganged = {0, 0, 0, 0};
+    offsetX = {1, 1, -1, -1};
+    offsetY = {-1, 1, 1, -1};
+    break;
+  }
+
+  for (auto field : {&wheelRadius,
+                     &halfTrack,
+                     &mass,
+                     &inertia,
+                     &stallTorque,
+                     &freeSpeed,
+                     &motorsPerSide,
+                     &linearDamping,
+                     &angularDamping,
+                     &linearFriction,
+                     &angularFriction,
+                     &maxWheelForce,
+                     &maxLateralForce,
+                     &rollerDrag,
+                     &x,
+                     &y,
+                     &theta,
+                     &vx,
+                     &vy,
+                     &omega,
+                     &forceX,
+                     &forceY,
+                     &torque}) {
+    field->assign(count, 0.0);
+  }
+
+  for (auto field : {&voltages, &wheelAngles, &wheelVelocities, &slipping}) {
+    field->assign(numChannels * count, 0.0);
+  }
+
+  for (std::size_t i = 0; i < count; i++) {
+    setParameters(i, iparameters);
+  }
+}
+
+BatchDrivetrainSimulator::~BatchDrivetrainSimulator() = default;
+
+void BatchDrivetrainSimulator::step() {
+  const double dt = timestep;
+  const double wheels = static_cast<double>(numChannels);
+  const std::size_t n = count;
+
+  // The per robot loops below are what gets vectorized. Every array is distinct, so ivdep spares
+  // the compiler from versioning each loop on a run-time overlap check for every pair of arrays,
+  // and std::min/max (rather than fmin/fmax, which must handle NaN) compile to vector min/max.
+  const double *radius = wheelRadius.data();
+  const double *half = halfTrack.data();
+  const double *m = mass.data();
+  const double *j = inertia.data();
+  const double *stall = stallTorque.data();
+  const double *free = freeSpeed.data();
+  const double *motorsEach = motorsPerSide.data();
+  const double *maxForce = maxWheelForce.data();
+  const double *maxLateral = maxLateralForce.data();
+  const double *drag = rollerDrag.data();
+  double *px = x.data();
+  double *py = y.data();
+  double *ptheta = theta.data();
+  double *pvx = vx.data();
+  double *pvy = vy.data();
+  double *pomega = omega.data();
+  double *fx = forceX.data();
+  double *fy = forceY.data();
+  double *tz = torque.data();
+
+  std::fill(forceX.begin(), forceX.end(), 0.0);
+  std::fill(forceY.begin(), forceY.end(), 0.0);
+  std::fill(torque.begin(), torque.end(), 0.0);
+
+  for (std::size_t c = 0; c < numChannels; c++) {
+    const double dx = directionX[c];
+    const double dy = directionY[c];
+    const double gangedScale = ganged[c];
+    const double ox = offsetX[c];
+    const double oy = offsetY[c];
+    const double *volts = voltages.data() + c * n;
+    double *angle = wheelAngles.data() + c * n;
+    double *velocity = wheelVelocities.data() + c * n;
+    double *slip = slipping.data() + c * n;
+
+#pragma GCC ivdep
+    for (std::size_t i = 0; i < n; i++) {
+      const double rx = ox * half[i];
+      const double ry = oy * half[i];
+
+      // Velocity of the contact patch, split along and across the wheel's rolling direction
+      const double contactX = pvx[i] - pomega[i] * ry;
+      const double contactY = pvy[i] + pomega[i] * rx;
+      const double rolling = contactX * dx + contactY * dy;
+      const double lateral = contactY * dx - contactX * dy;
+
+      const double wheelVelocity = rolling / radius[i];
+      velocity[i] = wheelVelocity;
+      angle[i] += wheelVelocity * dt;
+
+      const double motors = gangedScale * motorsEach[i] + (1.0 - gangedScale);
+      const double demanded =
+        motors * stall[i] * (volts[i] / 12.0 - wheelVelocity / free[i]) / radius[i];
+      const double drive = std::max(-maxForce[i], std::min(maxForce[i], demanded));
+      slip[i] = std::fabs(demanded) > maxForce[i] ? 1.0 : 0.0;
+
+      // Roller drag plus, for traction wheels, grip which stops sideways sliding up to its limit
+      const double side = -drag[i] * lateral + coulomb(lateral, maxLateral[i], m[i] / wheels, dt);
+
+      const double wheelX = drive * dx - side * dy;
+      const double wheelY = drive * dy + side * dx;
+      fx[i] += wheelX;
+      fy[i] += wheelY;
+      tz[i] += rx * wheelY - ry * wheelX;
+    }
+  }
+
+#pragma GCC ivdep
+  for (std::size_t i = 0; i < n; i++) {
+    const double netX =
+      fx[i] - linearDamping[i] * pvx[i] + coulomb(pvx[i], linearFriction[i], m[i], dt);
+    const double netY =
+      fy[i] - linearDamping[i] * pvy[i] + coulomb(pvy[i], linearFriction[i], m[i], dt);
+    const double netTorque =
+      tz[i] - angularDamping[i] * pomega[i] + coulomb(pomega[i], angularFriction[i], j[i], dt);
+
+    pvx[i] += netX / m[i] * dt;
+    pvy[i] += netY / m[i] * dt;
+    pomega[i] += netTorque / j[i] * dt;
+  }
+
+  // Integrate with the new velocity, rotated into the field frame
+  for (std::size_t i = 0; i < n; i++) {
+    const double cosTheta = std::cos(ptheta[i]);
+    const double sinTheta = std::sin(ptheta[i]);
+    px[i] += (pvx[i] * cosTheta - pvy[i] * sinTheta) * dt;
+    py[i] += (pvx[i] * sinTheta + pvy[i] * cosTheta) * dt;
+    ptheta[i] += pomega[i] * dt;
+  }
+}
+
+void BatchDrivetrainSimulator::setParameters(const std::size_t iindex,
+                                             const Parameters &iparameters) {
+  if (iparameters.mass <= 0 || iparameters.wheelRadius <= 0 || iparameters.trackWidth <= 0 ||
+      iparameters.externalRatio <= 0) {
+    throw std::invalid_argument("BatchDrivetrainSimulator: The mass, wheel radius, track width, "
+                                "and external ratio must be greater than zero.");
+  }
+
+  if (iparameters.gearset == AbstractMotor::gearset::invalid) {
+    throw std::invalid_argument("BatchDrivetrainSimulator: The gearset must not be invalid.");
+  }
+
+  const double normalForce = iparameters.mass * gravity / numChannels;
+  const double motorFreeSpeed = static_cast<double>(iparameters.gearset) * 2 * pi / 60;
+
+  wheelRadius[iindex] = iparameters.wheelRadius;
+  halfTrack[iindex] = iparameters.trackWidth / 2;
+  mass[iindex] = iparameters.mass;
+  inertia[iindex] = iparameters.inertia > 0 ? iparameters.inertia
+                                            : iparameters.mass * iparameters.trackWidth *
+                                                iparameters.trackWidth / 6;
+  stallTorque[iindex] = stallTorqueOf(iparameters.gearset) / iparameters.externalRatio;
+  freeSpeed[iindex] = motorFreeSpeed * iparameters.externalRatio;
+  motorsPerSide[iindex] = iparameters.motorsPerSide;
+  linearDamping[iindex] = iparameters.linearDamping;
+  angularDamping[iindex] = iparameters.angularDamping;
+  linearFriction[iindex] = iparameters.linearFriction;
+  angularFriction[iindex] = iparameters.angularFriction;
+  maxWheelForce[iindex] = iparameters.traction * normalForce;
+  maxLateralForce[iindex] = iparameters.lateralGrip * iparameters.traction * normalForce;
+  rollerDrag[iindex] = iparameters.rollerDrag;
+}
+
+void BatchDrivetrainSimulator::setPose(const std::size_t iindex,
+                                       const double ix,
+                                       const double iy,
+                                       const double itheta) {
+  x[iindex] = ix;
+  y[iindex] = iy;
+  theta[iindex] = itheta;
+  vx[iindex] = 0;
+  vy[iindex] = 0;
+  omega[iindex] = 0;
+
+  for (std::size_t c = 0; c < numChannels; c++) {
+    wheelAngles[c * count + iindex] = 0;
+    wheelVelocities[c * count + iindex] = 0;
+    slipping[c * count + iindex] = 0;
+  }
+}
+
+void BatchDrivetrainSimulator::setVoltage(const std::size_t ichannel,
+                                          const std::size_t iindex,
+                                          const double ivoltage) {
+  voltages[ichannel * count + iindex] = std::max(-12.0, std::min(12.0, ivoltage));
+}
+
+double *BatchDrivetrainSimulator::getVoltages(const std::size_t ichannel) {
+  return &voltages[ichannel * count];
+}
+
+void BatchDrivetrainSimulator::setTimestep(const double itimestep) {
+  if (itimestep <= 0) {
+    throw std::invalid_argument(
+      "BatchDrivetrainSimulator: The timestep must be greater than zero.");
+  }
+
+  timestep = itimestep;
+}
+
+std::size_t BatchDrivetrainSimulator::getSize() const {
+  return count;
+}
+
+std::size_t BatchDrivetrainSimulator::getNumChannels() const {
+  return numChannels;
+}
+
+double BatchDrivetrainSimulator::getX(const std::size_t iindex) const {
+  return x[iindex];
+}
+
+double BatchDrivetrainSimulator::getY(const std::size_t iindex) const {
+  return y[iindex];
+}
+
+double BatchDrivetrainSimulator::getTheta(const std::size_t iindex) const {
+  return theta[iindex];
+}
+
+double BatchDrivetrainSimulator::getForwardVelocity(const std::size_t iindex) const {
+  return vx[iindex];
+}
+
+double BatchDrivetrainSimulator::getRightVelocity(const std::size_t iindex) const {
+  return vy[iindex];
+}
+
+double BatchDrivetrainSimulator::getAngularVelocity(const std::size_t iindex) const {
+  return omega[iindex];
+}
+
+double BatchDrivetrainSimulator::getWheelAngle(const std::size_t ichannel,
+                                               const std::size_t iindex) const {
+  return wheelAngles[ichannel * count + iindex];
+}
+
+double BatchDrivetrainSimulator::getWheelVelocity(const std::size_t ichannel,
+                                                  const std::size_t iindex) const {
+  return wheelVelocities[ichannel * count + iindex];
+}
+
+bool BatchDrivetrainSimulator::isWheelSlipping(const std::size_t ichannel,
+                                               const std::size_t iindex) const {
+  return slipping[ichannel * count + iindex] != 0;
+}
+} // namespace okapi
@@ -0,0 +1,197 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/controlExecutor.hpp"
+#include "okapi/api/util/tracer.hpp"
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <mutex>
+
+namespace okapi {
+ControlExecutor::ControlExecutor(const TimeUtil &itimeUtil,
+                                 const QTime iperiod,
+                                 std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    timeUtil(itimeUtil),
+    period(iperiod),
+    stageTimer(itimeUtil.getTimer()) {
+  if (period <= 0_ms) {
+    std::string msg = "ControlExecutor: The period must be greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+ControlExecutor::~ControlExecutor() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+ControlExecutor::Entry::Entry(const std::size_t iid,
+                              const Stage istage,
+                              const std::uint32_t idivisor,
+                              std::function<void()> istep)
+  : id(iid), stage(istage), divisor(idivisor), step(std::move(istep)) {
+}
+
+std::size_t
+ControlExecutor::add(const Stage istage, std::function<void()> istep, const QTime iperiod) {
+  const auto divisor =
+    static_cast<std::uint32_t>(std::max(1.0, std::round((iperiod / period).getValue())));
+
+  std::lock_guard<CrossplatformMutex> lock(mutex);
+  const std::size_t id = nextId++;
+  auto next = std::make_shared<EntryList>(*entries);
+  const auto pos = std::upper_bound(
+    next->begin(),
+    next->end(),
+    istage,
+    [](const Stage stage, const std::shared_ptr<Entry> &entry) { return stage < entry->stage; });
+  next->insert(pos, std::make_shared<Entry>(id, istage, divisor, std::move(istep)));
+  entries = std::move(next);
+
+  LOG_INFO("ControlExecutor: Added step " + std::to_string(id) + " to stage " +
+           std::to_string(static_cast<int>(istage)) + " every " + std::to_string(divisor) +
+           " ticks");
+  return id;
+}
+
+void ControlExecutor::remove(const std::size_t iid) {
+  std::shared_ptr<Entry> removed;
+  {
+    std::lock_guard<CrossplatformMutex> lock(mutex);
+    auto next = std::make_shared<EntryList>();
+    next->reserve(entries->size());
+    for (const auto &entry : *entries) {
+      if (entry->id == iid) {
+        removed = entry;
+      } else {
+        next->push_back(entry);
+      }
+    }
+    entries = std::move(next);
+  }
+
+  if (removed) {
+    // A tick which copied the list already checks this before running the step. Waiting for the
+    // running tick covers one which checked it before it was set.
+    removed->removed.store(true, std::memory_order_release);
+    std::lock_guard<CrossplatformMutex> lock(tickMutex);
+  }
+}
+
+void ControlExecutor::tick() {
+  static const std::array<std::uint16_t, numStages> stageNames{Tracer::intern("sensor read"),
+                                                               Tracer::intern("odometry"),
+                                                               Tracer::intern("controllers"),
+                                                               Tracer::intern("motor write")};
+
+  TRACE_SPAN("executor tick");
+  std::lock_guard<CrossplatformMutex> tickLock(tickMutex);
+
+  std::shared_ptr<const EntryList> steps;
+  {
+    TRACE_SPAN("executor lock wait");
+    std::lock_guard<CrossplatformMutex> lock(mutex);
+    steps = entries;
+  }
+
+  // Each stage which runs a step is traced as a span of its own
+  Tracer *const tracer = Tracer::getDefault();
+  std::array<QTime, numStages> stageTimes;
+  std::bitset<numStages> stagesRan;
+  std::bitset<numStages> stagesTraced;
+  const QTime tickStart = stageTimer->millis();
+  QTime stageStart = tickStart;
+  auto it = steps->begin();
+  for (std::size_t stage = 0; stage < numStages; stage++) {
+    for (; it != steps->end() && static_cast<std::size_t>((*it)->stage) == stage; ++it) {
+      const Entry &entry = **it;
+      if (tickCount % entry.divisor == 0 && !entry.removed.load(std::memory_order_acquire)) {
+        if (!stagesRan[stage] && tracer) {
+          stagesTraced[stage] = tracer->record(Tracer::Phase::begin, stageNames[stage]);
+        }
+        entry.step();
+        stagesRan[stage] = true;
+      }
+    }
+
+    if (stagesRan[stage]) {
+      if (stagesTraced[stage]) {
+        tracer->record(Tracer::Phase::end, stageNames[stage]);
+      }
+
+      const QTime now = stageTimer->millis();
+      stageTimes[stage] = now - stageStart;
+      stageStart = now;
+    }
+  }
+
+  tickCount++;
+
+  std::lock_guard<CrossplatformMutex> lock(mutex);
+  for (std::size_t stage = 0; stage < numStages; stage++) {
+    if (stagesRan[stage]) {
+      auto &timing = stageTimings[stage];
+      timing.last = stageTimes[stage];
+      timing.max = std::max(timing.max, timing.last);
+      timing.total += timing.last;
+      timing.runs++;
+    }
+  }
+
+  if (stageStart - tickStart > period) {
+    overruns++;
+  }
+}
+
+ControlExecutor::StageTiming ControlExecutor::getStageTiming(const Stage istage) const {
+  std::lock_guard<CrossplatformMutex> lock(mutex);
+  return stageTimings[static_cast<std::size_t>(istage)];
+}
+
+std::uint32_t ControlExecutor::getOverruns() const {
+  std::lock_guard<CrossplatformMutex> lock(mutex);
+  return overruns;
+}
+
+void ControlExecutor::resetTiming() {
+  std::lock_guard<CrossplatformMutex> lock(mutex);
+  stageTimings.fill(StageTiming{});
+  overruns = 0;
+}
+
+QTime ControlExecutor::getPeriod() const {
+  return period;
+}
+
+void ControlExecutor::startThread() {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "ControlExecutor");
+#ifndef THREADS_STD
+    pros::c::task_set_priority(task->thread, TASK_PRIORITY_DEFAULT + 2);
+#endif
+  }
+}
+
+CrossplatformThread *ControlExecutor::getThread() const {
+  return task;
+}
+
+void ControlExecutor::trampoline(void *context) {
+  if (context) {
+    static_cast<ControlExecutor *>(context)->loop();
+  }
+}
+
+void ControlExecutor::loop() {
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    tick();
+    rate->delayUntil(period);
+  }
+}
+} // namespace okapi
@@ -0,0 +1,127 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/poseSettledUtil.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include "okapi/api/units/QArea.hpp"
+
+namespace okapi {
+PoseSettledUtil::PoseSettledUtil(std::unique_ptr<AbstractTimer> iatTargetTimer,
+                                 const QLength iatTargetDistance,
+                                 const QAngle iatTargetAngle,
+                                 const QSpeed iatTargetSpeed,
+                                 const QAngularSpeed iatTargetAngularSpeed,
+                                 const QTime iatTargetTime,
+                                 const QTime ivelocityWindow)
+  : atTargetTimer(std::move(iatTargetTimer)),
+    atTargetDistance(iatTargetDistance),
+    atTargetAngle(iatTargetAngle),
+    atTargetSpeed(iatTargetSpeed),
+    atTargetAngularSpeed(iatTargetAngularSpeed),
+    atTargetTime(iatTargetTime),
+    velocityWindow(ivelocityWindow) {
+}
+
+PoseSettledUtil::~PoseSettledUtil() = default;
+
+bool PoseSettledUtil::isSettled(const OdomState &icurrent, const OdomState &itarget) {
+  const QTime now = atTargetTimer->millis();
+
+  history[historyIndex] = {now, icurrent};
+  historyIndex = (historyIndex + 1) % historySize;
+  if (historyCount < historySize) {
+    historyCount++;
+  }
+
+  // Measure speed against the oldest pose that is still inside the window. If the loop runs
+  // slower than the window, none is, so measure it against the previous pose instead.
+  const StampedPose *oldest = nullptr;
+  for (std::size_t i = historyCount; i > 1; i--) {
+    const StampedPose &candidate = history[(historyIndex + historySize - i) % historySize];
+    if (now - candidate.time <= velocityWindow) {
+      oldest = &candidate;
+      break;
+    }
+  }
+  if (!oldest && historyCount > 1) {
+    oldest = &history[(historyIndex + historySize - 2) % historySize];
+  }
+
+  status.distanceError =
+    sqrt((icurrent.x - itarget.x) * (icurrent.x - itarget.x) +
+         (icurrent.y - itarget.y) * (icurrent.y - itarget.y));
+  status.angleError = OdomMath::constrainAngle180(itarget.theta - icurrent.theta);
+
+  if (oldest && now > oldest->time) {
+    const QTime dt = now - oldest->time;
+    const QLength dx = icurrent.x - oldest->pose.x;
+    const QLength dy = icurrent.y - oldest->pose.y;
+    status.speed = sqrt(dx * dx + dy * dy) / dt;
+    status.angularSpeed = OdomMath::constrainAngle180(icurrent.theta - oldest->pose.theta) / dt;
+  } else {
+    // Not enough history to measure speed yet, so don't let it count as stopped
+    status.speed = atTargetSpeed * 2;
+    status.angularSpeed = atTargetAngularSpeed * 2;
+  }
+
+  status.isDistanceSettled = status.distanceError <= atTargetDistance;
+  status.isAngleSettled = abs(status.angleError) <= atTargetAngle;
+  status.isSpeedSettled = status.speed <= atTargetSpeed;
+  status.isAngularSpeedSettled = abs(status.angularSpeed) <= atTargetAngularSpeed;
+
+  if (status.isDistanceSettled && status.isAngleSettled && status.isSpeedSettled &&
+      status.isAngularSpeedSettled) {
+    atTargetTimer->placeHardMark();
+  } else {
+    atTargetTimer->clearHardMark();
+  }
+
+  status.timeAtTarget = atTargetTimer->getDtFromHardMark();
+  status.isSettled = status.timeAtTarget > atTargetTime;
+  return status.isSettled;
+}
+
+const PoseSettledUtil::Status &PoseSettledUtil::getStatus() const {
+  return status;
+}
+
+void PoseSettledUtil::reset() {
+  atTargetTimer->clearHardMark();
+  historyIndex = 0;
+  historyCount = 0;
+  status = Status{};
+}
+
+void PoseSettledUtil::setAtTargetTime(const QTime iatTargetTime) {
+  atTargetTime = iatTargetTime;
+}
+
+void PoseSettledUtil::setVelocityWindow(const QTime ivelocityWindow) {
+  velocityWindow = ivelocityWindow;
+}
+
+std::string PoseSettledUtil::Status::str() const {
+  if (isSettled) {
+    return "settled";
+  }
+
+  std::string out;
+  const auto append = [&](const bool met, const std::string &reason) {
+    if (!met) {
+      out += (out.empty() ? "" : ", ") + reason;
+    }
+  };
+
+  append(isDistanceSettled,
+         "distance " + std::to_string(distanceError.convert(inch)) + " in");
+  append(isAngleSettled, "angle " + std::to_string(angleError.convert(degree)) + " deg");
+  append(isSpeedSettled, "speed " + std::to_string(speed.convert(inch / second)) + " in/s");
+  append(isAngularSpeedSettled,
+         "turning " + std::to_string(angularSpeed.convert(degree / second)) + " deg/s");
+
+  return out.empty() ? "holding " + std::to_string(timeAtTarget.convert(millisecond)) + " ms"
+                     : out;
+}
+} // namespace okapi
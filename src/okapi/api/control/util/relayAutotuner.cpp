@@ -0,0 +1,189 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/relayAutotuner.hpp"
+#include "okapi/api/util/asyncLogger.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+RelayAutotuner::RelayAutotuner(const std::shared_ptr<ControllerInput<double>> &iinput,
+                               const std::shared_ptr<ControllerOutput<double>> &ioutput,
+                               const TimeUtil &itimeUtil,
+                               const double isetpoint,
+                               const double irelayAmplitude,
+                               const double ihysteresis,
+                               const double iminReading,
+                               const double imaxReading,
+                               const QTime itimeout,
+                               const std::size_t inumCycles,
+                               const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    input(iinput),
+    output(ioutput),
+    timer(itimeUtil.getTimer()),
+    rate(itimeUtil.getRate()),
+    setpoint(isetpoint),
+    relayAmplitude(std::clamp(std::abs(irelayAmplitude), 0.0, 1.0)),
+    hysteresis(std::abs(ihysteresis)),
+    minReading(iminReading),
+    maxReading(imaxReading),
+    timeout(itimeout),
+    numCycles(std::clamp(inumCycles, std::size_t{1}, maxCycles)) {
+}
+
+RelayAutotuner::~RelayAutotuner() = default;
+
+void RelayAutotuner::start() {
+  LOG_INFO_F("RelayAutotuner: Starting relay experiment around %f", setpoint);
+
+  state = State::running;
+  result = Result{};
+  startTime = timer->millis();
+  lastCycleStart = startTime;
+  cyclesSeen = 0;
+
+  const double reading = input->controllerGet();
+  relayHigh = reading < setpoint;
+  cycleMax = reading;
+  cycleMin = reading;
+}
+
+RelayAutotuner::State RelayAutotuner::step() {
+  if (state != State::running) {
+    return state;
+  }
+
+  const double reading = input->controllerGet();
+  const QTime now = timer->millis();
+
+  if (!std::isfinite(reading) || reading < minReading || reading > maxReading) {
+    LOG_WARN_F("RelayAutotuner: Reading %f left the safe range", reading);
+    abort();
+    return state;
+  }
+
+  if (now - startTime > timeout) {
+    LOG_WARN_F("RelayAutotuner: Timed out after %u oscillations", cyclesSeen);
+    abort();
+    return state;
+  }
+
+  cycleMax = std::max(cycleMax, reading);
+  cycleMin = std::min(cycleMin, reading);
+
+  if (relayHigh && reading > setpoint + hysteresis) {
+    relayHigh = false;
+  } else if (!relayHigh && reading < setpoint - hysteresis) {
+    // Each switch back to the high side closes one full oscillation
+    relayHigh = true;
+    completeCycle(now, reading);
+  }
+
+  if (state == State::running) {
+    output->controllerSet(relayHigh ? relayAmplitude : -relayAmplitude);
+  }
+
+  return state;
+}
+
+RelayAutotuner::State RelayAutotuner::autotune(const QTime iloopDelta) {
+  start();
+  while (step() == State::running) {
+    rate->delayUntil(iloopDelta);
+  }
+
+  return state;
+}
+
+void RelayAutotuner::abort() {
+  output->controllerSet(0);
+  if (state == State::running) {
+    state = State::aborted;
+  }
+}
+
+RelayAutotuner::State RelayAutotuner::getState() const {
+  return state;
+}
+
+RelayAutotuner::Result RelayAutotuner::getResult() const {
+  return result;
+}
+
+IterativePosPIDController::Gains RelayAutotuner::getGains(const TuningRule irule) const {
+  const double ku = result.ultimateGain;
+  const double tu = result.ultimatePeriod.convert(second);
+
+  // Proportional gain, integral time, and derivative time, as fractions of ku and tu
+  double kp, ti, td;
+  switch (irule) {
+  case TuningRule::zieglerNichols:
+    kp = 0.6 * ku, ti = 0.5 * tu, td = 0.125 * tu;
+    break;
+  case TuningRule::tyreusLuyben:
+    kp = ku / 3.2, ti = 2.2 * tu, td = tu / 6.3;
+    break;
+  case TuningRule::pessenIntegral:
+    kp = 0.7 * ku, ti = 0.4 * tu, td = 0.15 * tu;
+    break;
+  case TuningRule::someOvershoot:
+    kp = ku / 3, ti = 0.5 * tu, td = tu / 3;
+    break;
+  case TuningRule::noOvershoot:
+  default:
+    kp = 0.2 * ku, ti = 0.5 * tu, td = tu / 3;
+    break;
+  }
+
+  // IterativePosPIDController takes kI in 1/s and kD in s and scales them by its sample time
+  return {kp, ti > 0 ? kp / ti : 0, kp * td, 0};
+}
+
+void RelayAutotuner::completeCycle(const QTime inow, const double ireading) {
+  // The first oscillation starts from rest, so it is not representative
+  if (cyclesSeen > 0) {
+    periods[cyclesSeen - 1] = (inow - lastCycleStart).convert(second);
+    amplitudes[cyclesSeen - 1] = (cycleMax - cycleMin) / 2;
+  }
+
+  cyclesSeen++;
+  lastCycleStart = inow;
+  cycleMax = cycleMin = ireading;
+
+  if (cyclesSeen <= numCycles) {
+    return;
+  }
+
+  double periodSum = 0;
+  double amplitudeSum = 0;
+  for (std::size_t i = 0; i < numCycles; i++) {
+    periodSum += periods[i];
+    amplitudeSum += amplitudes[i];
+  }
+
+  result.ultimatePeriod = periodSum / static_cast<double>(numCycles) * second;
+  result.amplitude = amplitudeSum / static_cast<double>(numCycles);
+
+  if (result.amplitude <= hysteresis) {
+    LOG_WARN_F("RelayAutotuner: The oscillation is smaller than the hysteresis");
+    abort();
+    return;
+  }
+
+  // Describing function of a relay with hysteresis
+  result.ultimateGain =
+    4 * relayAmplitude /
+    (pi * std::sqrt(result.amplitude * result.amplitude - hysteresis * hysteresis));
+
+  output->controllerSet(0);
+  state = State::done;
+
+  LOG_INFO_F("RelayAutotuner: Done. Ku=%f Tu=%f s",
+             result.ultimateGain,
+             result.ultimatePeriod.convert(second));
+}
+} // namespace okapi
@@ -0,0 +1,222 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/simulatedPidTuner.hpp"
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/util/virtualClock.hpp"
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#ifdef THREADS_STD
+#include <atomic>
+#include <thread>
+#endif
+
+namespace okapi {
+SimulatedPlant::~SimulatedPlant() = default;
+
+FlywheelPlant::FlywheelPlant(std::unique_ptr<FlywheelSimulator> isimulator)
+  : simulator(std::move(isimulator)) {
+}
+
+double FlywheelPlant::step(const double ioutput, const QTime idt) {
+  simulator->setTimestep(idt.convert(second));
+  return simulator->step(ioutput * simulator->getMaxTorque());
+}
+
+double FlywheelPlant::getProcessValue() const {
+  return simulator->getAngle();
+}
+
+SimulatedPIDTuner::SimulatedPIDTuner(
+  const Supplier<std::unique_ptr<SimulatedPlant>> &iplantSupplier,
+  const QTime itimeout,
+  const double igoal,
+  const double ikPMin,
+  const double ikPMax,
+  const double ikIMin,
+  const double ikIMax,
+  const double ikDMin,
+  const double ikDMax,
+  const std::size_t inumIterations,
+  const std::size_t inumParticles,
+  const double ikSettle,
+  const double ikITAE,
+  const double iatTargetError,
+  const std::uint32_t iseed,
+  const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    plantSupplier(iplantSupplier),
+    timeout(itimeout),
+    goal(igoal),
+    kPMin(ikPMin),
+    kPMax(ikPMax),
+    kIMin(ikIMin),
+    kIMax(ikIMax),
+    kDMin(ikDMin),
+    kDMax(ikDMax),
+    numIterations(inumIterations),
+    numParticles(inumParticles),
+    kSettle(ikSettle),
+    kITAE(ikITAE),
+    atTargetError(iatTargetError),
+    seed(iseed) {
+}
+
+SimulatedPIDTuner::~SimulatedPIDTuner() = default;
+
+SimulatedPIDTuner::Result SimulatedPIDTuner::autotune() {
+  struct Particle {
+    double pos, vel, best;
+  };
+
+  struct ParticleSet {
+    Particle kP, kI, kD;
+    double bestCost;
+  };
+
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> unit(0, 1);
+  const auto randomIn = [&](const double min, const double max) {
+    return min + unit(gen) * (max - min);
+  };
+
+  std::vector<ParticleSet> particles;
+  particles.reserve(numParticles);
+  for (std::size_t i = 0; i < numParticles; i++) {
+    const double kP = randomIn(kPMin, kPMax);
+    const double kI = randomIn(kIMin, kIMax);
+    const double kD = randomIn(kDMin, kDMax);
+    particles.push_back(
+      {{kP, 0, kP}, {kI, 0, kI}, {kD, 0, kD}, std::numeric_limits<double>::max()});
+  }
+
+  Result result;
+  result.bestCost = std::numeric_limits<double>::max();
+#ifdef THREADS_STD
+  result.numThreads = std::max(1u, std::thread::hardware_concurrency());
+#endif
+
+  LOG_INFO("SimulatedPIDTuner: Starting " + std::to_string(numIterations) + " iterations of " +
+           std::to_string(numParticles) + " particles on " + std::to_string(result.numThreads) +
+           " threads");
+
+  std::vector<PIDTuner::Output> gains(numParticles);
+  for (std::size_t iteration = 0; iteration < numIterations; iteration++) {
+    for (std::size_t i = 0; i < numParticles; i++) {
+      gains[i] = {particles[i].kP.pos, particles[i].kI.pos, particles[i].kD.pos};
+    }
+
+    const std::vector<double> costs = evaluateAll(gains, result.numThreads);
+    result.numTrials += numParticles;
+
+    for (std::size_t i = 0; i < numParticles; i++) {
+      ParticleSet &particle = particles[i];
+      if (costs[i] < particle.bestCost) {
+        particle.bestCost = costs[i];
+        particle.kP.best = particle.kP.pos;
+        particle.kI.best = particle.kI.pos;
+        particle.kD.best = particle.kD.pos;
+      }
+
+      if (costs[i] < result.bestCost) {
+        result.bestCost = costs[i];
+        result.gains = gains[i];
+      }
+    }
+
+    result.bestCostPerIteration.push_back(result.bestCost);
+    LOG_INFO("SimulatedPIDTuner: Iteration " + std::to_string(iteration) + " best cost " +
+             std::to_string(result.bestCost));
+
+    const auto move = [&](Particle &particle, const double globalBest, const double min,
+                          const double max) {
+      particle.vel = inertia * particle.vel +
+                     confSelf * unit(gen) * (particle.best - particle.pos) +
+                     confSwarm * unit(gen) * (globalBest - particle.pos);
+      particle.pos = std::clamp(particle.pos + particle.vel, min, max);
+    };
+
+    for (auto &particle : particles) {
+      move(particle.kP, result.gains.kP, kPMin, kPMax);
+      move(particle.kI, result.gains.kI, kIMin, kIMax);
+      move(particle.kD, result.gains.kD, kDMin, kDMax);
+    }
+  }
+
+  LOG_INFO("SimulatedPIDTuner: Done. kP=" + std::to_string(result.gains.kP) +
+           " kI=" + std::to_string(result.gains.kI) + " kD=" + std::to_string(result.gains.kD));
+
+  return result;
+}
+
+double SimulatedPIDTuner::evaluate(const PIDTuner::Output &igains) const {
+  // Each trial steps its own clock, so trials never wait on real time or on each other
+  VirtualClock clock;
+  auto plant = plantSupplier.get();
+  const TimeUtil timeUtil = clock.createTimeUtil(atTargetError, atTargetError, atTargetTime);
+
+  // Trials run concurrently and by the thousand, so they don't log
+  IterativePosPIDController controller(igains.kP,
+                                       igains.kI,
+                                       igains.kD,
+                                       0,
+                                       timeUtil,
+                                       std::make_unique<PassthroughFilter>(),
+                                       std::make_shared<Logger>());
+  controller.setSampleTime(loopDelta);
+  controller.setTarget(goal);
+
+  double reading = plant->getProcessValue();
+  double itae = 0;
+  QTime settleTime = timeout;
+  while (clock.now() < timeout) {
+    clock.advance(loopDelta);
+    const QTime now = clock.now();
+    reading = plant->step(controller.step(reading), loopDelta);
+    itae += now.convert(second) * std::abs(goal - reading) * loopDelta.convert(second);
+
+    if (controller.isSettled()) {
+      settleTime = now;
+      break;
+    }
+  }
+
+  return kSettle * settleTime.convert(second) + kITAE * itae;
+}
+
+std::vector<double> SimulatedPIDTuner::evaluateAll(const std::vector<PIDTuner::Output> &igains,
+                                                   const std::size_t inumThreads) const {
+  std::vector<double> costs(igains.size());
+
+#ifdef THREADS_STD
+  std::atomic_size_t next{0};
+  const auto worker = [&]() {
+    for (std::size_t i = next++; i < igains.size(); i = next++) {
+      costs[i] = evaluate(igains[i]);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < inumThreads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+#else
+  // PROS has no std::thread, so evaluate the trials in this task
+  (void)inumThreads;
+  for (std::size_t i = 0; i < igains.size(); i++) {
+    costs[i] = evaluate(igains[i]);
+  }
+#endif
+
+  return costs;
+}
+} // namespace okapi
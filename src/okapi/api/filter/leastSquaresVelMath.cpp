@@ -0,0 +1,123 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/leastSquaresVelMath.hpp"
+#include "okapi/api/filter/passthroughFilter.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace okapi {
+LeastSquaresVelMath::LeastSquaresVelMath(const double iticksPerRev,
+                                         const std::size_t iwindowSize,
+                                         std::unique_ptr<AbstractTimer> iloopDtTimer,
+                                         std::shared_ptr<Logger> ilogger)
+  : VelMath(iticksPerRev,
+            std::make_unique<PassthroughFilter>(),
+            0_ms,
+            std::move(iloopDtTimer),
+            std::move(ilogger)),
+    samples(iwindowSize) {
+  if (iwindowSize < 3) {
+    std::string msg("LeastSquaresVelMath: The window size must be at least 3 to fit a quadratic.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+QAngularSpeed LeastSquaresVelMath::step(const double inewPos) {
+  return stepDerivatives(inewPos).velocity;
+}
+
+LeastSquaresVelMath::Derivatives LeastSquaresVelMath::stepDerivatives(const double inewPos) {
+  const Sample sample{loopDtTimer->millis().convert(second), inewPos};
+
+  if (count == 0) {
+    origin = sample;
+  }
+
+  if (count == samples.size()) {
+    accumulate(samples[index], -1);
+  } else {
+    count++;
+  }
+
+  samples[index] = sample;
+  accumulate(sample, 1);
+
+  index++;
+  if (index >= samples.size()) {
+    index = 0;
+    rebase();
+  }
+
+  const double s0 = timeSums[0], s1 = timeSums[1], s2 = timeSums[2], s3 = timeSums[3],
+               s4 = timeSums[4];
+  const double t0 = posSums[0], t1 = posSums[1], t2 = posSums[2];
+  const double newestTime = sample.time - origin.time;
+
+  // Solve the normal equations of y = a + b * t + c * t^2 with Cramer's rule. Fall back to a
+  // straight line when there are too few distinct timestamps for a quadratic, and keep the last
+  // estimate when there are too few for a line.
+  const double quadDet =
+    s0 * (s2 * s4 - s3 * s3) - s1 * (s1 * s4 - s3 * s2) + s2 * (s1 * s3 - s2 * s2);
+  const double lineDet = s0 * s2 - s1 * s1;
+
+  double slope;
+  double curvature = 0;
+  if (count >= 3 && std::abs(quadDet) > 1e-9 * s0 * s2 * s4) {
+    const double bDet =
+      s0 * (t1 * s4 - s3 * t2) - t0 * (s1 * s4 - s3 * s2) + s2 * (s1 * t2 - t1 * s2);
+    const double cDet =
+      s0 * (s2 * t2 - t1 * s3) - s1 * (s1 * t2 - t1 * s2) + t0 * (s1 * s3 - s2 * s2);
+    curvature = cDet / quadDet;
+    slope = bDet / quadDet + 2 * curvature * newestTime;
+  } else if (count >= 2 && std::abs(lineDet) > 1e-9 * s0 * s2) {
+    slope = (s0 * t1 - s1 * t0) / lineDet;
+  } else {
+    return {vel, accel};
+  }
+
+  lastVel = vel;
+  lastPos = inewPos;
+  vel = (60.0 * slope / ticksPerRev) * rpm;
+  accel = (2.0 * curvature / ticksPerRev) * (360 * degree) / (second * second);
+
+  return {vel, accel};
+}
+
+void LeastSquaresVelMath::reset() {
+  index = 0;
+  count = 0;
+  timeSums.fill(0);
+  posSums.fill(0);
+  vel = 0_rpm;
+  lastVel = 0_rpm;
+  accel = 0.0 * (360 * degree) / (second * second);
+}
+
+void LeastSquaresVelMath::accumulate(const Sample &isample, const double isign) {
+  const double time = isample.time - origin.time;
+  const double pos = isample.pos - origin.pos;
+
+  double timePow = isign;
+  for (std::size_t i = 0; i < timeSums.size(); i++) {
+    timeSums[i] += timePow;
+    if (i < posSums.size()) {
+      posSums[i] += pos * timePow;
+    }
+    timePow *= time;
+  }
+}
+
+void LeastSquaresVelMath::rebase() {
+  // Called right after the write at the end of the buffer, so that slot holds the newest sample
+  origin = samples.back();
+  timeSums.fill(0);
+  posSums.fill(0);
+  for (std::size_t i = 0; i < count; i++) {
+    accumulate(samples[i], 1);
+  }
+}
+} // namespace okapi
@@ -0,0 +1,89 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/headingFusion.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include <cmath>
+
+namespace okapi {
+HeadingFusion::HeadingFusion(const QTime itimeConstant, const double imaxAbsoluteError)
+  : timeConstant(itimeConstant), maxAbsoluteError(imaxAbsoluteError) {
+}
+
+HeadingFusion::~HeadingFusion() = default;
+
+QAngle HeadingFusion::step(const QAngle irelative,
+                           const QAngle iabsolute,
+                           const double iabsoluteError,
+                           const QTime idt) {
+  step(irelative);
+
+  absoluteValid = std::isfinite(iabsolute.getValue()) && std::isfinite(iabsoluteError) &&
+                  iabsoluteError <= maxAbsoluteError;
+  if (!absoluteValid) {
+    return heading;
+  }
+
+  // Correct along the shortest rotation so the estimate stays continuous across the wrap
+  const QAngle error = OdomMath::constrainAngle180(iabsolute - heading);
+  if (!absoluteFix) {
+    // There is no absolute reference yet, so take the first one completely
+    heading += error;
+    absoluteFix = true;
+  } else {
+    heading += error * (idt / (timeConstant + idt)).getValue();
+  }
+
+  return heading;
+}
+
+QAngle HeadingFusion::step(const QAngle irelative) {
+  absoluteValid = false;
+
+  if (!std::isfinite(irelative.getValue())) {
+    return heading;
+  }
+
+  if (hasRelative) {
+    heading += irelative - lastRelative;
+  } else if (!absoluteFix) {
+    heading = irelative;
+  }
+  // An absolute fix which came before the first relative heading is kept, and that sample only
+  // sets where the relative changes are measured from
+  hasRelative = true;
+
+  lastRelative = irelative;
+  return heading;
+}
+
+QAngle HeadingFusion::getHeading() const {
+  return heading;
+}
+
+QAngle HeadingFusion::getWrappedHeading() const {
+  return OdomMath::constrainAngle180(heading);
+}
+
+bool HeadingFusion::isAbsoluteValid() const {
+  return absoluteValid;
+}
+
+bool HeadingFusion::hasAbsoluteFix() const {
+  return absoluteFix;
+}
+
+void HeadingFusion::reset() {
+  heading = 0_deg;
+  lastRelative = 0_deg;
+  hasRelative = false;
+  absoluteValid = false;
+  absoluteFix = false;
+}
+
+void HeadingFusion::setTimeConstant(const QTime itimeConstant) {
+  timeConstant = itimeConstant;
+}
+} // namespace okapi
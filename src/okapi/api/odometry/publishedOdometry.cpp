@@ -0,0 +1,64 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/publishedOdometry.hpp"
+#include "okapi/api/util/tracer.hpp"
+#include <mutex>
+
+namespace okapi {
+PublishedOdometry::PublishedOdometry(std::shared_ptr<Odometry> iodometry)
+  : odometry(std::move(iodometry)) {
+  publish();
+}
+
+void PublishedOdometry::setScales(const ChassisScales &ichassisScales) {
+  odometry->setScales(ichassisScales);
+}
+
+void PublishedOdometry::step() {
+  TRACE_SPAN("odom step");
+  {
+    // A long wait here is a setState() from another task holding the mutex
+    TRACE_SPAN("odom lock wait");
+    writeMutex.lock();
+  }
+  std::lock_guard<CrossplatformMutex> lock(writeMutex, std::adopt_lock);
+  odometry->step();
+  publish();
+}
+
+OdomState PublishedOdometry::getState(const StateMode &imode) const {
+  std::uint32_t version;
+  return getState(version, imode);
+}
+
+OdomState PublishedOdometry::getState(std::uint32_t &oversion, const StateMode &imode) const {
+  const Snapshot snapshot = published.load(oversion);
+  return imode == StateMode::CARTESIAN ? snapshot.cartesian : snapshot.frameTransformation;
+}
+
+std::uint32_t PublishedOdometry::getVersion() const {
+  return published.getVersion();
+}
+
+void PublishedOdometry::setState(const OdomState &istate, const StateMode &imode) {
+  std::lock_guard<CrossplatformMutex> lock(writeMutex);
+  odometry->setState(istate, imode);
+  publish();
+}
+
+std::shared_ptr<ReadOnlyChassisModel> PublishedOdometry::getModel() {
+  return odometry->getModel();
+}
+
+ChassisScales PublishedOdometry::getScales() {
+  return odometry->getScales();
+}
+
+void PublishedOdometry::publish() {
+  published.store({odometry->getState(StateMode::FRAME_TRANSFORMATION),
+                   odometry->getState(StateMode::CARTESIAN)});
+}
+} // namespace okapi
@@ -0,0 +1,222 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/routine/action.hpp"
+
+namespace okapi {
+Action::Status Action::tick(const QTime inow) {
+  if (done) {
+    return Status::done;
+  }
+
+  if (!started) {
+    started = true;
+    start(inow);
+  }
+
+  done = step(inow) == Status::done;
+  return done ? Status::done : Status::running;
+}
+
+void Action::cancel() {
+  if (started && !done) {
+    stop();
+  }
+  done = true;
+}
+
+bool Action::isDone() const {
+  return done;
+}
+
+void Action::start(QTime) {
+}
+
+void Action::stop() {
+}
+
+namespace {
+class CallAction : public Action {
+  public:
+  explicit CallAction(std::function<void()> ifunction) : function(std::move(ifunction)) {
+  }
+
+  protected:
+  std::function<void()> function;
+
+  Status step(QTime) override {
+    function();
+    return Status::done;
+  }
+};
+
+class TaskAction : public Action {
+  public:
+  explicit TaskAction(std::function<bool(QTime)> istep) : stepFunction(std::move(istep)) {
+  }
+
+  protected:
+  std::function<bool(QTime)> stepFunction;
+
+  Status step(const QTime inow) override {
+    return stepFunction(inow) ? Status::done : Status::running;
+  }
+};
+
+class WaitForAction : public Action {
+  public:
+  explicit WaitForAction(const QTime itime) : duration(itime) {
+  }
+
+  protected:
+  QTime duration;
+  QTime startTime{0_ms};
+
+  void start(const QTime inow) override {
+    startTime = inow;
+  }
+
+  Status step(const QTime inow) override {
+    return inow - startTime >= duration ? Status::done : Status::running;
+  }
+};
+
+class WaitUntilAction : public Action {
+  public:
+  explicit WaitUntilAction(std::function<bool()> icondition) : condition(std::move(icondition)) {
+  }
+
+  protected:
+  std::function<bool()> condition;
+
+  Status step(QTime) override {
+    return condition() ? Status::done : Status::running;
+  }
+};
+
+class TimeoutAction : public Action {
+  public:
+  TimeoutAction(ActionPtr iaction, const QTime itimeout)
+    : action(std::move(iaction)), limit(itimeout) {
+  }
+
+  protected:
+  ActionPtr action;
+  QTime limit;
+  QTime startTime{0_ms};
+
+  void start(const QTime inow) override {
+    startTime = inow;
+  }
+
+  Status step(const QTime inow) override {
+    if (action->tick(inow) == Status::done) {
+      return Status::done;
+    }
+
+    if (inow - startTime >= limit) {
+      action->cancel();
+      return Status::done;
+    }
+
+    return Status::running;
+  }
+
+  void stop() override {
+    action->cancel();
+  }
+};
+
+class SequenceAction : public Action {
+  public:
+  explicit SequenceAction(std::vector<ActionPtr> iactions) : actions(std::move(iactions)) {
+  }
+
+  protected:
+  std::vector<ActionPtr> actions;
+  std::size_t current{0};
+
+  Status step(const QTime inow) override {
+    while (current < actions.size() && actions[current]->tick(inow) == Status::done) {
+      current++;
+    }
+
+    return current < actions.size() ? Status::running : Status::done;
+  }
+
+  void stop() override {
+    if (current < actions.size()) {
+      actions[current]->cancel();
+    }
+  }
+};
+
+class ParallelAction : public Action {
+  public:
+  ParallelAction(std::vector<ActionPtr> iactions, const bool iisRace)
+    : actions(std::move(iactions)), isRace(iisRace) {
+  }
+
+  protected:
+  std::vector<ActionPtr> actions;
+  bool isRace;
+
+  Status step(const QTime inow) override {
+    bool allDone = true;
+    bool anyDone = false;
+    for (auto &action : actions) {
+      const bool actionDone = action->tick(inow) == Status::done;
+      allDone = allDone && actionDone;
+      anyDone = anyDone || actionDone;
+    }
+
+    if (isRace && anyDone) {
+      stop();
+      return Status::done;
+    }
+
+    return allDone ? Status::done : Status::running;
+  }
+
+  void stop() override {
+    for (auto &action : actions) {
+      action->cancel();
+    }
+  }
+};
+} // namespace
+
+ActionPtr Actions::call(std::function<void()> ifunction) {
+  return std::make_unique<CallAction>(std::move(ifunction));
+}
+
+ActionPtr Actions::task(std::function<bool(QTime)> istep) {
+  return std::make_unique<TaskAction>(std::move(istep));
+}
+
+ActionPtr Actions::waitFor(const QTime itime) {
+  return std::make_unique<WaitForAction>(itime);
+}
+
+ActionPtr Actions::waitUntil(std::function<bool()> icondition) {
+  return std::make_unique<WaitUntilAction>(std::move(icondition));
+}
+
+ActionPtr Actions::timeout(ActionPtr iaction, const QTime itimeout) {
+  return std::make_unique<TimeoutAction>(std::move(iaction), itimeout);
+}
+
+ActionPtr Actions::sequence(std::vector<ActionPtr> iactions) {
+  return std::make_unique<SequenceAction>(std::move(iactions));
+}
+
+ActionPtr Actions::parallel(std::vector<ActionPtr> iactions) {
+  return std::make_unique<ParallelAction>(std::move(iactions), false);
+}
+
+ActionPtr Actions::race(std::vector<ActionPtr> iactions) {
+  return std::make_unique<ParallelAction>(std::move(iactions), true);
+}
+} // namespace okapi
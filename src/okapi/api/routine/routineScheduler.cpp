@@ -0,0 +1,75 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/routine/routineScheduler.hpp"
+#include <mutex>
+
+namespace okapi {
+bool RoutineHandle::isDone() const {
+  return done.load(std::memory_order_acquire);
+}
+
+void RoutineHandle::cancel() {
+  cancelRequested.store(true, std::memory_order_release);
+}
+
+RoutineScheduler::RoutineScheduler(const TimeUtil &itimeUtil, std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)), timeUtil(itimeUtil), timer(itimeUtil.getTimer()) {
+}
+
+std::shared_ptr<RoutineHandle> RoutineScheduler::add(ActionPtr iroutine) {
+  auto handle = std::make_shared<RoutineHandle>();
+
+  std::lock_guard<CrossplatformMutex> lock(pendingMutex);
+  pending.push_back({std::move(iroutine), handle});
+  numRunning++;
+  return handle;
+}
+
+void RoutineScheduler::tick() {
+  {
+    std::lock_guard<CrossplatformMutex> lock(pendingMutex);
+    for (auto &entry : pending) {
+      running.push_back(std::move(entry));
+    }
+    pending.clear();
+  }
+
+  const QTime now = timer->millis();
+  std::size_t kept = 0;
+  for (auto &entry : running) {
+    if (entry.handle->cancelRequested.load(std::memory_order_acquire)) {
+      entry.routine->cancel();
+      LOG_INFO_S("RoutineScheduler: Cancelled a routine");
+    } else {
+      entry.routine->tick(now);
+    }
+
+    if (entry.routine->isDone()) {
+      entry.handle->done.store(true, std::memory_order_release);
+      numRunning--;
+    } else {
+      // Compact in place so routines keep the order they were added in
+      if (&running[kept] != &entry) {
+        running[kept] = std::move(entry);
+      }
+      kept++;
+    }
+  }
+  running.resize(kept);
+}
+
+void RoutineScheduler::runUntilDone(const QTime iperiod) {
+  auto rate = timeUtil.getRate();
+  while (getNumRunning() > 0) {
+    tick();
+    rate->delayUntil(iperiod);
+  }
+}
+
+std::size_t RoutineScheduler::getNumRunning() const {
+  return numRunning.load(std::memory_order_acquire);
+}
+} // namespace okapi
@@ -0,0 +1,335 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/asyncLogSink.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace okapi {
+namespace {
+/**
+ * @return A key unique to the calling task.
+ */
+const void *currentTaskKey() noexcept {
+#ifdef THREADS_STD
+  static thread_local const char key = 0;
+  return &key;
+#else
+  return pros::c::task_get_current();
+#endif
+}
+
+const char *levelName(const std::uint8_t ilevel) {
+  switch (ilevel) {
+  case 4:
+    return "DEBUG";
+  case 3:
+    return "INFO";
+  case 2:
+    return "WARN";
+  default:
+    return "ERROR";
+  }
+}
+
+/**
+ * Writes each value's bytes in turn. Both the brain and hosts are little endian.
+ */
+template <typename... Ts> void putBytes(FILE *ifile, const Ts &... ivalues) {
+  (fwrite(&ivalues, sizeof(ivalues), 1, ifile), ...);
+}
+
+std::uint32_t roundUpToPowerOfTwo(const std::size_t ivalue) {
+  std::uint32_t out = 1;
+  while (out < ivalue && out < 1u << 16) {
+    out <<= 1;
+  }
+  return out;
+}
+} // namespace
+
+AsyncLogSink::AsyncLogSink(std::unique_ptr<AbstractTimer> itimer,
+                           std::unique_ptr<AbstractRate> irate,
+                           FILE *ifile,
+                           const std::size_t iringCapacity,
+                           const QTime idrainPeriod,
+                           const Mode imode)
+  : timer(std::move(itimer)),
+    rate(std::move(irate)),
+    file(ifile),
+    capacity(roundUpToPowerOfTwo(iringCapacity)),
+    drainPeriod(idrainPeriod),
+    mode(imode) {
+  if (iringCapacity == 0 || iringCapacity > 1u << 16) {
+    throw std::invalid_argument(
+      "AsyncLogSink: The ring capacity must be between 1 and 65536 records.");
+  }
+
+  if (drainPeriod <= 0_ms) {
+    throw std::invalid_argument("AsyncLogSink: The drain period must be greater than zero.");
+  }
+
+  if (mode == Mode::binary && file) {
+    fwrite(binaryMagic, 1, sizeof(binaryMagic) - 1, file);
+    fwrite(&binaryVersion, 1, 1, file);
+  }
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  dtorCalled.store(true, std::memory_order_release);
+#ifdef THREADS_STD
+  delete task;
+#else
+  // Deleting the task in the middle of a drain would leave the mutex taken
+  drainMutex.lock();
+  delete task;
+  drainMutex.unlock();
+#endif
+
+  drain();
+  if (file) {
+    fclose(file);
+  }
+}
+
+AsyncLogSink::Ring *AsyncLogSink::findRing() noexcept {
+  const void *key = currentTaskKey();
+  for (auto &ring : rings) {
+    const void *owner = ring.owner.load(std::memory_order_acquire);
+    if (owner == key) {
+      return &ring;
+    }
+
+    if (owner == nullptr) {
+      // Rings are claimed in order, so the first free one means this task has none yet
+      const void *expected = nullptr;
+      if (ring.owner.compare_exchange_strong(expected, key, std::memory_order_acq_rel)) {
+        ring.records.reset(new (std::nothrow) LogRecord[capacity]);
+        if (!ring.records) {
+          return nullptr;
+        }
+
+#ifdef THREADS_STD
+        std::snprintf(ring.name, sizeof(ring.name), "%s", CrossplatformThread::getName().c_str());
+#else
+        std::snprintf(ring.name, sizeof(ring.name), "%s", pros::c::task_get_name(nullptr));
+#endif
+        ring.ready.store(true, std::memory_order_release);
+        return &ring;
+      }
+
+      if (expected == key) {
+        return &ring;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+bool AsyncLogSink::append(const std::uint8_t ilevel,
+                          const std::uint16_t iformatId,
+                          const void *ipayload,
+                          const std::size_t isize) noexcept {
+  Ring *ring = findRing();
+  if (!ring || !ring->ready.load(std::memory_order_acquire)) {
+    unownedDropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  const std::size_t count = std::max<std::size_t>(
+    1, (isize + LogRecord::payloadSize - 1) / LogRecord::payloadSize);
+  const std::uint32_t head = ring->head.load(std::memory_order_relaxed);
+  const std::uint32_t tail = ring->tail.load(std::memory_order_acquire);
+  if (count > capacity - (head - tail)) {
+    ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  const std::uint32_t time = now();
+  const auto *payload = static_cast<const std::uint8_t *>(ipayload);
+  std::size_t remaining = isize;
+  for (std::size_t i = 0; i < count; i++) {
+    auto &record = ring->records[(head + i) & (capacity - 1)];
+    const std::size_t size = std::min(remaining, LogRecord::payloadSize);
+    record.time = time;
+    record.formatId = iformatId;
+    record.level = ilevel;
+    record.continues = i + 1 < count;
+    record.size = static_cast<std::uint8_t>(size);
+    std::memcpy(record.payload, payload, size);
+    payload += size;
+    remaining -= size;
+  }
+
+  // Publish every record of the message at once so the drain never sees part of it
+  ring->head.store(head + static_cast<std::uint32_t>(count), std::memory_order_release);
+  return true;
+}
+
+void AsyncLogSink::drain() {
+  std::lock_guard<CrossplatformMutex> lock(drainMutex);
+  if (!file) {
+    return;
+  }
+
+  for (std::size_t i = 0; i < rings.size(); i++) {
+    auto &ring = rings[i];
+    if (!ring.ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+
+    std::uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    const std::uint32_t head = ring.head.load(std::memory_order_acquire);
+    while (tail != head) {
+      const LogRecord first = ring.records[tail & (capacity - 1)];
+      message.clear();
+
+      bool continues = true;
+      while (continues) {
+        const auto &record = ring.records[tail & (capacity - 1)];
+        message.append(reinterpret_cast<const char *>(record.payload), record.size);
+        continues = record.continues;
+        tail++;
+      }
+
+      // Hand the records back before writing so a busy task can reuse them
+      ring.tail.store(tail, std::memory_order_release);
+
+      if (mode == Mode::text) {
+        writeText(i, first);
+      } else {
+        writeBinary(i, first);
+      }
+    }
+
+    const std::uint32_t dropped = ring.dropped.load(std::memory_order_relaxed);
+    if (dropped != ring.reportedDropped) {
+      writeDropped(i, ring.name, dropped - ring.reportedDropped);
+      ring.reportedDropped = dropped;
+    }
+  }
+
+  const std::uint32_t unowned = unownedDropped.load(std::memory_order_relaxed);
+  if (unowned != reportedUnownedDropped) {
+    writeDropped(unownedTask, "no ring", unowned - reportedUnownedDropped);
+    reportedUnownedDropped = unowned;
+  }
+
+  fflush(file);
+}
+
+void AsyncLogSink::writeText(const std::size_t iring, const LogRecord &ifirst) {
+  if (ifirst.formatId == 0) {
+    // The Logger formatted the line already, timestamp and newline included
+    fwrite(message.data(), 1, message.size(), file);
+    return;
+  }
+
+  line.clear();
+  if (const auto *entry = LogFormat::find(ifirst.formatId)) {
+    LogFormat::format(entry->format,
+                      entry->signature,
+                      reinterpret_cast<const std::uint8_t *>(message.data()),
+                      message.size(),
+                      line);
+  } else {
+    line.append("<unknown format>");
+  }
+
+  fprintf(file,
+          "%ld (%s) %s: %s\n",
+          static_cast<long>(ifirst.time / 1000),
+          rings[iring].name,
+          levelName(ifirst.level),
+          line.c_str());
+}
+
+void AsyncLogSink::writeBinary(const std::size_t iring, const LogRecord &ifirst) {
+  auto &ring = rings[iring];
+  if (!ring.nameWritten) {
+    const auto length = static_cast<std::uint8_t>(std::strlen(ring.name));
+    putBytes(file, Frame::task, static_cast<std::uint8_t>(iring), length);
+    fwrite(ring.name, 1, length, file);
+    ring.nameWritten = true;
+  }
+
+  // Ids are given out in order, so every format up to this one might not be written yet
+  while (formatsWritten < ifirst.formatId) {
+    const auto *entry = LogFormat::find(++formatsWritten);
+    const auto signatureLength = static_cast<std::uint8_t>(std::strlen(entry->signature));
+    const auto formatLength = static_cast<std::uint16_t>(std::strlen(entry->format));
+    putBytes(file, Frame::format, formatsWritten, signatureLength);
+    fwrite(entry->signature, 1, signatureLength, file);
+    putBytes(file, formatLength);
+    fwrite(entry->format, 1, formatLength, file);
+  }
+
+  putBytes(file,
+           Frame::message,
+           static_cast<std::uint8_t>(iring),
+           ifirst.time,
+           ifirst.level,
+           ifirst.formatId,
+           static_cast<std::uint16_t>(message.size()));
+  fwrite(message.data(), 1, message.size(), file);
+}
+
+void AsyncLogSink::writeDropped(const std::size_t iring,
+                                const char *itaskName,
+                                const std::uint32_t icount) {
+  const std::uint32_t time = now();
+  if (mode == Mode::text) {
+    fprintf(file,
+            "%ld (%s) WARN: AsyncLogSink: Dropped %lu messages\n",
+            static_cast<long>(time / 1000),
+            itaskName,
+            static_cast<unsigned long>(icount));
+  } else {
+    putBytes(file, Frame::dropped, static_cast<std::uint8_t>(iring), time, icount);
+  }
+}
+
+std::uint32_t AsyncLogSink::now() const {
+  return static_cast<std::uint32_t>(std::llround(timer->millis().convert(millisecond) * 1000));
+}
+
+std::uint32_t AsyncLogSink::getDropped() const {
+  std::uint32_t dropped = unownedDropped.load(std::memory_order_relaxed);
+  for (const auto &ring : rings) {
+    dropped += ring.dropped.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+void AsyncLogSink::startThread() {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "AsyncLogSink");
+#ifndef THREADS_STD
+    pros::c::task_set_priority(task->thread, TASK_PRIORITY_MIN + 1);
+#endif
+  }
+}
+
+CrossplatformThread *AsyncLogSink::getThread() const {
+  return task;
+}
+
+void AsyncLogSink::trampoline(void *context) {
+  if (context) {
+    static_cast<AsyncLogSink *>(context)->loop();
+  }
+}
+
+void AsyncLogSink::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    drain();
+    rate->delayUntil(drainPeriod);
+  }
+}
+} // namespace okapi
@@ -0,0 +1,104 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/asyncLogger.hpp"
+#include <cstdio>
+#include <new>
+
+namespace okapi {
+namespace {
+std::array<std::atomic<const AsyncLogger *>, AsyncLogger::maxLoggers> loggers{};
+
+struct StreamCookie {
+  std::shared_ptr<AsyncLogSink> sink;
+};
+
+ssize_t writeStream(void *icookie, const char *ibuffer, const size_t isize) {
+  static_cast<StreamCookie *>(icookie)->sink->append(0, 0, ibuffer, isize);
+
+  // A dropped line is counted by the sink, so report it written rather than fail the stream
+  return static_cast<ssize_t>(isize);
+}
+
+int closeStream(void *icookie) {
+  delete static_cast<StreamCookie *>(icookie);
+  return 0;
+}
+} // namespace
+
+AsyncLogger::AsyncLogger(const TimeUtil &itimeUtil,
+                         std::shared_ptr<AsyncLogSink> isink,
+                         const LogLevel &ilevel)
+  : Logger(itimeUtil.getTimer(), openStream(isink), ilevel), sink(std::move(isink)) {
+  for (auto &entry : loggers) {
+    const AsyncLogger *expected = nullptr;
+    if (entry.compare_exchange_strong(expected, this, std::memory_order_acq_rel)) {
+      break;
+    }
+  }
+}
+
+AsyncLogger::~AsyncLogger() {
+  for (auto &entry : loggers) {
+    const AsyncLogger *expected = this;
+    if (entry.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+      break;
+    }
+  }
+}
+
+std::shared_ptr<AsyncLogSink> AsyncLogger::getSink() const {
+  return sink;
+}
+
+const AsyncLogger *AsyncLogger::find(const Logger *ilogger) noexcept {
+  for (const auto &entry : loggers) {
+    const AsyncLogger *logger = entry.load(std::memory_order_acquire);
+    if (logger && static_cast<const Logger *>(logger) == ilogger) {
+      return logger;
+    }
+  }
+  return nullptr;
+}
+
+bool AsyncLogger::isEnabled(const Logger &ilogger, const LogLevel ilevel) noexcept {
+  switch (ilevel) {
+  case LogLevel::debug:
+    return ilogger.isDebugLevelEnabled();
+  case LogLevel::info:
+    return ilogger.isInfoLevelEnabled();
+  case LogLevel::warn:
+    return ilogger.isWarnLevelEnabled();
+  case LogLevel::error:
+    return ilogger.isErrorLevelEnabled();
+  default:
+    return false;
+  }
+}
+
+FILE *AsyncLogger::openStream(const std::shared_ptr<AsyncLogSink> &isink) {
+  if (!isink) {
+    return nullptr;
+  }
+
+  auto *cookie = new (std::nothrow) StreamCookie{isink};
+  if (!cookie) {
+    return nullptr;
+  }
+
+  cookie_io_functions_t functions{};
+  functions.write = writeStream;
+  functions.close = closeStream;
+  FILE *stream = fopencookie(cookie, "w", functions);
+  if (!stream) {
+    delete cookie;
+    return nullptr;
+  }
+
+  // Unbuffered, so each line the Logger prints reaches the sink in one write
+  setvbuf(stream, nullptr, _IONBF, 0);
+  return stream;
+}
+} // namespace okapi
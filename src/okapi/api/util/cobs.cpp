@@ -0,0 +1,67 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/cobs.hpp"
+
+namespace okapi {
+namespace cobs {
+std::size_t encode(const std::uint8_t *idata, const std::size_t isize, std::uint8_t *oout) {
+  std::size_t out = 1;
+  std::size_t codePos = 0;
+  std::uint8_t code = 1;
+
+  for (std::size_t i = 0; i < isize; i++) {
+    if (idata[i] != 0) {
+      oout[out++] = idata[i];
+      code++;
+    }
+
+    // A zero, or a full block of 254 nonzero bytes, ends the current block
+    if (idata[i] == 0 || code == 0xFF) {
+      oout[codePos] = code;
+      code = 1;
+      codePos = out++;
+    }
+  }
+
+  oout[codePos] = code;
+  return out;
+}
+
+bool decode(const std::uint8_t *idata, const std::size_t isize, std::vector<std::uint8_t> &oout) {
+  oout.clear();
+
+  std::size_t i = 0;
+  while (i < isize) {
+    const std::uint8_t code = idata[i++];
+    if (code == 0 || i + code - 1 > isize) {
+      return false;
+    }
+
+    oout.insert(oout.end(), idata + i, idata + i + code - 1);
+    i += code - 1;
+
+    // A full block has no zero after it, and neither does the last block
+    if (code != 0xFF && i < isize) {
+      oout.push_back(0);
+    }
+  }
+
+  return true;
+}
+
+std::uint16_t crc16(const std::uint8_t *idata, const std::size_t isize) {
+  std::uint16_t crc = 0xFFFF;
+  for (std::size_t i = 0; i < isize; i++) {
+    crc ^= static_cast<std::uint16_t>(idata[i]) << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = crc & 0x8000 ? static_cast<std::uint16_t>((crc << 1) ^ 0x1021)
+                         : static_cast<std::uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+} // namespace cobs
+} // namespace okapi
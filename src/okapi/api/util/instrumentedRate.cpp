@@ -0,0 +1,35 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/instrumentedRate.hpp"
+
+namespace okapi {
+InstrumentedRate::InstrumentedRate(std::unique_ptr<AbstractRate> irate,
+                                   std::shared_ptr<LoopTiming> itiming)
+  : rate(std::move(irate)), timing(std::move(itiming)) {
+}
+
+void InstrumentedRate::delay(const QFrequency ihz) {
+  timing->end((1.0 / ihz.convert(Hz)) * second);
+  rate->delay(ihz);
+  timing->begin();
+}
+
+void InstrumentedRate::delayUntil(const QTime itime) {
+  timing->end(itime);
+  rate->delayUntil(itime);
+  timing->begin();
+}
+
+void InstrumentedRate::delayUntil(const uint32_t ims) {
+  timing->end(ims * millisecond);
+  rate->delayUntil(ims);
+  timing->begin();
+}
+
+std::shared_ptr<LoopTiming> InstrumentedRate::getTiming() const {
+  return timing;
+}
+} // namespace okapi
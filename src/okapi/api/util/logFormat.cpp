@@ -0,0 +1,323 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/logFormat.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace okapi {
+namespace {
+std::array<LogFormat::Entry, LogFormat::maxFormats> &formats() {
+  static std::array<LogFormat::Entry, LogFormat::maxFormats> entries{};
+  return entries;
+}
+
+std::atomic<std::uint16_t> formatCount{0};
+
+CrossplatformMutex &formatsMutex() {
+  static CrossplatformMutex mutex;
+  return mutex;
+}
+
+/**
+ * One stored argument, read back in whichever form a conversion wants.
+ */
+struct Value {
+  bool present{false};
+  char tag{0};
+  std::int64_t integer{0};
+  std::uint64_t unsignedInteger{0};
+  double floating{0};
+  std::string_view text;
+
+  long long asInteger() const {
+    switch (tag) {
+    case 'I':
+    case 'L':
+      return static_cast<long long>(unsignedInteger);
+    case 'f':
+    case 'd':
+      return static_cast<long long>(floating);
+    default:
+      return integer;
+    }
+  }
+
+  unsigned long long asUnsigned() const {
+    return tag == 'I' || tag == 'L' ? unsignedInteger
+                                    : static_cast<unsigned long long>(asInteger());
+  }
+
+  double asDouble() const {
+    switch (tag) {
+    case 'f':
+    case 'd':
+      return floating;
+    case 'I':
+    case 'L':
+      return static_cast<double>(unsignedInteger);
+    default:
+      return static_cast<double>(integer);
+    }
+  }
+};
+
+/**
+ * Writes text to a fixed buffer, counting what does not fit the way snprintf does.
+ */
+struct TextWriter {
+  char *out;
+  std::size_t capacity;
+  std::size_t length{0};
+
+  void put(const char ic) noexcept {
+    if (length + 1 < capacity) {
+      out[length] = ic;
+    }
+    length++;
+  }
+
+  void put(const char *itext) noexcept {
+    for (; *itext != '\0'; itext++) {
+      put(*itext);
+    }
+  }
+};
+
+template <typename T>
+bool read(const std::uint8_t *ipayload, const std::size_t isize, std::size_t &iopos, T &ovalue) {
+  if (iopos + sizeof(T) > isize) {
+    return false;
+  }
+  std::memcpy(&ovalue, ipayload + iopos, sizeof(T));
+  iopos += sizeof(T);
+  return true;
+}
+
+Value readValue(const char itag,
+                const std::uint8_t *ipayload,
+                const std::size_t isize,
+                std::size_t &iopos) {
+  Value value;
+  value.tag = itag;
+  switch (itag) {
+  case 'b': {
+    std::uint8_t stored;
+    value.present = read(ipayload, isize, iopos, stored);
+    value.integer = stored;
+    break;
+  }
+  case 'i': {
+    std::int32_t stored;
+    value.present = read(ipayload, isize, iopos, stored);
+    value.integer = stored;
+    break;
+  }
+  case 'l':
+    value.present = read(ipayload, isize, iopos, value.integer);
+    break;
+  case 'I': {
+    std::uint32_t stored;
+    value.present = read(ipayload, isize, iopos, stored);
+    value.unsignedInteger = stored;
+    break;
+  }
+  case 'L':
+    value.present = read(ipayload, isize, iopos, value.unsignedInteger);
+    break;
+  case 'f': {
+    float stored;
+    value.present = read(ipayload, isize, iopos, stored);
+    value.floating = stored;
+    break;
+  }
+  case 'd':
+    value.present = read(ipayload, isize, iopos, value.floating);
+    break;
+  case 's': {
+    std::uint8_t length;
+    if (read(ipayload, isize, iopos, length) && iopos + length <= isize) {
+      value.text = std::string_view(reinterpret_cast<const char *>(ipayload + iopos), length);
+      iopos += length;
+      value.present = true;
+    }
+    break;
+  }
+  default:
+    break;
+  }
+  return value;
+}
+} // namespace
+
+std::uint16_t LogFormat::intern(const char *iformat, const char *isignature) {
+  std::lock_guard<CrossplatformMutex> lock(formatsMutex());
+  auto &entries = formats();
+  const std::uint16_t existing = formatCount.load(std::memory_order_relaxed);
+
+  // The same statement in different template instantiations shares one id
+  for (std::uint16_t i = 0; i < existing; i++) {
+    if (std::strcmp(entries[i].format, iformat) == 0 &&
+        std::strcmp(entries[i].signature, isignature) == 0) {
+      return i + 1;
+    }
+  }
+
+  if (existing == maxFormats) {
+    return 0;
+  }
+
+  entries[existing] = Entry{iformat, isignature};
+  formatCount.store(existing + 1, std::memory_order_release);
+  return existing + 1;
+}
+
+const LogFormat::Entry *LogFormat::find(const std::uint16_t iid) {
+  if (iid == 0 || iid > formatCount.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  return &formats()[iid - 1];
+}
+
+std::uint16_t LogFormat::count() {
+  return formatCount.load(std::memory_order_acquire);
+}
+
+std::size_t LogFormat::format(const char *iformat,
+                              const char *isignature,
+                              const std::uint8_t *ipayload,
+                              const std::size_t isize,
+                              char *obuffer,
+                              const std::size_t icapacity) noexcept {
+  TextWriter out{obuffer, icapacity};
+  std::size_t pos = 0;
+  const char *nextTag = isignature;
+  char buffer[320];
+
+  for (const char *c = iformat; *c != '\0'; c++) {
+    if (*c != '%') {
+      out.put(*c);
+      continue;
+    }
+
+    if (c[1] == '%') {
+      out.put('%');
+      c++;
+      continue;
+    }
+
+    // Copy the flags, width, and precision, and drop the length since the argument's own type is
+    // used instead. Room is left for the longest length and conversion appended below.
+    char spec[24] = "%";
+    std::size_t specLength = 1;
+    const char *end = c + 1;
+    for (; *end != '\0' && std::strchr("-+ #0123456789.", *end); end++) {
+      if (specLength < sizeof(spec) - 5) {
+        spec[specLength++] = *end;
+      }
+    }
+    while (*end != '\0' && std::strchr("hlLqjzt", *end)) {
+      end++;
+    }
+
+    const char conversion = *end;
+    if (conversion == '\0') {
+      out.put(c);
+      break;
+    }
+    c = end;
+
+    const Value value =
+      *nextTag != '\0' ? readValue(*nextTag++, ipayload, isize, pos) : Value{};
+    if (!value.present) {
+      out.put('?');
+      continue;
+    }
+
+    switch (conversion) {
+    case 'd':
+    case 'i':
+      std::strcpy(spec + specLength, "lld");
+      std::snprintf(buffer, sizeof(buffer), spec, value.asInteger());
+      break;
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+      std::strcpy(spec + specLength, "ll");
+      spec[specLength + 2] = conversion;
+      spec[specLength + 3] = '\0';
+      std::snprintf(buffer, sizeof(buffer), spec, value.asUnsigned());
+      break;
+    case 'c':
+      std::strcpy(spec + specLength, "c");
+      std::snprintf(buffer, sizeof(buffer), spec, static_cast<int>(value.asInteger()));
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      spec[specLength] = conversion;
+      spec[specLength + 1] = '\0';
+      std::snprintf(buffer, sizeof(buffer), spec, value.asDouble());
+      break;
+    default:
+      if (value.tag == 's') {
+        // The text is not nul terminated, so its length stands in for any precision
+        if (const char *precision = std::strchr(spec, '.')) {
+          specLength = static_cast<std::size_t>(precision - spec);
+        }
+        std::strcpy(spec + specLength, ".*s");
+        std::snprintf(buffer,
+                      sizeof(buffer),
+                      spec,
+                      static_cast<int>(value.text.size()),
+                      value.text.data());
+      } else if (value.tag == 'f' || value.tag == 'd') {
+        std::snprintf(buffer, sizeof(buffer), "%g", value.asDouble());
+      } else if (value.tag == 'b') {
+        std::snprintf(buffer, sizeof(buffer), "%s", value.integer ? "true" : "false");
+      } else {
+        std::snprintf(buffer, sizeof(buffer), "%lld", value.asInteger());
+      }
+      break;
+    }
+    out.put(buffer);
+  }
+
+  if (icapacity > 0) {
+    obuffer[std::min(out.length, icapacity - 1)] = '\0';
+  }
+  return out.length;
+}
+
+void LogFormat::format(const char *iformat,
+                       const char *isignature,
+                       const std::uint8_t *ipayload,
+                       const std::size_t isize,
+                       std::string &oout) {
+  char buffer[256];
+  const std::size_t length = format(iformat, isignature, ipayload, isize, buffer, sizeof(buffer));
+  if (length < sizeof(buffer)) {
+    oout.append(buffer, length);
+    return;
+  }
+
+  // Too long for the buffer, so format it again straight into the string
+  const std::size_t start = oout.size();
+  oout.resize(start + length + 1);
+  format(iformat, isignature, ipayload, isize, &oout[start], length + 1);
+  oout.resize(start + length);
+}
+} // namespace okapi
@@ -0,0 +1,181 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/loopTiming.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+namespace {
+QTime fromMicros(const double imicros) {
+  return imicros / 1000.0 * millisecond;
+}
+} // namespace
+
+QTime LoopTiming::Histogram::mean() const {
+  return count > 0 ? fromMicros(static_cast<double>(total) / count) : 0_ms;
+}
+
+QTime LoopTiming::Histogram::percentile(const double ifraction) const {
+  if (count == 0) {
+    return 0_ms;
+  }
+
+  const auto rank = static_cast<std::uint32_t>(std::ceil(ifraction * count));
+  std::uint32_t seen = 0;
+  for (std::size_t i = 0; i < numBuckets; i++) {
+    seen += buckets[i];
+    if (seen >= rank && seen > 0) {
+      // The top bucket's bound is past the largest sample, so use the sample instead
+      return std::min(bucketUpperBound(i), fromMicros(max));
+    }
+  }
+  return fromMicros(max);
+}
+
+QTime LoopTiming::Histogram::bucketUpperBound(const std::size_t ibucket) {
+  if (ibucket < bucketsPerDoubling) {
+    return fromMicros(ibucket);
+  }
+
+  // The inverse of bucketOf(): the top two bits below the leading one pick the bucket
+  const std::size_t exponent = ibucket / bucketsPerDoubling + 1;
+  const std::uint64_t next = bucketsPerDoubling + ibucket % bucketsPerDoubling + 1;
+  return fromMicros(static_cast<double>((next << (exponent - 2)) - 1));
+}
+
+std::size_t LoopTiming::Histogram::bucketOf(const std::uint32_t imicros) noexcept {
+  if (imicros < bucketsPerDoubling) {
+    return imicros;
+  }
+
+  const std::size_t exponent = 31 - static_cast<std::size_t>(__builtin_clz(imicros));
+  const std::size_t fraction = (imicros >> (exponent - 2)) & (bucketsPerDoubling - 1);
+  return (exponent - 1) * bucketsPerDoubling + fraction;
+}
+
+void LoopTiming::AtomicHistogram::record(const std::uint32_t imicros) noexcept {
+  auto &bucket = buckets[Histogram::bucketOf(imicros)];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  total.store(total.load(std::memory_order_relaxed) + imicros, std::memory_order_relaxed);
+  if (imicros > max.load(std::memory_order_relaxed)) {
+    max.store(imicros, std::memory_order_relaxed);
+  }
+}
+
+LoopTiming::Histogram LoopTiming::AtomicHistogram::load() const {
+  Histogram out;
+  for (std::size_t i = 0; i < numBuckets; i++) {
+    out.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+  }
+  out.count = count.load(std::memory_order_relaxed);
+  out.max = max.load(std::memory_order_relaxed);
+  out.total = total.load(std::memory_order_relaxed);
+  return out;
+}
+
+void LoopTiming::AtomicHistogram::clear() noexcept {
+  for (auto &bucket : buckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count.store(0, std::memory_order_relaxed);
+  max.store(0, std::memory_order_relaxed);
+  total.store(0, std::memory_order_relaxed);
+}
+
+LoopTiming::LoopTiming(std::unique_ptr<AbstractTimer> itimer, std::string iname)
+  : timer(std::move(itimer)), name(std::move(iname)) {
+}
+
+LoopTiming::~LoopTiming() = default;
+
+void LoopTiming::begin() {
+  const std::uint32_t time = now();
+
+  if (resetRequested.exchange(false, std::memory_order_acquire)) {
+    period.clear();
+    execution.clear();
+    overruns.store(0, std::memory_order_relaxed);
+    started = false;
+  }
+
+  if (started) {
+    period.record(time - lastBegin);
+  }
+  lastBegin = time;
+  started = true;
+}
+
+void LoopTiming::end(const QTime iperiod) {
+  if (!started) {
+    return;
+  }
+
+  const std::uint32_t elapsed = now() - lastBegin;
+  execution.record(elapsed);
+  if (elapsed > iperiod.convert(millisecond) * 1000) {
+    overruns.store(overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+}
+
+void LoopTiming::stop() {
+  started = false;
+}
+
+LoopTiming::Stats LoopTiming::getStats() const {
+  Stats out;
+  out.period = period.load();
+  out.execution = execution.load();
+  out.overruns = overruns.load(std::memory_order_relaxed);
+  return out;
+}
+
+void LoopTiming::reset() {
+  resetRequested.store(true, std::memory_order_release);
+}
+
+void LoopTiming::print(FILE *ifile) const {
+  const Stats stats = getStats();
+  std::fprintf(ifile,
+               "%s: %lu iterations, %lu overruns\n",
+               name.c_str(),
+               static_cast<unsigned long>(stats.execution.count),
+               static_cast<unsigned long>(stats.overruns));
+  std::fprintf(ifile, "  %-8s %12s %12s\n", "(ms)", "period", "execution");
+
+  const auto row = [&](const char *ilabel, const QTime iperiod, const QTime iexecution) {
+    std::fprintf(ifile,
+                 "  %-8s %12.3f %12.3f\n",
+                 ilabel,
+                 iperiod.convert(millisecond),
+                 iexecution.convert(millisecond));
+  };
+  row("mean", stats.period.mean(), stats.execution.mean());
+  row("p50", stats.period.percentile(0.5), stats.execution.percentile(0.5));
+  row("p99", stats.period.percentile(0.99), stats.execution.percentile(0.99));
+  row("max", fromMicros(stats.period.max), fromMicros(stats.execution.max));
+
+  for (std::size_t i = 0; i < numBuckets; i++) {
+    if (stats.period.buckets[i] > 0 || stats.execution.buckets[i] > 0) {
+      std::fprintf(ifile,
+                   "  <=%-6.3f %12lu %12lu\n",
+                   Histogram::bucketUpperBound(i).convert(millisecond),
+                   static_cast<unsigned long>(stats.period.buckets[i]),
+                   static_cast<unsigned long>(stats.execution.buckets[i]));
+    }
+  }
+  std::fflush(ifile);
+}
+
+const std::string &LoopTiming::getName() const {
+  return name;
+}
+
+std::uint32_t LoopTiming::now() const {
+  return static_cast<std::uint32_t>(
+    static_cast<std::uint64_t>(timer->millis().convert(millisecond) * 1000));
+}
+} // namespace okapi
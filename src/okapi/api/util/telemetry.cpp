@@ -0,0 +1,215 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/telemetry.hpp"
+#include "okapi/api/util/cobs.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace okapi {
+namespace {
+// The bytes of a sample packet other than its signals, and of each signal in it
+constexpr std::size_t sampleHeaderSize = 1 + 4 + 1;
+constexpr std::size_t sampleEntrySize = 1 + 4;
+
+constexpr std::size_t crcSize = 2;
+
+template <typename T> void put(std::vector<std::uint8_t> &opacket, const T &ivalue) {
+  const auto *bytes = reinterpret_cast<const std::uint8_t *>(&ivalue);
+  opacket.insert(opacket.end(), bytes, bytes + sizeof(T));
+}
+} // namespace
+
+Telemetry::Telemetry(const TimeUtil &itimeUtil,
+                     std::unique_ptr<TelemetryOutput> ioutput,
+                     const std::uint32_t ibytesPerSecond,
+                     const QTime iperiod,
+                     std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    timeUtil(itimeUtil),
+    timer(itimeUtil.getTimer()),
+    output(std::move(ioutput)),
+    bytesPerSecond(ibytesPerSecond),
+    period(iperiod) {
+  if (period <= 0_ms) {
+    std::string msg = "Telemetry: The period must be greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (bytesPerSecond == 0) {
+    std::string msg = "Telemetry: The bandwidth budget must be greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+Telemetry::~Telemetry() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+std::uint8_t Telemetry::addSignal(const std::string &iname, const std::uint16_t idecimation) {
+  if (idecimation == 0) {
+    std::string msg = "Telemetry: The decimation must be at least 1.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (iname.size() > 255) {
+    std::string msg = "Telemetry: Signal names must be at most 255 characters.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  std::lock_guard<CrossplatformMutex> lock(mutex);
+  if (signals.size() == maxSignals) {
+    std::string msg = "Telemetry: Can not add more than " + std::to_string(maxSignals) +
+                      " signals.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  signals.push_back({iname, idecimation});
+  values[signals.size() - 1].store(0, std::memory_order_relaxed);
+  signalCount.store(signals.size(), std::memory_order_release);
+
+  // Resend the list so the decoder learns about the new signal
+  schemaSent = false;
+
+  double bytesPerTick = static_cast<double>(frameSize(sampleHeaderSize));
+  for (const auto &signal : signals) {
+    bytesPerTick += static_cast<double>(sampleEntrySize) / signal.decimation;
+  }
+  const double needed = bytesPerTick / period.convert(second);
+  if (needed > bytesPerSecond) {
+    LOG_WARN("Telemetry: The signals need about " + std::to_string(static_cast<int>(needed)) +
+             " bytes/s but the budget is " + std::to_string(bytesPerSecond) +
+             " bytes/s, so some samples will be dropped");
+  }
+
+  return static_cast<std::uint8_t>(signals.size() - 1);
+}
+
+void Telemetry::set(const std::uint8_t isignal, const double ivalue) noexcept {
+  if (isignal < signalCount.load(std::memory_order_acquire)) {
+    values[isignal].store(static_cast<float>(ivalue), std::memory_order_relaxed);
+  }
+}
+
+void Telemetry::tick() {
+  std::lock_guard<CrossplatformMutex> lock(mutex);
+  const QTime now = timer->millis();
+
+  if (!schemaSent || now - lastSchema >= 1_s) {
+    sendSchema();
+    lastSchema = now;
+    schemaSent = true;
+  }
+
+  packet.clear();
+  packet.push_back('S');
+  // Rounded, since a time in whole milliseconds can come out just under it in floating point
+  put(packet, static_cast<std::uint32_t>(std::llround(now.convert(millisecond) * 1000)));
+  packet.push_back(0);
+  std::uint8_t count = 0;
+  for (std::size_t i = 0; i < signals.size(); i++) {
+    if (tickCount % signals[i].decimation == 0) {
+      packet.push_back(static_cast<std::uint8_t>(i));
+      put(packet, values[i].load(std::memory_order_relaxed));
+      count++;
+    }
+  }
+  packet[sampleHeaderSize - 1] = count;
+
+  // Refill the budget for the time since the last tick, keeping at most about 100 ms of it
+  const std::size_t size = frameSize(packet.size());
+  const double elapsed =
+    tickCount == 0 ? period.convert(second) : (now - lastTick).convert(second);
+  budget = std::min(budget + bytesPerSecond * elapsed, bytesPerSecond * 0.1 + size);
+  lastTick = now;
+  tickCount++;
+
+  if (count == 0) {
+    return;
+  }
+
+  if (budget >= size) {
+    budget -= size;
+    send();
+  } else {
+    stats.packetsDropped++;
+  }
+}
+
+void Telemetry::sendSchema() {
+  for (std::size_t i = 0; i < signals.size(); i++) {
+    packet.clear();
+    packet.push_back('N');
+    packet.push_back(static_cast<std::uint8_t>(i));
+    put(packet, signals[i].decimation);
+    packet.push_back(static_cast<std::uint8_t>(signals[i].name.size()));
+    packet.insert(packet.end(), signals[i].name.begin(), signals[i].name.end());
+
+    // The decoder needs this, so it is sent even if it takes the budget below zero
+    budget -= frameSize(packet.size());
+    send();
+  }
+}
+
+std::size_t Telemetry::frameSize(const std::size_t isize) {
+  return cobs::maxEncodedSize(isize + crcSize) + 2;
+}
+
+void Telemetry::send() {
+  put(packet, cobs::crc16(packet.data(), packet.size()));
+
+  // A zero before the frame as well as after it ends whatever else was written to the link before
+  frame.resize(frameSize(packet.size() - crcSize));
+  frame[0] = 0;
+  const std::size_t size = cobs::encode(packet.data(), packet.size(), frame.data() + 1) + 2;
+  frame[size - 1] = 0;
+
+  if (output) {
+    output->write(frame.data(), size);
+  }
+  stats.packetsSent++;
+  stats.bytesSent += size;
+}
+
+Telemetry::Stats Telemetry::getStats() const {
+  std::lock_guard<CrossplatformMutex> lock(mutex);
+  return stats;
+}
+
+void Telemetry::startThread() {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "Telemetry");
+#ifndef THREADS_STD
+    pros::c::task_set_priority(task->thread, TASK_PRIORITY_MIN + 1);
+#endif
+  }
+}
+
+CrossplatformThread *Telemetry::getThread() const {
+  return task;
+}
+
+void Telemetry::trampoline(void *context) {
+  if (context) {
+    static_cast<Telemetry *>(context)->loop();
+  }
+}
+
+void Telemetry::loop() {
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    tick();
+    rate->delayUntil(period);
+  }
+}
+} // namespace okapi
@@ -0,0 +1,26 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/telemetryOutput.hpp"
+
+namespace okapi {
+TelemetryOutput::~TelemetryOutput() = default;
+
+FileTelemetryOutput::FileTelemetryOutput(FILE *ifile) : file(ifile) {
+}
+
+FileTelemetryOutput::~FileTelemetryOutput() {
+  if (file) {
+    fclose(file);
+  }
+}
+
+void FileTelemetryOutput::write(const std::uint8_t *idata, const std::size_t isize) {
+  if (file) {
+    fwrite(idata, 1, isize, file);
+    fflush(file);
+  }
+}
+} // namespace okapi
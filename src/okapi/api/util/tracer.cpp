@@ -0,0 +1,376 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/tracer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace okapi {
+namespace {
+std::shared_ptr<Tracer> defaultTracerOwner;
+std::atomic<Tracer *> defaultTracer{nullptr};
+
+/**
+ * @return A key unique to the calling task.
+ */
+const void *currentTaskKey() noexcept {
+#ifdef THREADS_STD
+  static thread_local const char key = 0;
+  return &key;
+#else
+  return pros::c::task_get_current();
+#endif
+}
+
+/**
+ * Writes each value's bytes in turn. Both the brain and hosts are little endian.
+ */
+template <typename... Ts> void putBytes(FILE *ifile, const Ts &... ivalues) {
+  (fwrite(&ivalues, sizeof(ivalues), 1, ifile), ...);
+}
+
+std::uint32_t roundUpToPowerOfTwo(const std::size_t ivalue) {
+  std::uint32_t out = 1;
+  while (out < ivalue && out < 1u << 16) {
+    out <<= 1;
+  }
+  return out;
+}
+
+/**
+ * @return itime with the wraps of the 32 bit clock up to ilast, a task's previous event, added
+ * back. A task's events are in order, so a time behind ilast means the clock wrapped.
+ */
+std::uint64_t unwrap(const std::uint64_t ilast, const std::uint32_t itime) {
+  const std::uint64_t out = (ilast & ~0xffffffffull) | itime;
+  return out < ilast ? out + (1ull << 32) : out;
+}
+} // namespace
+
+Tracer::Tracer(std::unique_ptr<AbstractTimer> itimer,
+               std::unique_ptr<AbstractRate> irate,
+               FILE *ifile,
+               const std::size_t iringCapacity,
+               const QTime idrainPeriod,
+               const Mode imode)
+  : timer(std::move(itimer)),
+    rate(std::move(irate)),
+    file(ifile),
+    capacity(roundUpToPowerOfTwo(iringCapacity)),
+    drainPeriod(idrainPeriod),
+    mode(imode) {
+  if (iringCapacity == 0 || iringCapacity > 1u << 16) {
+    throw std::invalid_argument("Tracer: The ring capacity must be between 1 and 65536 events.");
+  }
+
+  if (drainPeriod <= 0_ms) {
+    throw std::invalid_argument("Tracer: The drain period must be greater than zero.");
+  }
+
+  if (file) {
+    if (mode == Mode::binary) {
+      fwrite(binaryMagic, 1, sizeof(binaryMagic) - 1, file);
+      fwrite(&binaryVersion, 1, 1, file);
+    } else {
+      // Viewers accept the array without its closing bracket, so a cut off file still loads
+      fprintf(file, "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+                    "\"args\":{\"name\":\"V5 Brain\"}}");
+    }
+  }
+}
+
+Tracer::~Tracer() {
+  dtorCalled.store(true, std::memory_order_release);
+#ifdef THREADS_STD
+  delete task;
+#else
+  // Deleting the task in the middle of a drain would leave the mutex taken
+  drainMutex.lock();
+  delete task;
+  drainMutex.unlock();
+#endif
+
+  drain();
+  if (file) {
+    if (mode == Mode::json) {
+      fprintf(file, "\n]\n");
+    }
+    fclose(file);
+  }
+}
+
+std::uint16_t Tracer::intern(const char *iname) {
+  return LogFormat::intern(iname, "");
+}
+
+Tracer::Ring *Tracer::findRing() noexcept {
+  const void *key = currentTaskKey();
+  for (auto &ring : rings) {
+    const void *owner = ring.owner.load(std::memory_order_acquire);
+    if (owner == key) {
+      return &ring;
+    }
+
+    if (owner == nullptr) {
+      // Rings are claimed in order, so the first free one means this task has none yet
+      const void *expected = nullptr;
+      if (ring.owner.compare_exchange_strong(expected, key, std::memory_order_acq_rel)) {
+        ring.events.reset(new (std::nothrow) TraceEvent[capacity]);
+        if (!ring.events) {
+          return nullptr;
+        }
+
+#ifdef THREADS_STD
+        std::snprintf(ring.name, sizeof(ring.name), "%s", CrossplatformThread::getName().c_str());
+#else
+        std::snprintf(ring.name, sizeof(ring.name), "%s", pros::c::task_get_name(nullptr));
+#endif
+        ring.ready.store(true, std::memory_order_release);
+        return &ring;
+      }
+
+      if (expected == key) {
+        return &ring;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+std::uint32_t Tracer::now() const {
+  return static_cast<std::uint32_t>(
+    static_cast<std::uint64_t>(timer->millis().convert(millisecond) * 1000));
+}
+
+bool Tracer::record(const Phase iphase, const std::uint16_t iname) noexcept {
+  if (iname == 0) {
+    return false;
+  }
+
+  Ring *ring = findRing();
+  if (!ring || !ring->ready.load(std::memory_order_acquire)) {
+    unownedDropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // A begin also reserves the slot for its end, so a span is either recorded whole or dropped
+  // whole. An end uses the slot its begin reserved, so it always fits.
+  const std::uint32_t head = ring->head.load(std::memory_order_relaxed);
+  const std::uint32_t tail = ring->tail.load(std::memory_order_acquire);
+  if (iphase == Phase::end) {
+    if (ring->openSpans == 0) {
+      ring->dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    ring->openSpans--;
+  } else {
+    const std::uint32_t needed = iphase == Phase::begin ? 2 : 1;
+    if (capacity - (head - tail) < ring->openSpans + needed) {
+      ring->dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    if (iphase == Phase::begin) {
+      ring->openSpans++;
+    }
+  }
+
+  auto &event = ring->events[head & (capacity - 1)];
+  event.time = now();
+  event.name = iname;
+  event.phase = static_cast<char>(iphase);
+  event.reserved = 0;
+  ring->head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+void Tracer::drain() {
+  std::lock_guard<CrossplatformMutex> lock(drainMutex);
+  if (!file) {
+    return;
+  }
+
+  for (std::size_t i = 0; i < rings.size(); i++) {
+    auto &ring = rings[i];
+    if (!ring.ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+
+    std::uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    const std::uint32_t head = ring.head.load(std::memory_order_acquire);
+    while (tail != head) {
+      const TraceEvent event = ring.events[tail & (capacity - 1)];
+      ring.tail.store(++tail, std::memory_order_release);
+      writeEvent(i, event);
+    }
+
+    const std::uint32_t dropped = ring.dropped.load(std::memory_order_relaxed);
+    if (dropped != ring.reportedDropped) {
+      writeDropped(i, ring.name, dropped - ring.reportedDropped);
+      ring.reportedDropped = dropped;
+    }
+  }
+
+  const std::uint32_t unowned = unownedDropped.load(std::memory_order_relaxed);
+  if (unowned != reportedUnownedDropped) {
+    writeDropped(unownedTask, "no ring", unowned - reportedUnownedDropped);
+    reportedUnownedDropped = unowned;
+  }
+
+  fflush(file);
+}
+
+void Tracer::writeEvent(const std::size_t iring, const TraceEvent &ievent) {
+  auto &ring = rings[iring];
+  const auto *entry = LogFormat::find(ievent.name);
+  if (!entry) {
+    return;
+  }
+
+  if (mode == Mode::binary) {
+    if (!ring.nameWritten) {
+      const auto length = static_cast<std::uint8_t>(std::strlen(ring.name));
+      putBytes(file, Frame::task, static_cast<std::uint8_t>(iring), length);
+      fwrite(ring.name, 1, length, file);
+      ring.nameWritten = true;
+    }
+
+    if (!namesWritten[ievent.name]) {
+      const auto length =
+        static_cast<std::uint8_t>(std::min<std::size_t>(std::strlen(entry->format), 255));
+      putBytes(file, Frame::name, ievent.name, length);
+      fwrite(entry->format, 1, length, file);
+      namesWritten[ievent.name] = true;
+    }
+
+    putBytes(file,
+             Frame::event,
+             static_cast<std::uint8_t>(iring),
+             ievent.time,
+             ievent.phase,
+             ievent.name);
+    return;
+  }
+
+  if (!ring.nameWritten) {
+    fprintf(file,
+            ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+            static_cast<unsigned>(iring + 1));
+    writeJsonString(ring.name);
+    fprintf(file, "}}");
+    ring.nameWritten = true;
+  }
+
+  ring.lastTime = unwrap(ring.lastTime, ievent.time);
+  fprintf(file, ",\n{\"name\":");
+  writeJsonString(entry->format);
+  fprintf(file,
+          ",\"ph\":\"%c\",%s\"ts\":%llu,\"pid\":1,\"tid\":%u}",
+          ievent.phase,
+          ievent.phase == static_cast<char>(Phase::instant) ? "\"s\":\"t\"," : "",
+          static_cast<unsigned long long>(ring.lastTime),
+          static_cast<unsigned>(iring + 1));
+}
+
+void Tracer::writeDropped(const std::size_t iring,
+                          const char *itaskName,
+                          const std::uint32_t icount) {
+  const std::uint32_t time = now();
+  if (mode == Mode::binary) {
+    putBytes(file, Frame::dropped, static_cast<std::uint8_t>(iring), time, icount);
+    return;
+  }
+
+  // Shown as an instant event on the task's track, or on the process if the task had no ring
+  const bool owned = iring != unownedTask;
+  std::uint64_t ts = time;
+  if (owned) {
+    rings[iring].lastTime = unwrap(rings[iring].lastTime, time);
+    ts = rings[iring].lastTime;
+  }
+  fprintf(file,
+          ",\n{\"name\":\"Dropped %lu events (%s)\",\"ph\":\"i\",\"s\":\"%c\",\"ts\":%llu,"
+          "\"pid\":1,\"tid\":%u}",
+          static_cast<unsigned long>(icount),
+          itaskName,
+          owned ? 't' : 'p',
+          static_cast<unsigned long long>(ts),
+          owned ? static_cast<unsigned>(iring + 1) : 0u);
+}
+
+void Tracer::writeJsonString(const char *itext) {
+  fputc('"', file);
+  for (const char *c = itext; *c; c++) {
+    if (*c == '"' || *c == '\\') {
+      fputc('\\', file);
+      fputc(*c, file);
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      fprintf(file, "\\u%04x", static_cast<unsigned>(*c));
+    } else {
+      fputc(*c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+std::uint32_t Tracer::getDropped() const {
+  std::uint32_t dropped = unownedDropped.load(std::memory_order_relaxed);
+  for (const auto &ring : rings) {
+    dropped += ring.dropped.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+void Tracer::startThread() {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "Tracer");
+#ifndef THREADS_STD
+    pros::c::task_set_priority(task->thread, TASK_PRIORITY_MIN + 1);
+#endif
+  }
+}
+
+CrossplatformThread *Tracer::getThread() const {
+  return task;
+}
+
+Tracer *Tracer::getDefault() noexcept {
+  return defaultTracer.load(std::memory_order_acquire);
+}
+
+void Tracer::setDefault(std::shared_ptr<Tracer> itracer) {
+  defaultTracer.store(itracer.get(), std::memory_order_release);
+  defaultTracerOwner = std::move(itracer);
+}
+
+void Tracer::trampoline(void *context) {
+  if (context) {
+    static_cast<Tracer *>(context)->loop();
+  }
+}
+
+void Tracer::loop() {
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    drain();
+    rate->delayUntil(drainPeriod);
+  }
+}
+
+TraceSpan::TraceSpan(const std::uint16_t iname) noexcept
+  : tracer(Tracer::getDefault()), name(iname) {
+  if (tracer && !tracer->record(Tracer::Phase::begin, name)) {
+    name = 0;
+  }
+}
+
+TraceSpan::~TraceSpan() {
+  if (tracer && name != 0) {
+    tracer->record(Tracer::Phase::end, name);
+  }
+}
+} // namespace okapi
@@ -0,0 +1,220 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/virtualClock.hpp"
+#include "okapi/api/control/util/settledUtil.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifdef THREADS_STD
+#include <future>
+#endif
+
+namespace okapi {
+#ifdef THREADS_STD
+/**
+ * Remembers which clocks the current thread participates in, so it can detach from them when the
+ * thread exits.
+ */
+struct VirtualClockParticipation {
+  std::vector<VirtualClock *> clocks;
+
+  ~VirtualClockParticipation() {
+    for (auto clock : clocks) {
+      clock->detach(std::this_thread::get_id());
+    }
+  }
+};
+
+namespace {
+thread_local VirtualClockParticipation participation;
+} // namespace
+#endif
+
+VirtualClock::VirtualClock(const QTime istart) : time(istart.convert(second)) {
+#ifdef THREADS_STD
+  participation.clocks.push_back(this);
+  numParticipants = 1;
+#endif
+}
+
+VirtualClock::~VirtualClock() {
+#ifdef THREADS_STD
+  auto &clocks = participation.clocks;
+  clocks.erase(std::remove(clocks.begin(), clocks.end(), this), clocks.end());
+#endif
+}
+
+QTime VirtualClock::now() const {
+  return time.load(std::memory_order_acquire) * second;
+}
+
+void VirtualClock::advance(const QTime idt) {
+  time.store(time.load(std::memory_order_relaxed) + idt.convert(second),
+             std::memory_order_release);
+}
+
+void VirtualClock::runFor(const QTime iduration) {
+  sleepUntil(now() + iduration);
+}
+
+#ifdef THREADS_STD
+void VirtualClock::sleepUntil(const QTime iwakeTime) {
+  const auto id = std::this_thread::get_id();
+  std::unique_lock<std::mutex> lock(mutex);
+  attachLocked();
+
+  // Rounded to the microsecond, so wake times which add up to the same time from different
+  // periods, such as ten 10 ms delays and one 100 ms one, tie instead of being a rounding error
+  // apart
+  const double wakeTime = std::max(std::round(iwakeTime.convert(second) * 1e6) / 1e6,
+                                   time.load(std::memory_order_relaxed));
+  sleepers.push_back({wakeTime, nextOrder++, id});
+  dispatch();
+
+  condition.wait(lock, [&] { return resumed == id; });
+  resumed = std::thread::id();
+}
+
+void VirtualClock::attach() {
+  std::lock_guard<std::mutex> lock(mutex);
+  attachLocked();
+}
+
+void VirtualClock::attachLocked() {
+  auto &clocks = participation.clocks;
+  if (std::find(clocks.begin(), clocks.end(), this) == clocks.end()) {
+    clocks.push_back(this);
+    if (numExpected > 0) {
+      // Already counted by expectThreads()
+      numExpected--;
+    } else {
+      numParticipants++;
+    }
+  }
+}
+
+void VirtualClock::expectThreads(const std::size_t icount) {
+  std::lock_guard<std::mutex> lock(mutex);
+  attachLocked();
+  numExpected += icount;
+  numParticipants += icount;
+}
+
+std::thread VirtualClock::startThread(std::function<void()> ifunction) {
+  // The creator must already be a participant, or the new thread could run ahead of it
+  attach();
+
+  std::promise<void> attached;
+  std::thread thread([this, &attached, function = std::move(ifunction)]() {
+    attach();
+    attached.set_value();
+
+    // The creator keeps running until it waits, so wait to be scheduled before starting
+    sleepUntil(now());
+    function();
+  });
+  attached.get_future().wait();
+
+  return thread;
+}
+
+void VirtualClock::detachCurrentThread() {
+  auto &clocks = participation.clocks;
+  const auto it = std::find(clocks.begin(), clocks.end(), this);
+  if (it != clocks.end()) {
+    clocks.erase(it);
+    detach(std::this_thread::get_id());
+  }
+}
+
+void VirtualClock::detach(const std::thread::id iid) {
+  std::lock_guard<std::mutex> lock(mutex);
+  sleepers.erase(std::remove_if(sleepers.begin(),
+                                sleepers.end(),
+                                [&](const Sleeper &sleeper) { return sleeper.id == iid; }),
+                 sleepers.end());
+  numParticipants--;
+  dispatch();
+}
+
+void VirtualClock::dispatch() {
+  // Wait for the running participant to sleep, and for the last one resumed to wake up
+  if (sleepers.empty() || sleepers.size() < numParticipants || resumed != std::thread::id()) {
+    return;
+  }
+
+  const auto next =
+    std::min_element(sleepers.begin(), sleepers.end(), [](const Sleeper &a, const Sleeper &b) {
+      return a.wakeTime < b.wakeTime || (a.wakeTime == b.wakeTime && a.order < b.order);
+    });
+
+  time.store(std::max(next->wakeTime, time.load(std::memory_order_relaxed)),
+             std::memory_order_release);
+  resumed = next->id;
+  sleepers.erase(next);
+  condition.notify_all();
+}
+#else
+void VirtualClock::sleepUntil(const QTime iwakeTime) {
+  if (iwakeTime > now()) {
+    time.store(iwakeTime.convert(second), std::memory_order_release);
+  }
+}
+
+void VirtualClock::attach() {
+}
+
+void VirtualClock::expectThreads(std::size_t) {
+}
+
+void VirtualClock::detachCurrentThread() {
+}
+#endif
+
+std::unique_ptr<AbstractTimer> VirtualClock::createTimer() {
+  return std::make_unique<VirtualTimer>(*this);
+}
+
+std::unique_ptr<AbstractRate> VirtualClock::createRate() {
+  return std::make_unique<VirtualRate>(*this);
+}
+
+TimeUtil VirtualClock::createTimeUtil(const double iatTargetError,
+                                      const double iatTargetDerivative,
+                                      const QTime iatTargetTime) {
+  return TimeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>([this]() { return createTimer(); }),
+    Supplier<std::unique_ptr<AbstractRate>>([this]() { return createRate(); }),
+    Supplier<std::unique_ptr<SettledUtil>>([=]() {
+      return std::make_unique<SettledUtil>(
+        createTimer(), iatTargetError, iatTargetDerivative, iatTargetTime);
+    }));
+}
+
+VirtualTimer::VirtualTimer(const VirtualClock &iclock)
+  : AbstractTimer(iclock.now()), clock(iclock) {
+}
+
+QTime VirtualTimer::millis() const {
+  return clock.now();
+}
+
+VirtualRate::VirtualRate(VirtualClock &iclock) : clock(iclock), lastTime(iclock.now()) {
+}
+
+void VirtualRate::delay(const QFrequency ihz) {
+  delayUntil(QTime(1.0 / ihz.convert(Hz)));
+}
+
+void VirtualRate::delayUntil(const QTime itime) {
+  lastTime += itime;
+  clock.sleepUntil(lastTime);
+}
+
+void VirtualRate::delayUntil(const uint32_t ims) {
+  delayUntil(ims * millisecond);
+}
+} // namespace okapi
@@ -0,0 +1,97 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/gpsImuHeading.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include <cmath>
+
+namespace okapi {
+GpsImuHeading::GpsImuHeading(const pros::Gps &igps,
+                             const pros::Imu &iimu,
+                             const QTime itimeConstant,
+                             const double imaxGpsError,
+                             const TimeUtil &itimeUtil,
+                             std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    gps(igps),
+    imu(iimu),
+    timeUtil(itimeUtil),
+    fusion(itimeConstant, imaxGpsError) {
+}
+
+GpsImuHeading::~GpsImuHeading() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+QAngle GpsImuHeading::getHeading() const {
+  return headingDeg.load(std::memory_order_acquire) * degree;
+}
+
+QAngle GpsImuHeading::getWrappedHeading() const {
+  return OdomMath::constrainAngle180(getHeading());
+}
+
+QAngularSpeed GpsImuHeading::getRate() const {
+  return rateDegPerSec.load(std::memory_order_acquire) * degree / second;
+}
+
+bool GpsImuHeading::isGpsValid() const {
+  return gpsValid.load(std::memory_order_acquire);
+}
+
+void GpsImuHeading::setSampleTime(const QTime isampleTime) {
+  sampleTimeMs.store(isampleTime.convert(millisecond), std::memory_order_release);
+}
+
+void GpsImuHeading::startThread() {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "GpsImuHeading");
+  }
+}
+
+CrossplatformThread *GpsImuHeading::getThread() const {
+  return task;
+}
+
+void GpsImuHeading::trampoline(void *context) {
+  if (context) {
+    static_cast<GpsImuHeading *>(context)->loop();
+  }
+}
+
+void GpsImuHeading::loop() {
+  LOG_INFO_S("GpsImuHeading: Started fusion task");
+
+  auto rate = timeUtil.getRate();
+  auto timer = timeUtil.getTimer();
+  bool lastGpsValid = false;
+
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    // The IMU reports PROS_ERR_F while calibrating, which HeadingFusion skips over
+    const QAngle imuRotation = imu.get_rotation() * degree;
+    const double gyroRate = imu.get_gyro_rate().z;
+    const pros::c::gps_status_s_t gpsStatus = gps.get_status();
+    const double gpsError = gps.get_error();
+
+    fusion.step(imuRotation, gpsStatus.yaw * degree, gpsError, timer->getDt());
+
+    headingDeg.store(fusion.getHeading().convert(degree), std::memory_order_release);
+    if (std::isfinite(gyroRate)) {
+      rateDegPerSec.store(gyroRate, std::memory_order_release);
+    }
+
+    const bool currentGpsValid = fusion.isAbsoluteValid();
+    gpsValid.store(currentGpsValid, std::memory_order_release);
+    if (currentGpsValid != lastGpsValid) {
+      LOG_INFO(std::string("GpsImuHeading: GPS heading ") +
+               (currentGpsValid ? "recovered" : "lost, following the IMU"));
+      lastGpsValid = currentGpsValid;
+    }
+
+    rate->delayUntil(sampleTimeMs.load(std::memory_order_acquire) * millisecond);
+  }
+}
+} // namespace okapi
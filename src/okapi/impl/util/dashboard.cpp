@@ -0,0 +1,127 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/util/dashboard.hpp"
+#include "api.h"
+#include <mutex>
+
+namespace okapi {
+Dashboard::Dashboard(const TimeUtil &itimeUtil,
+                     const QTime iperiod,
+                     const std::int16_t ifirstLine,
+                     std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)), timeUtil(itimeUtil), period(iperiod), firstLine(ifirstLine) {
+  if (period <= 0_ms) {
+    std::string msg = "Dashboard: The period must be greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+Dashboard::~Dashboard() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+std::size_t Dashboard::addField(const std::string &ilabel, const std::string &iformat) {
+  return add(ilabel, iformat, nullptr);
+}
+
+std::size_t Dashboard::addTextField(const std::string &ilabel,
+                                    std::function<std::string()> itext) {
+  return add(ilabel, "", std::move(itext));
+}
+
+std::size_t Dashboard::add(const std::string &ilabel,
+                           const std::string &iformat,
+                           std::function<std::string()> itext) {
+  std::lock_guard<CrossplatformMutex> lock(mutex);
+  const std::size_t id = fieldCount.load(std::memory_order_relaxed);
+  if (id == maxFields) {
+    std::string msg =
+      "Dashboard: Can not add more than " + std::to_string(maxFields) + " fields.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  auto &field = fields[id];
+  field.label = ilabel;
+  field.format = iformat;
+  field.text = std::move(itext);
+  field.dirty.store(true, std::memory_order_relaxed);
+  fieldCount.store(id + 1, std::memory_order_release);
+  return id;
+}
+
+void Dashboard::set(const std::size_t ifield, const double ivalue) noexcept {
+  if (ifield < fieldCount.load(std::memory_order_acquire)) {
+    auto &field = fields[ifield];
+    if (field.value.exchange(ivalue, std::memory_order_relaxed) != ivalue) {
+      field.dirty.store(true, std::memory_order_release);
+    }
+  }
+}
+
+void Dashboard::render() {
+  std::lock_guard<CrossplatformMutex> lock(mutex);
+  const std::size_t count = fieldCount.load(std::memory_order_acquire);
+  for (std::size_t i = 0; i < count; i++) {
+    auto &field = fields[i];
+    if (field.text) {
+      line = field.label + ": " + field.text();
+    } else if (field.dirty.exchange(false, std::memory_order_acquire)) {
+      char value[32];
+      snprintf(value,
+               sizeof(value),
+               field.format.c_str(),
+               field.value.load(std::memory_order_relaxed));
+      line = field.label + ": " + value;
+    } else {
+      continue;
+    }
+
+    // Changes too small to show are not drawn either
+    if (line == field.drawn) {
+      continue;
+    }
+
+    // Text is drawn over what was there, so pad with spaces to cover a longer old line
+    const std::size_t length = line.size();
+    if (line.size() < field.drawn.size()) {
+      line.append(field.drawn.size() - line.size(), ' ');
+    }
+    pros::screen::print(
+      pros::E_TEXT_MEDIUM, firstLine + static_cast<std::int16_t>(i), "%s", line.c_str());
+    field.drawn.assign(line, 0, length);
+  }
+}
+
+void Dashboard::startThread() {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "Dashboard");
+#ifndef THREADS_STD
+    pros::c::task_set_priority(task->thread, TASK_PRIORITY_MIN + 1);
+#endif
+  }
+}
+
+CrossplatformThread *Dashboard::getThread() const {
+  return task;
+}
+
+void Dashboard::trampoline(void *context) {
+  if (context) {
+    static_cast<Dashboard *>(context)->loop();
+  }
+}
+
+void Dashboard::loop() {
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    render();
+    rate->delayUntil(period);
+  }
+}
+} // namespace okapi
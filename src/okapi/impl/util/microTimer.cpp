@@ -0,0 +1,16 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/util/microTimer.hpp"
+#include "api.h"
+
+namespace okapi {
+MicroTimer::MicroTimer() : AbstractTimer(millis()) {
+}
+
+QTime MicroTimer::millis() const {
+  return static_cast<double>(pros::c::micros()) / 1000.0 * millisecond;
+}
+} // namespace okapi
@@ -0,0 +1,23 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/util/serialTelemetryOutput.hpp"
+
+namespace okapi {
+SerialTelemetryOutput::SerialTelemetryOutput(const std::uint8_t iport,
+                                             const std::int32_t ibaudrate)
+  : serial(iport, ibaudrate) {
+}
+
+void SerialTelemetryOutput::write(const std::uint8_t *idata, const std::size_t isize) {
+  // The port only buffers so much, so a frame which does not fit is left out rather than waited
+  // for. The decoder resynchronizes on the next frame.
+  if (serial.get_write_free() < static_cast<std::int32_t>(isize)) {
+    return;
+  }
+
+  serial.write(const_cast<std::uint8_t *>(idata), static_cast<std::int32_t>(isize));
+}
+} // namespace okapi